@@ -0,0 +1,145 @@
+// AnalysisEngine.cpp
+#include "AnalysisEngine.h"
+#include "FastRng.h"
+#include "LatencyTracer.h"
+#include <chrono>
+#include <vector>
+
+namespace {
+
+const int ITERATIONS_PER_BATCH = 64;
+const int MAX_ITERATIONS = 200000; // 单个局面搜到这么多次后停下等待新局面
+
+} // namespace
+
+AnalysisEngine::AnalysisEngine()
+    : m_pendingKomi(6.5)
+    , m_hasPosition(false)
+    , m_positionVersion(0)
+    , m_paused(true)
+    , m_quit(false)
+    , m_publishIntervalMs(100)
+    , m_middle(1)
+    , m_back(0)
+    , m_front(2)
+{
+    m_thread = std::thread(&AnalysisEngine::run, this);
+}
+
+AnalysisEngine::~AnalysisEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit.store(true);
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void AnalysisEngine::setPosition(const GoBoard& board, double komi)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // 撤销记录一起拷过来，搜索线程据此判断新局面是不是在旧局面之后，好保留搜索树
+        m_pending = board;
+        m_pendingKomi = komi;
+        m_hasPosition = true;
+        m_positionVersion.fetch_add(1, std::memory_order_release);
+    }
+    m_wake.notify_all();
+}
+
+void AnalysisEngine::setPaused(bool paused)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused.store(paused);
+    }
+    m_wake.notify_all();
+}
+
+bool AnalysisEngine::latest(AnalysisSnapshot& out, uint64_t sinceSequence)
+{
+    if (m_middle.load(std::memory_order_acquire) & FRESH) {
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & ~FRESH;
+    }
+    const AnalysisSnapshot& snapshot = m_buffers[m_front];
+    if (snapshot.sequence <= sinceSequence) return false;
+    out = snapshot;
+    return true;
+}
+
+void AnalysisEngine::publish(const GoMcts& mcts, uint64_t sequence)
+{
+    LATENCY_TRACE("AnalysisEngine::publish", "analysis");
+    const GoBoard& board = mcts.position();
+    AnalysisSnapshot& snapshot = m_buffers[m_back];
+    snapshot.sequence = sequence;
+    snapshot.positionKey = board.positionKey();
+    snapshot.boardSize = board.size();
+    snapshot.iterations = mcts.iterations();
+    snapshot.winRate = mcts.rootWinRate();
+
+    std::vector<GoMcts::Candidate> candidates;
+    mcts.candidates(candidates, AnalysisSnapshot::MAX_CANDIDATES);
+    snapshot.candidateCount = 0;
+    for (const auto& candidate : candidates) {
+        if (candidate.move == GoBoard::PASS_MOVE) continue;
+        AnalysisSnapshot::Candidate& out = snapshot.candidates[snapshot.candidateCount++];
+        out.row = board.rowOf(candidate.move);
+        out.col = board.colOf(candidate.move);
+        out.visits = candidate.visits;
+        out.winRate = candidate.winRate;
+    }
+    for (int row = 0; row < board.size(); ++row) {
+        for (int col = 0; col < board.size(); ++col) {
+            snapshot.ownership[row * board.size() + col] = mcts.ownership(board.point(row, col));
+        }
+    }
+
+    // 写好的后缓冲与中间缓冲交换，并标记为未读
+    m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+void AnalysisEngine::run()
+{
+    GoMcts mcts;
+    FastRng& rng = FastRng::threadLocal();
+    uint64_t searchedVersion = 0;
+    double searchedKomi = -1.0; // 还没有搜过
+    uint64_t sequence = 0;
+    auto lastPublish = std::chrono::steady_clock::now();
+
+    while (true) {
+        // 暂停、没有局面或本局面已搜满时睡眠，不占CPU；持锁只为取走新局面
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] {
+                return m_quit.load() || (!m_paused.load() && m_hasPosition &&
+                                         (m_positionVersion.load() != searchedVersion ||
+                                          mcts.iterations() < MAX_ITERATIONS));
+            });
+            if (m_quit.load()) return;
+            if (m_positionVersion.load() != searchedVersion) {
+                searchedVersion = m_positionVersion.load();
+                if (m_pendingKomi != searchedKomi) {
+                    searchedKomi = m_pendingKomi;
+                    mcts.setKomi(m_pendingKomi);
+                    mcts.setPosition(m_pending);
+                } else {
+                    // 界面上下了一两手时接着用已有的搜索
+                    mcts.reusePosition(m_pending);
+                }
+            }
+        }
+
+        mcts.search(ITERATIONS_PER_BATCH, rng);
+
+        auto now = std::chrono::steady_clock::now();
+        int interval = m_publishIntervalMs.load(std::memory_order_relaxed);
+        if (now - lastPublish >= std::chrono::milliseconds(interval) || mcts.iterations() >= MAX_ITERATIONS) {
+            publish(mcts, ++sequence);
+            lastPublish = now;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "GoBoard.h"
+#include "GoMcts.h"
+
+// 搜索结果快照，纯数据，整块拷贝
+struct AnalysisSnapshot {
+    static const int MAX_CANDIDATES = 8;
+
+    struct Candidate {
+        int row;
+        int col;
+        int visits;
+        float winRate; // 轮到的一方下在此点的胜率
+    };
+
+    uint64_t sequence = 0;    // 每次发布加一，0表示还没有结果
+    uint64_t positionKey = 0; // 对应局面的GoBoard::positionKey
+    int boardSize = 0;
+    int iterations = 0;
+    float winRate = 0.5f;     // 轮到的一方的胜率
+    int candidateCount = 0;
+    Candidate candidates[MAX_CANDIDATES];
+    float ownership[GoBoard::MAX_SIZE * GoBoard::MAX_SIZE] = {}; // 按行排列，黑为正
+};
+
+// 后台分析线程：对设定的局面持续做蒙特卡洛搜索，节流发布快照
+// 快照用三缓冲交换，读取方（界面线程，只能有一个）不加锁、不会等待搜索线程
+class AnalysisEngine {
+public:
+    AnalysisEngine();
+    ~AnalysisEngine();
+    AnalysisEngine(const AnalysisEngine&) = delete;
+    AnalysisEngine& operator=(const AnalysisEngine&) = delete;
+
+    // 换局面只在短暂持锁时拷贝棋盘，搜索线程在下一批迭代前取走
+    void setPosition(const GoBoard& board, double komi);
+    void setPaused(bool paused);
+    bool isPaused() const { return m_paused.load(std::memory_order_relaxed); }
+    void setPublishIntervalMs(int ms) { m_publishIntervalMs.store(ms, std::memory_order_relaxed); }
+
+    // 有比sinceSequence更新的快照时拷贝到out并返回true
+    bool latest(AnalysisSnapshot& out, uint64_t sinceSequence);
+
+private:
+    static const int FRESH = 4; // m_middle中表示有未读快照的位
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    GoBoard m_pending;
+    double m_pendingKomi;
+    bool m_hasPosition;
+    std::atomic<uint64_t> m_positionVersion;
+    std::atomic<bool> m_paused;
+    std::atomic<bool> m_quit;
+    std::atomic<int> m_publishIntervalMs;
+
+    AnalysisSnapshot m_buffers[3];
+    std::atomic<int> m_middle;
+    int m_back;  // 只由搜索线程使用
+    int m_front; // 只由读取方使用
+
+    void run();
+    void publish(const GoMcts& mcts, uint64_t sequence);
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+
+// 棋盘点集：按row * size + col编号，最大19路（361位，6个64位字）
+// 合法着点、提示等整盘查询的结果，拷贝和比较都是按字进行
+class BoardBitset {
+public:
+    static const int MAX_BITS = 19 * 19;
+    static const int WORDS = (MAX_BITS + 63) / 64;
+
+    BoardBitset() { clear(); }
+
+    void clear()
+    {
+        for (auto& word : m_words) {
+            word = 0;
+        }
+    }
+
+    void set(int index) { m_words[index >> 6] |= uint64_t(1) << (index & 63); }
+    void reset(int index) { m_words[index >> 6] &= ~(uint64_t(1) << (index & 63)); }
+    bool test(int index) const { return (m_words[index >> 6] >> (index & 63)) & 1; }
+    uint64_t word(int i) const { return m_words[i]; }
+
+    bool empty() const
+    {
+        uint64_t any = 0;
+        for (uint64_t word : m_words) {
+            any |= word;
+        }
+        return any == 0;
+    }
+
+    int count() const
+    {
+        int total = 0;
+        for (uint64_t word : m_words) {
+            total += popcount(word);
+        }
+        return total;
+    }
+
+    // 第n个（从0数）置位的编号，n必须小于count()；用于均匀随机选点
+    int nth(int n) const
+    {
+        for (int i = 0; i < WORDS; ++i) {
+            int bits = popcount(m_words[i]);
+            if (n < bits) {
+                uint64_t word = m_words[i];
+                for (; n > 0; --n) {
+                    word &= word - 1;
+                }
+                return i * 64 + lowestBit(word);
+            }
+            n -= bits;
+        }
+        return -1;
+    }
+
+    // 按编号从小到大访问每个置位
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (int i = 0; i < WORDS; ++i) {
+            for (uint64_t word = m_words[i]; word; word &= word - 1) {
+                f(i * 64 + lowestBit(word));
+            }
+        }
+    }
+
+    bool operator==(const BoardBitset& other) const
+    {
+        for (int i = 0; i < WORDS; ++i) {
+            if (m_words[i] != other.m_words[i]) return false;
+        }
+        return true;
+    }
+    bool operator!=(const BoardBitset& other) const { return !(*this == other); }
+
+private:
+    uint64_t m_words[WORDS];
+
+    static int popcount(uint64_t x)
+    {
+#if defined(__GNUC__)
+        return __builtin_popcountll(x);
+#else
+        int count = 0;
+        for (; x; x &= x - 1) {
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    static int lowestBit(uint64_t x)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(x);
+#else
+        int index = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+};
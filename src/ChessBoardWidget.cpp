@@ -1,6 +1,7 @@
 /// ChessBoardWidget.cpp
 #include "ChessBoardWidget.h"
 #include "ChessLogic.h"
+#include "LatencyTracer.h"
 #include <QPainter>
 #include <QMouseEvent>
 #include <cmath>
@@ -11,9 +12,14 @@ ChessBoardWidget::ChessBoardWidget(ChessLogic* gameLogic, QWidget* parent)
     , m_boardSize(15) // 默认15x15棋盘（五子棋）
     , m_cellSize(30)
     , m_imagesLoaded(false)
+    , m_imagesRatio(1.0)
+    , m_hasAnalysis(false)
+    , m_analysisLayerDirty(false)
+    , m_territory(nullptr)
 {
     setMinimumSize((m_boardSize + 2) * m_cellSize, (m_boardSize + 2) * m_cellSize);
     setMouseTracking(true);
+    setFocusPolicy(Qt::ClickFocus); // F3切换延迟显示
     // 延迟加载图片，在第一次绘制时加载
 }
 
@@ -29,12 +35,38 @@ void ChessBoardWidget::setBoardSize(int size)
     setMinimumSize((m_boardSize + 2) * m_cellSize, (m_boardSize + 2) * m_cellSize);
     // 重新加载图片以适应新的棋子大小
     m_imagesLoaded = false;
+    m_analysisLayerDirty = true;
+    update();
+}
+
+void ChessBoardWidget::setAnalysisSnapshot(const AnalysisSnapshot& snapshot)
+{
+    m_analysis = snapshot;
+    m_hasAnalysis = snapshot.boardSize == m_boardSize;
+    m_analysisLayerDirty = true;
+    update();
+}
+
+void ChessBoardWidget::clearAnalysis()
+{
+    if (!m_hasAnalysis) return;
+    m_hasAnalysis = false;
+    update();
+}
+
+void ChessBoardWidget::setTerritoryEstimate(const InfluenceMap* map)
+{
+    if (m_territory == map) return;
+    m_territory = map;
     update();
 }
 
 void ChessBoardWidget::ensureImagesLoaded()
 {
-    if (!m_imagesLoaded) {
+    // 拖到高分屏上设备像素比会变，棋子图要按新的比例重画，否则会被放大发糊
+    qreal ratio = devicePixelRatioF();
+    if (!m_imagesLoaded || m_imagesRatio != ratio) {
+        m_imagesRatio = ratio;
         loadPieceImages();
         m_imagesLoaded = true;
     }
@@ -42,9 +74,13 @@ void ChessBoardWidget::ensureImagesLoaded()
 
 void ChessBoardWidget::loadPieceImages()
 {
-    // 创建黑色棋子
+    // 按物理像素分配，绘制仍用逻辑坐标
     int pieceSize = m_cellSize - 4;
-    m_blackPiecePixmap = QPixmap(pieceSize, pieceSize);
+    QSize pixelSize = QSize(pieceSize, pieceSize) * m_imagesRatio;
+    
+    // 创建黑色棋子
+    m_blackPiecePixmap = QPixmap(pixelSize);
+    m_blackPiecePixmap.setDevicePixelRatio(m_imagesRatio);
     m_blackPiecePixmap.fill(Qt::transparent);
     QPainter blackPainter(&m_blackPiecePixmap);
     blackPainter.setRenderHint(QPainter::Antialiasing);
@@ -54,7 +90,8 @@ void ChessBoardWidget::loadPieceImages()
     blackPainter.end();
     
     // 创建白色棋子
-    m_whitePiecePixmap = QPixmap(pieceSize, pieceSize);
+    m_whitePiecePixmap = QPixmap(pixelSize);
+    m_whitePiecePixmap.setDevicePixelRatio(m_imagesRatio);
     m_whitePiecePixmap.fill(Qt::transparent);
     QPainter whitePainter(&m_whitePiecePixmap);
     whitePainter.setRenderHint(QPainter::Antialiasing);
@@ -67,6 +104,10 @@ void ChessBoardWidget::loadPieceImages()
 void ChessBoardWidget::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event);
+    LATENCY_TRACE("ChessBoardWidget::paintEvent", "paint");
+    LatencyTracer& tracer = LatencyTracer::instance();
+    int64_t frameStart = tracer.isActive() ? tracer.nowUs() : 0;
+    
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
 
@@ -79,6 +120,120 @@ void ChessBoardWidget::paintEvent(QPaintEvent* event)
     drawBoard(painter);
     drawCoordinates(painter);
     drawPieces(painter);
+    
+    if (m_territory && m_territory->size() == m_boardSize) {
+        drawTerritory(painter);
+    }
+    
+    if (m_hasAnalysis) {
+        qreal ratio = devicePixelRatioF();
+        if (m_analysisLayerDirty || m_analysisLayer.size() != size() * ratio) {
+            renderAnalysisLayer();
+        }
+        painter.drawPixmap(0, 0, m_analysisLayer);
+    }
+    
+    if (tracer.isOverlayEnabled()) {
+        drawLatencyOverlay(painter);
+    }
+    
+    if (tracer.isActive()) {
+        painter.end();
+        tracer.framePainted(frameStart, tracer.nowUs());
+    }
+}
+
+void ChessBoardWidget::drawLatencyOverlay(QPainter& painter)
+{
+    // 显示的是上一帧的数据，本帧耗时要等绘制结束才知道
+    LatencyTracer& tracer = LatencyTracer::instance();
+    QString text = QString("帧 %1 ms  输入 %2 ms  最大 %3 ms")
+                   .arg(tracer.lastFrameMs(), 0, 'f', 1)
+                   .arg(tracer.lastInputLatencyMs(), 0, 'f', 1)
+                   .arg(tracer.maxInputLatencyMs(), 0, 'f', 1);
+    
+    QFont font = painter.font();
+    font.setPointSize(9);
+    painter.setFont(font);
+    QRect box = painter.fontMetrics().boundingRect(text).adjusted(-4, -2, 4, 2);
+    box.moveTopLeft(QPoint(4, 4));
+    painter.fillRect(box, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    painter.drawText(box, Qt::AlignCenter, text);
+}
+
+void ChessBoardWidget::drawTerritory(QPainter& painter)
+{
+    // 每帧直接画：最多361个小方块，比维护一张离屏图层便宜
+    int square = m_cellSize / 3;
+    for (int row = 0; row < m_boardSize; ++row) {
+        for (int col = 0; col < m_boardSize; ++col) {
+            if (m_gameLogic->getPieceAt(row, col) != PieceColor::Empty) continue;
+            PieceColor owner = m_territory->owner(row, col);
+            if (owner == PieceColor::Empty) continue;
+            QColor color = owner == PieceColor::Black ? QColor(0, 0, 0, 120) : QColor(255, 255, 255, 150);
+            QPoint center = boardToPixel(row, col);
+            painter.fillRect(center.x() - square / 2, center.y() - square / 2, square, square, color);
+        }
+    }
+}
+
+void ChessBoardWidget::renderAnalysisLayer()
+{
+    LATENCY_TRACE("ChessBoardWidget::renderAnalysisLayer", "paint");
+    qreal ratio = devicePixelRatioF();
+    m_analysisLayer = QPixmap(size() * ratio);
+    m_analysisLayer.setDevicePixelRatio(ratio);
+    m_analysisLayer.fill(Qt::transparent);
+    m_analysisLayerDirty = false;
+
+    QPainter painter(&m_analysisLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // 归属：每点一个小方块，黑白表示归属方，透明度表示把握
+    int square = m_cellSize / 3;
+    for (int row = 0; row < m_boardSize; ++row) {
+        for (int col = 0; col < m_boardSize; ++col) {
+            float owner = m_analysis.ownership[row * m_boardSize + col];
+            if (std::fabs(owner) < 0.2f) continue;
+            int alpha = static_cast<int>(std::fabs(owner) * 180);
+            QColor color = owner > 0 ? QColor(0, 0, 0, alpha) : QColor(255, 255, 255, alpha);
+            QPoint center = boardToPixel(row, col);
+            painter.fillRect(center.x() - square / 2, center.y() - square / 2, square, square, color);
+        }
+    }
+
+    // 候选点：胜率和访问次数，最多访问的一手用蓝色
+    QFont font = painter.font();
+    font.setPointSize(7);
+    painter.setFont(font);
+    int radius = m_cellSize / 2 - 1;
+    for (int i = 0; i < m_analysis.candidateCount; ++i) {
+        const AnalysisSnapshot::Candidate& candidate = m_analysis.candidates[i];
+        QPoint center = boardToPixel(candidate.row, candidate.col);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(i == 0 ? QColor(52, 152, 219, 220) : QColor(46, 204, 113, 180));
+        painter.drawEllipse(center, radius, radius);
+
+        QString visits = candidate.visits >= 1000 ? QString("%1k").arg(candidate.visits / 1000)
+                                                  : QString::number(candidate.visits);
+        QRect box(center.x() - radius, center.y() - radius, 2 * radius, 2 * radius);
+        painter.setPen(Qt::white);
+        painter.drawText(box, Qt::AlignCenter,
+                         QString("%1\n%2").arg(static_cast<int>(candidate.winRate * 100)).arg(visits));
+    }
+
+    // 右上角：轮到的一方的胜率和搜索次数
+    QString summary = QString("胜率 %1%  搜索 %2")
+                      .arg(m_analysis.winRate * 100, 0, 'f', 1)
+                      .arg(m_analysis.iterations);
+    font.setPointSize(9);
+    painter.setFont(font);
+    QRect box = painter.fontMetrics().boundingRect(summary).adjusted(-4, -2, 4, 2);
+    box.moveTopRight(QPoint(width() - 4, 4));
+    painter.fillRect(box, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    painter.drawText(box, Qt::AlignCenter, summary);
 }
 
 // 修正后的drawBoard函数
@@ -174,14 +329,29 @@ void ChessBoardWidget::drawPieces(QPainter& painter)
 
 void ChessBoardWidget::mousePressEvent(QMouseEvent* event)
 {
+    LatencyTracer::instance().markInput();
+    LATENCY_TRACE("ChessBoardWidget::mousePressEvent", "input");
+    
     if (event->button() == Qt::LeftButton) {
         auto [row, col] = pixelToBoard(event->pos());
         if (row >= 0 && row < m_boardSize && col >= 0 && col < m_boardSize) {
+            LATENCY_TRACE("positionClicked", "signal");
             emit positionClicked(row, col);
         }
     }
 }
 
+void ChessBoardWidget::keyPressEvent(QKeyEvent* event)
+{
+    if (event->key() == Qt::Key_F3) {
+        LatencyTracer& tracer = LatencyTracer::instance();
+        tracer.setOverlayEnabled(!tracer.isOverlayEnabled());
+        update();
+        return;
+    }
+    QWidget::keyPressEvent(event);
+}
+
 QPoint ChessBoardWidget::boardToPixel(int row, int col) const
 {
     int boardOffset = m_cellSize + m_cellSize/2;
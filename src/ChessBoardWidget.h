@@ -7,6 +7,8 @@
 #include<QPainter>
 #include<QMouseEvent>
 #include "ChessPiece.h"
+#include "AnalysisEngine.h"
+#include "InfluenceMap.h"
 
 class ChessLogic;
 
@@ -17,27 +19,44 @@ public:
     explicit ChessBoardWidget(ChessLogic* gameLogic, QWidget *parent = nullptr);
     
     void setBoardSize(int size);
+    // 分析图层：快照变化时重画一次离屏图层，之后每帧只多一次贴图
+    void setAnalysisSnapshot(const AnalysisSnapshot& snapshot);
+    void clearAnalysis();
+    // 形势估计图层：空点上画归属方的小方块，传nullptr关闭；map由调用方持有并保持更新
+    void setTerritoryEstimate(const InfluenceMap* map);
     
 signals:
     void positionClicked(int row, int col);
 protected:
     void paintEvent(QPaintEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
 private:
     ChessLogic* m_gameLogic;
     int m_boardSize;
     int m_cellSize;
     bool m_imagesLoaded;
+    qreal m_imagesRatio; // 棋子图按这个设备像素比画，换屏幕后重画
 
     QPixmap m_blackPiecePixmap;
     QPixmap m_whitePiecePixmap;
 
+    AnalysisSnapshot m_analysis;
+    bool m_hasAnalysis;
+    bool m_analysisLayerDirty;
+    QPixmap m_analysisLayer;
+
+    const InfluenceMap* m_territory;
+
     void loadPieceImages();
     void ensureImagesLoaded();
 
     void drawBoard(QPainter& painter);
     void drawPieces(QPainter& painter);
     void drawCoordinates(QPainter& painter);
+    void drawLatencyOverlay(QPainter& painter);
+    void drawTerritory(QPainter& painter);
+    void renderAnalysisLayer();
     QPoint boardToPixel(int row, int col) const;
     std::pair<int, int> pixelToBoard(const QPoint& pos) const;
 };
\ No newline at end of file
@@ -7,17 +7,33 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QPushButton>
+#include <QComboBox>
 #include <QStackedWidget>
 #include <QFont>
 #include <QMessageBox>
 #include <QApplication>
+#include <QEvent>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include "ChessBoardWidget.h"
 #include "ChessLogic.h"
+#include "LatencyTracer.h"
+#include "AnalysisEngine.h"
+#include "GoBoard.h"
 
 ChessGame::ChessGame(QWidget* parent)
     : QMainWindow(parent)
+    , m_gameWidget(nullptr)
+    , m_boardWidget(nullptr)
+    , m_gameLogic(nullptr)
+    , m_victoryWidget(nullptr)
+    , m_scoringWidget(nullptr)
+    , m_analysisKey(0)
+    , m_analysisSequence(0)
     , m_currentMode(GameMode::None)
     , m_moveCount(0)
+    , m_launchUs(-1)
 {
     setWindowTitle("棋类");
     resize(1000, 800);
@@ -25,18 +41,71 @@ ChessGame::ChessGame(QWidget* parent)
     m_stackedWidget = new QStackedWidget(this);
     setCentralWidget(m_stackedWidget);
     
+    // 计时器在开始围棋对局时才启动，停在主菜单时不唤醒
     m_timer = new QTimer(this);
+    m_timer->setInterval(1000); // 每秒更新一次
     connect(m_timer, &QTimer::timeout, this, &ChessGame::updateTimer);
-    m_timer->start(1000); // 每秒更新一次
     
+    m_analysisTimer = new QTimer(this);
+    m_analysisTimer->setInterval(100); // 与分析线程的发布频率一致
+    connect(m_analysisTimer, &QTimer::timeout, this, &ChessGame::pollAnalysis);
+    
+    // 对局、胜利、计分界面（分析画在对局界面的棋盘上）都等第一次用到时再建
     setupMainMenu();
-    setupGameInterface();
     
     m_stackedWidget->setCurrentWidget(m_menuWidget);
 }
 
 ChessGame::~ChessGame() = default;
 
+void ChessGame::measureFirstFrame(int64_t launchUs)
+{
+    m_launchUs = launchUs;
+    m_menuWidget->installEventFilter(this);
+}
+
+bool ChessGame::eventFilter(QObject* watched, QEvent* event)
+{
+    // 主菜单第一次绘制时，这一帧要等本轮事件处理完才刷到屏幕上，排到其后再计时
+    if (watched == m_menuWidget && event->type() == QEvent::Paint && m_launchUs >= 0) {
+        m_menuWidget->removeEventFilter(this);
+        QTimer::singleShot(0, this, &ChessGame::reportFirstFrame);
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void ChessGame::reportFirstFrame()
+{
+    LatencyTracer& tracer = LatencyTracer::instance();
+    int64_t now = tracer.nowUs();
+    if (tracer.isRecording()) {
+        tracer.complete("startup to first frame", "startup", m_launchUs, now);
+    }
+    std::fprintf(stderr, "first frame: %.1f ms\n", (now - m_launchUs) / 1000.0);
+    m_launchUs = -1;
+    
+    // CHESS_FIRST_FRAME_EXIT=1时报告完就退出，便于脚本反复测量启动时间
+    const char* exitAfter = std::getenv("CHESS_FIRST_FRAME_EXIT");
+    if (exitAfter && *exitAfter && *exitAfter != '0') {
+        QApplication::quit();
+    }
+}
+
+void ChessGame::ensureGameInterface()
+{
+    if (!m_gameWidget) setupGameInterface();
+}
+
+void ChessGame::ensureVictoryInterface()
+{
+    if (!m_victoryWidget) setupVictoryInterface();
+}
+
+void ChessGame::ensureScoringInterface()
+{
+    if (!m_scoringWidget) setupScoringInterface();
+}
+
 void ChessGame::setupMainMenu()
 {
     m_menuWidget = new QWidget();
@@ -54,13 +123,22 @@ void ChessGame::setupMainMenu()
     // 按钮
     m_goButton = new QPushButton("围棋");
     m_gomokuButton = new QPushButton("五子棋");
+    m_connect6Button = new QPushButton("六子棋");
     m_exitButton = new QPushButton("退出游戏");
     
+    // 五子棋规则，顺序与GomokuRule一致
+    m_gomokuRuleBox = new QComboBox();
+    m_gomokuRuleBox->addItem("自由规则（五连及以上胜）");
+    m_gomokuRuleBox->addItem("标准规则（恰好五连胜）");
+    m_gomokuRuleBox->addItem("连珠规则（黑棋禁手）");
+    
     QFont buttonFont;
     buttonFont.setPointSize(16);
     m_goButton->setFont(buttonFont);
     m_gomokuButton->setFont(buttonFont);
+    m_connect6Button->setFont(buttonFont);
     m_exitButton->setFont(buttonFont);
+    m_gomokuRuleBox->setFont(buttonFont);
     
     QString buttonStyle = "QPushButton { "
                          "background-color: #3498db; "
@@ -76,7 +154,9 @@ void ChessGame::setupMainMenu()
     
     m_goButton->setStyleSheet(buttonStyle);
     m_gomokuButton->setStyleSheet(buttonStyle);
+    m_connect6Button->setStyleSheet(buttonStyle);
     m_exitButton->setStyleSheet(buttonStyle);
+    m_gomokuRuleBox->setStyleSheet("QComboBox { padding: 8px; margin: 0px 10px; }");
     
     // 布局
     menuLayout->addStretch();
@@ -84,12 +164,15 @@ void ChessGame::setupMainMenu()
     menuLayout->addStretch();
     menuLayout->addWidget(m_goButton);
     menuLayout->addWidget(m_gomokuButton);
+    menuLayout->addWidget(m_gomokuRuleBox);
+    menuLayout->addWidget(m_connect6Button);
     menuLayout->addWidget(m_exitButton);
     menuLayout->addStretch();
     
     // 连接信号
     connect(m_goButton, &QPushButton::clicked, this, &ChessGame::startGoGame);
     connect(m_gomokuButton, &QPushButton::clicked, this, &ChessGame::startGomokuGame);
+    connect(m_connect6Button, &QPushButton::clicked, this, &ChessGame::startConnect6Game);
     connect(m_exitButton, &QPushButton::clicked, this, &ChessGame::exitGame);
     
     m_stackedWidget->addWidget(m_menuWidget);
@@ -105,6 +188,7 @@ void ChessGame::setupGameInterface()
     m_currentPlayerLabel = new QLabel("当前出手方：黑方");
     m_moveCountLabel = new QLabel("棋数：0");
     m_capturedLabel = new QLabel("提子：黑0 白0");
+    m_estimateLabel = new QLabel("");
     m_koLabel = new QLabel("");
     m_returnMenuButton = new QPushButton("返回主菜单");
     
@@ -113,12 +197,14 @@ void ChessGame::setupGameInterface()
     m_currentPlayerLabel->setFont(infoFont);
     m_moveCountLabel->setFont(infoFont);
     m_capturedLabel->setFont(infoFont);
+    m_estimateLabel->setFont(infoFont);
     m_koLabel->setFont(infoFont);
     m_returnMenuButton->setFont(infoFont);
     
     m_currentPlayerLabel->setStyleSheet("color: #2c3e50; padding: 5px;");
     m_moveCountLabel->setStyleSheet("color: #2c3e50; padding: 5px;");
     m_capturedLabel->setStyleSheet("color: #2c3e50; padding: 5px;");
+    m_estimateLabel->setStyleSheet("color: #2c3e50; padding: 5px;");
     m_koLabel->setStyleSheet("color: #e74c3c; padding: 5px; font-weight: bold;");
     m_returnMenuButton->setStyleSheet("QPushButton { "
                                      "background-color: #e74c3c; "
@@ -134,6 +220,7 @@ void ChessGame::setupGameInterface()
     infoLayout->addWidget(m_currentPlayerLabel);
     infoLayout->addWidget(m_moveCountLabel);
     infoLayout->addWidget(m_capturedLabel);
+    infoLayout->addWidget(m_estimateLabel);
     infoLayout->addWidget(m_koLabel);
     infoLayout->addStretch();
     infoLayout->addWidget(m_returnMenuButton);
@@ -172,14 +259,22 @@ void ChessGame::setupGameInterface()
     m_passButton = new QPushButton("虚着");
     m_resignButton = new QPushButton("认输");
     m_undoButton = new QPushButton("悔棋");
+    m_redoButton = new QPushButton("重做");
     m_drawButton = new QPushButton("和棋");
+    m_analysisButton = new QPushButton("分析");
+    m_analysisButton->setCheckable(true);
+    m_estimateButton = new QPushButton("形势");
+    m_estimateButton->setCheckable(true);
     
     QFont controlFont;
     controlFont.setPointSize(12);
     m_passButton->setFont(controlFont);
     m_resignButton->setFont(controlFont);
     m_undoButton->setFont(controlFont);
+    m_redoButton->setFont(controlFont);
     m_drawButton->setFont(controlFont);
+    m_analysisButton->setFont(controlFont);
+    m_estimateButton->setFont(controlFont);
     
     QString controlStyle = "QPushButton { "
                           "background-color: #3498db; "
@@ -209,12 +304,18 @@ void ChessGame::setupGameInterface()
                                  "background-color: #c0392b; "
                                  "}");
     m_undoButton->setStyleSheet(controlStyle);
+    m_redoButton->setStyleSheet(controlStyle);
     m_drawButton->setStyleSheet(controlStyle);
+    m_analysisButton->setStyleSheet(controlStyle + " QPushButton:checked { background-color: #27ae60; }");
+    m_estimateButton->setStyleSheet(controlStyle + " QPushButton:checked { background-color: #27ae60; }");
     
     controlLayout->addWidget(m_passButton);
     controlLayout->addWidget(m_resignButton);
     controlLayout->addWidget(m_undoButton);
+    controlLayout->addWidget(m_redoButton);
     controlLayout->addWidget(m_drawButton);
+    controlLayout->addWidget(m_analysisButton);
+    controlLayout->addWidget(m_estimateButton);
     controlLayout->addStretch();
     
     // 棋盘
@@ -233,12 +334,16 @@ void ChessGame::setupGameInterface()
     connect(m_passButton, &QPushButton::clicked, this, &ChessGame::onPass);
     connect(m_resignButton, &QPushButton::clicked, this, &ChessGame::onResign);
     connect(m_undoButton, &QPushButton::clicked, this, &ChessGame::onUndo);
+    connect(m_redoButton, &QPushButton::clicked, this, &ChessGame::onRedo);
     connect(m_drawButton, &QPushButton::clicked, this, &ChessGame::onDraw);
+    connect(m_analysisButton, &QPushButton::toggled, this, &ChessGame::onAnalysisToggled);
+    connect(m_estimateButton, &QPushButton::toggled, this, &ChessGame::onEstimateToggled);
     
     connect(m_boardWidget, &ChessBoardWidget::positionClicked,
             m_gameLogic, &ChessLogic::handleClick);
     connect(m_gameLogic, &ChessLogic::boardUpdated, this, &ChessGame::updateGameInfo);
     connect(m_gameLogic, &ChessLogic::boardUpdated, m_boardWidget, static_cast<void(QWidget::*)()>(&QWidget::update));
+    connect(m_gameLogic, &ChessLogic::boardUpdated, this, &ChessGame::syncAnalysisPosition);
     connect(m_gameLogic, &ChessLogic::gameOver, this, &ChessGame::onGameOver);
     connect(m_gameLogic, &ChessLogic::gamePhaseChanged, this, &ChessGame::onGamePhaseChanged);
     connect(m_gameLogic, &ChessLogic::scoreChanged, this, &ChessGame::onScoreChanged);
@@ -246,12 +351,6 @@ void ChessGame::setupGameInterface()
     connect(m_gameLogic, &ChessLogic::koOccurred, this, &ChessGame::onKoOccurred);
     
     m_stackedWidget->addWidget(m_gameWidget);
-    
-    // 胜利界面
-    setupVictoryInterface();
-    
-    // 计分界面
-    setupScoringInterface();
 }
 
 void ChessGame::setupVictoryInterface()
@@ -295,18 +394,24 @@ void ChessGame::setupVictoryInterface()
 
 void ChessGame::startGoGame()
 {
+    ensureGameInterface();
     m_currentMode = GameMode::Go;
     m_moveCount = 0;
     m_gameLogic->resetGame();
     m_gameLogic->setGameMode(GameMode::Go);
     m_boardWidget->setBoardSize(19); // 围棋使用19x19棋盘
     m_gameLogic->startTimer();
+    m_timer->start();
     updateGameInfo();
     updateTimeDisplay();
     
     // 显示围棋相关控件
     m_passButton->setVisible(true);
+    m_redoButton->setVisible(true);
+    m_analysisButton->setVisible(true);
+    m_estimateButton->setVisible(true);
     m_capturedLabel->setVisible(true);
+    m_estimateLabel->setVisible(true);
     m_koLabel->setVisible(true);
     m_blackTimeLabel->setVisible(true);
     m_whiteTimeLabel->setVisible(true);
@@ -318,16 +423,56 @@ void ChessGame::startGoGame()
 
 void ChessGame::startGomokuGame()
 {
+    ensureGameInterface();
+    m_timer->stop();
     m_currentMode = GameMode::Gomoku;
     m_moveCount = 0;
+    GameSettings settings = m_gameLogic->getGameSettings();
+    settings.gomokuRule = static_cast<GomokuRule>(m_gomokuRuleBox->currentIndex());
+    m_gameLogic->setGameSettings(settings);
     m_gameLogic->resetGame();
     m_gameLogic->setGameMode(GameMode::Gomoku);
+    stopAnalysis();
     m_boardWidget->setBoardSize(15); // 五子棋使用15x15棋盘
     updateGameInfo();
     
     // 隐藏围棋相关控件
     m_passButton->setVisible(false);
+    m_redoButton->setVisible(false);
+    m_analysisButton->setVisible(false);
+    m_estimateButton->setVisible(false);
+    m_estimateButton->setChecked(false);
+    m_capturedLabel->setVisible(false);
+    m_estimateLabel->setVisible(false);
+    m_koLabel->setVisible(false);
+    m_blackTimeLabel->setVisible(false);
+    m_whiteTimeLabel->setVisible(false);
+    m_blackByoYomiLabel->setVisible(false);
+    m_whiteByoYomiLabel->setVisible(false);
+    
+    m_stackedWidget->setCurrentWidget(m_gameWidget);
+}
+
+void ChessGame::startConnect6Game()
+{
+    ensureGameInterface();
+    m_timer->stop();
+    m_currentMode = GameMode::Connect6;
+    m_moveCount = 0;
+    m_gameLogic->resetGame();
+    m_gameLogic->setGameMode(GameMode::Connect6);
+    stopAnalysis();
+    m_boardWidget->setBoardSize(19); // 六子棋使用19x19棋盘
+    updateGameInfo();
+    
+    // 隐藏围棋相关控件
+    m_passButton->setVisible(false);
+    m_redoButton->setVisible(false);
+    m_analysisButton->setVisible(false);
+    m_estimateButton->setVisible(false);
+    m_estimateButton->setChecked(false);
     m_capturedLabel->setVisible(false);
+    m_estimateLabel->setVisible(false);
     m_koLabel->setVisible(false);
     m_blackTimeLabel->setVisible(false);
     m_whiteTimeLabel->setVisible(false);
@@ -339,6 +484,8 @@ void ChessGame::startGomokuGame()
 
 void ChessGame::returnToMainMenu()
 {
+    m_timer->stop();
+    stopAnalysis();
     m_stackedWidget->setCurrentWidget(m_menuWidget);
     m_currentMode = GameMode::None;
 }
@@ -350,6 +497,7 @@ void ChessGame::exitGame()
 
 void ChessGame::onGameOver(PieceColor winner)
 {
+    ensureVictoryInterface();
     QString winnerText = (winner == PieceColor::Black) ? "黑方" : "白方";
     m_victoryLabel->setText(winnerText + "获胜！");
     m_stackedWidget->setCurrentWidget(m_victoryWidget);
@@ -405,6 +553,8 @@ void ChessGame::setupScoringInterface()
 
 void ChessGame::updateGameInfo()
 {
+    LATENCY_TRACE("ChessGame::updateGameInfo", "ui");
+    
     QString currentPlayerText = (m_gameLogic->getCurrentPlayer() == PieceColor::Black) ? "黑方" : "白方";
     m_currentPlayerLabel->setText("当前出手方：" + currentPlayerText);
     m_moveCountLabel->setText("棋数：" + QString::number(m_moveCount));
@@ -414,10 +564,17 @@ void ChessGame::updateGameInfo()
         m_capturedLabel->setText(QString("提子：黑%1 白%2")
                                 .arg(m_gameLogic->getCapturedBlack())
                                 .arg(m_gameLogic->getCapturedWhite()));
+        // 形势估计：数子法（棋子+势力范围内的空点），已扣贴目
+        m_influence.update(m_gameLogic->getGoBoard());
+        double lead = m_influence.estimate(m_gameLogic->getGameSettings().komi);
+        m_estimateLabel->setText(QString("形势：%1领先%2目")
+                                .arg(lead > 0 ? "黑" : "白")
+                                .arg(std::fabs(lead), 0, 'f', 1));
     }
     
-    // 更新悔棋按钮状态
+    // 更新悔棋、重做按钮状态
     m_undoButton->setEnabled(m_gameLogic->canUndo());
+    m_redoButton->setEnabled(m_gameLogic->canRedo());
     
     m_moveCount++;
 }
@@ -442,6 +599,12 @@ void ChessGame::onUndo()
     updateGameInfo();
 }
 
+void ChessGame::onRedo()
+{
+    // 重下经boardUpdated刷新界面和手数
+    m_gameLogic->redo();
+}
+
 void ChessGame::onDraw()
 {
     m_gameLogic->requestDraw();
@@ -450,12 +613,16 @@ void ChessGame::onDraw()
 void ChessGame::onGamePhaseChanged(GamePhase phase)
 {
     if (phase == GamePhase::Scoring) {
+        stopAnalysis();
+        ensureScoringInterface();
         m_stackedWidget->setCurrentWidget(m_scoringWidget);
     }
 }
 
 void ChessGame::onScoreChanged(double blackScore, double whiteScore)
 {
+    // 分数可能先于阶段切换发出
+    ensureScoringInterface();
     GameSettings settings = m_gameLogic->getGameSettings();
     m_scoreLabel->setText(QString("黑方: %1 目\n白方: %2 目\n贴目: %3 目")
                          .arg(blackScore, 0, 'f', 1)
@@ -532,6 +699,7 @@ void ChessGame::updateTimeDisplay()
 void ChessGame::updateScoreDisplay()
 {
     if (m_gameLogic->getGamePhase() == GamePhase::Scoring) {
+        ensureScoringInterface();
         double blackScore = m_gameLogic->getBlackScore();
         double whiteScore = m_gameLogic->getWhiteScore();
         GameSettings settings = m_gameLogic->getGameSettings();
@@ -543,3 +711,52 @@ void ChessGame::updateScoreDisplay()
     }
 }
 
+void ChessGame::onAnalysisToggled(bool enabled)
+{
+    if (!enabled) {
+        if (m_analysisEngine) m_analysisEngine->setPaused(true);
+        m_analysisTimer->stop();
+        m_boardWidget->clearAnalysis();
+        return;
+    }
+    // 分析线程在第一次打开时才创建，之后只暂停不销毁
+    if (!m_analysisEngine) m_analysisEngine.reset(new AnalysisEngine());
+    syncAnalysisPosition();
+    m_analysisEngine->setPaused(false);
+    m_analysisTimer->start();
+}
+
+void ChessGame::onEstimateToggled(bool enabled)
+{
+    m_boardWidget->setTerritoryEstimate(enabled ? &m_influence : nullptr);
+}
+
+void ChessGame::stopAnalysis()
+{
+    // 取消勾选会经toggled信号暂停分析线程
+    m_analysisButton->setChecked(false);
+}
+
+void ChessGame::syncAnalysisPosition()
+{
+    if (!m_analysisEngine || !m_analysisButton->isChecked() || m_currentMode != GameMode::Go) return;
+    LATENCY_TRACE("ChessGame::syncAnalysisPosition", "analysis");
+    // 规则核心里的棋盘含摆子、虚着和撤销记录，直接交给分析线程
+    const GoBoard& board = m_gameLogic->getGoBoard();
+    if (board.positionKey() == m_analysisKey) return;
+    m_analysisKey = board.positionKey();
+    m_boardWidget->clearAnalysis();
+    m_analysisEngine->setPosition(board, m_gameLogic->getGameSettings().komi);
+}
+
+void ChessGame::pollAnalysis()
+{
+    if (!m_analysisEngine) return;
+    AnalysisSnapshot snapshot;
+    if (!m_analysisEngine->latest(snapshot, m_analysisSequence)) return;
+    m_analysisSequence = snapshot.sequence;
+    // 换局面后旧局面的快照可能还没被替换，对不上的直接丢掉
+    if (snapshot.positionKey == m_analysisKey) {
+        m_boardWidget->setAnalysisSnapshot(snapshot);
+    }
+}
@@ -6,6 +6,7 @@
 #include "ChessLogic.h"
 #include "ChessBoardWidget.h"
 #include "ChessPiece.h"
+#include "InfluenceMap.h"
 #include <memory>
 #include <QMainWindow>
 #include <QWidget>
@@ -13,18 +14,28 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QPushButton>
+#include <QComboBox>
 #include <QStackedWidget>
 #include <QTimer>
 
+class AnalysisEngine;
+
 class ChessGame:public QMainWindow {
     Q_OBJECT
 public:
     ChessGame(QWidget* parent = nullptr);
     ~ChessGame();
+    
+    // 统计启动到首帧上屏的时间，launchUs为main开始时LatencyTracer::nowUs()的值
+    void measureFirstFrame(int64_t launchUs);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private slots:
     void startGoGame();
     void startGomokuGame();
+    void startConnect6Game();
     void returnToMainMenu();
     void exitGame();
     void onGameOver(PieceColor winner);
@@ -33,23 +44,34 @@ private slots:
     void onPass();
     void onResign();
     void onUndo();
+    void onRedo();
     void onDraw();
     void onGamePhaseChanged(GamePhase phase);
     void onScoreChanged(double blackScore, double whiteScore);
     void onTimeUpdated(int blackTime, int whiteTime);
     void onKoOccurred(int row, int col);
     void updateTimer();
+    void onAnalysisToggled(bool enabled);
+    void onEstimateToggled(bool enabled);
+    void syncAnalysisPosition();
+    void pollAnalysis();
+    void reportFirstFrame();
 
 private:
     void setupMainMenu();
     void setupGameInterface();
     void setupVictoryInterface();
     void setupScoringInterface();
+    // 各页第一次用到时才创建，启动时只建主菜单
+    void ensureGameInterface();
+    void ensureVictoryInterface();
+    void ensureScoringInterface();
     void updateGameInfo();
     void updateTimeDisplay();
     void updateScoreDisplay();
     QString formatTime(int seconds) const;
     QString getCoordinateString(int row, int col) const;
+    void stopAnalysis();
     
     QStackedWidget* m_stackedWidget;
     QTimer* m_timer;
@@ -59,6 +81,8 @@ private:
     QLabel* m_titleLabel;
     QPushButton* m_goButton;
     QPushButton* m_gomokuButton;
+    QComboBox* m_gomokuRuleBox;
+    QPushButton* m_connect6Button;
     QPushButton* m_exitButton;
     
     // 游戏界面
@@ -68,13 +92,17 @@ private:
     QLabel* m_currentPlayerLabel;
     QLabel* m_moveCountLabel;
     QLabel* m_capturedLabel;
+    QLabel* m_estimateLabel;
     QLabel* m_koLabel;
     
     // 控制按钮
     QPushButton* m_passButton;
     QPushButton* m_resignButton;
     QPushButton* m_undoButton;
+    QPushButton* m_redoButton;
     QPushButton* m_drawButton;
+    QPushButton* m_analysisButton;
+    QPushButton* m_estimateButton;
     QPushButton* m_returnMenuButton;
     
     // 计时显示
@@ -94,6 +122,18 @@ private:
     QLabel* m_resultLabel;
     QPushButton* m_scoringReturnButton;
     
+    // 后台分析：玩家思考时持续搜索当前局面，定时取最新快照画到棋盘上
+    std::unique_ptr<AnalysisEngine> m_analysisEngine;
+    QTimer* m_analysisTimer;
+    uint64_t m_analysisKey;
+    uint64_t m_analysisSequence;
+    
+    // 形势估计：每次棋盘更新时只重算变化附近的几行，随时可显示
+    InfluenceMap m_influence;
+    
     GameMode m_currentMode;
     int m_moveCount;
+    
+    // 首帧计时，负数表示不统计
+    int64_t m_launchUs;
 };
\ No newline at end of file
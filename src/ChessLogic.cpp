@@ -4,10 +4,17 @@
 
 // ChessLogic.cpp
 #include "ChessLogic.h"
+#include "LatencyTracer.h"
+#include "RulesStats.h"
+#include "GomokuRules.h"
 #include <QTimer>
+#include <algorithm>
+#include <thread>
 
 ChessLogic::ChessLogic(QObject* parent)
     : QObject(parent)
+    , m_goTree(BOARD_SIZE)
+    , m_gomokuBoard(GOMOKU_SIZE)
     , m_currentPlayer(PieceColor::Black)
     , m_gameOver(false)
     , m_gameMode(GameMode::Gomoku) // 默认五子棋
@@ -25,6 +32,7 @@ ChessLogic::ChessLogic(QObject* parent)
     , m_whiteByoYomiPeriods(m_settings.byoYomiPeriods)
     , m_timerActive(false)
 {
+    m_tsumego.setNodeLimit(20000); // 搜不完就退回数眼，终局计分不至于卡住
     // 初始化棋盘
     resetGame();
 }
@@ -63,30 +71,101 @@ void ChessLogic::resetGame()
             m_board[i][j] = PieceColor::Empty;
         }
     }
+    m_goTree.reset(BOARD_SIZE);
+    m_gomokuBoard.reset();
+    m_connect6.reset();
+}
+
+bool ChessLogic::setupStones(const std::vector<ChessPiece>& stones, PieceColor toPlay)
+{
+    if (m_gameOver || m_gamePhase != GamePhase::Playing || !m_moveHistory.empty()) return false;
+    if (m_gameMode != GameMode::Go && m_gameMode != GameMode::Gomoku) return false; // 六子棋按子数定轮次，不能摆
+    if (toPlay != PieceColor::Black && toPlay != PieceColor::White) return false;
+
+    int size = m_gameMode == GameMode::Gomoku ? GOMOKU_SIZE : BOARD_SIZE;
+    bool taken[BOARD_SIZE][BOARD_SIZE] = {{false}};
+    std::vector<int> black, white;
+    for (const ChessPiece& stone : stones) {
+        if (stone.row < 0 || stone.row >= size || stone.col < 0 || stone.col >= size) return false;
+        if (stone.color != PieceColor::Black && stone.color != PieceColor::White) return false;
+        if (m_board[stone.row][stone.col] != PieceColor::Empty || taken[stone.row][stone.col]) return false;
+        taken[stone.row][stone.col] = true;
+        if (m_gameMode == GameMode::Go) {
+            (stone.color == PieceColor::Black ? black : white).push_back(m_goTree.board().point(stone.row, stone.col));
+        }
+    }
+
+    if (m_gameMode == GameMode::Go) {
+        // GoBoard检查无气棋块，不通过时两边都不改
+        if (!m_goTree.setup(black, white, toPlay)) return false;
+    } else {
+        for (const ChessPiece& stone : stones) {
+            m_gomokuBoard.play(m_gomokuBoard.point(stone.row, stone.col), stone.color);
+        }
+    }
+    for (const ChessPiece& stone : stones) {
+        m_board[stone.row][stone.col] = stone.color;
+    }
+    m_currentPlayer = toPlay;
+    m_currentKo = KoPoint();
+    m_consecutivePasses = 0;
+
+    emit boardUpdated();
+    return true;
+}
+
+bool ChessLogic::placeHandicap(int stones)
+{
+    if (m_gameMode != GameMode::Go || stones < 2 || stones > 9) return false;
+
+    // 星位（行从上往下）：左下、右上、左上、右下，再是边星和天元
+    const int low = 3, mid = BOARD_SIZE / 2, high = BOARD_SIZE - 4;
+    const int corners[4][2] = {{high, low}, {low, high}, {low, low}, {high, high}};
+    std::vector<ChessPiece> setup;
+    for (int i = 0; i < std::min(stones, 4); ++i) {
+        setup.push_back(ChessPiece(corners[i][0], corners[i][1], PieceColor::Black));
+    }
+    // 5、7、9子加天元；6子起加左右边星，8子起再加上下边星
+    if (stones >= 6) {
+        setup.push_back(ChessPiece(mid, low, PieceColor::Black));
+        setup.push_back(ChessPiece(mid, high, PieceColor::Black));
+    }
+    if (stones >= 8) {
+        setup.push_back(ChessPiece(high, mid, PieceColor::Black));
+        setup.push_back(ChessPiece(low, mid, PieceColor::Black));
+    }
+    if (stones % 2 == 1 && stones >= 5) {
+        setup.push_back(ChessPiece(mid, mid, PieceColor::Black));
+    }
+    return setupStones(setup, PieceColor::White);
 }
 
 void ChessLogic::handleClick(int row, int col)
 {
+    LATENCY_TRACE("ChessLogic::handleClick", "logic");
+    
     if (m_gameOver || m_gamePhase != GamePhase::Playing || !isValidMove(row, col)) {
         return;
     }
 
+    RULES_STATS_SCOPE(ChessLogicEngine, Place);
+
     // 重置连续虚着计数
     m_consecutivePasses = 0;
     
-    // 记录移动
+    // 记录移动（先加入历史记录，提子信息记在这一步上）
     Move move(row, col, m_currentPlayer);
     
     placePiece(row, col);
+    m_moveHistory.push_back(move);
     
     // 围棋模式：提子
     if (m_gameMode == GameMode::Go) {
+        m_koHistory.push_back(m_currentKo);
         captureStones(row, col);
         checkAndSetKo(row, col);
     }
     
-    // 添加到历史记录
-    m_moveHistory.push_back(move);
     m_moveCount++;
 
     if (checkWin(row, col)) {
@@ -94,13 +173,19 @@ void ChessLogic::handleClick(int row, int col)
         m_gamePhase = GamePhase::Finished;
         emit gameOver(m_currentPlayer);
     } else {
-        switchPlayer();
+        // 六子棋一回合下两颗子，下完才换手
+        if (m_gameMode != GameMode::Connect6 || m_connect6.toPlay() != m_currentPlayer) {
+            switchPlayer();
+        }
+        LATENCY_TRACE("boardUpdated", "signal");
         emit boardUpdated();
     }
 }
 
 bool ChessLogic::isValidMove(int row, int col) const
 {
+    RULES_STATS_SCOPE(ChessLogicEngine, Legality);
+    
     if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE ||
         m_board[row][col] != PieceColor::Empty) {
         return false;
@@ -114,18 +199,72 @@ bool ChessLogic::isValidMove(int row, int col) const
         return !wouldBeSuicide(row, col, m_currentPlayer);
     }
     
+    // 五子棋模式：连珠规则下黑棋不能下禁手
+    if (m_gameMode == GameMode::Gomoku) {
+        if (row >= GOMOKU_SIZE || col >= GOMOKU_SIZE) {
+            return false;
+        }
+        return GomokuRules::isLegal(m_gomokuBoard, m_gomokuBoard.point(row, col), m_currentPlayer,
+                                    m_settings.gomokuRule);
+    }
+    
     return true;
 }
 
+BatchPlayoutStats ChessLogic::batchPlayouts(long long games, int threads) const
+{
+    if (m_gameMode != GameMode::Go || games <= 0) return BatchPlayoutStats();
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const GoBoard& board = m_goTree.board();
+    return runBatchPlayouts(board, games, threads, board.positionKey(), m_settings.komi);
+}
+
+BoardBitset ChessLogic::legalMoves() const
+{
+    RULES_STATS_SCOPE(ChessLogicEngine, Legality);
+
+    BoardBitset moves;
+    if (m_gameOver || m_gamePhase != GamePhase::Playing) return moves;
+    if (m_gameMode == GameMode::Go) {
+        m_goTree.board().legalMoves(m_currentPlayer, moves);
+        return moves;
+    }
+
+    // 五子棋只在15路内下；连珠规则下黑棋还要排除禁手，直接在m_gomokuBoard上试下再撤销
+    int size = m_gameMode == GameMode::Gomoku ? GOMOKU_SIZE : BOARD_SIZE;
+    bool checkForbidden = m_gameMode == GameMode::Gomoku && m_currentPlayer == PieceColor::Black &&
+                          m_settings.gomokuRule == GomokuRule::Renju;
+    GomokuBoard& board = m_gomokuBoard;
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            if (m_board[row][col] != PieceColor::Empty) continue;
+            if (checkForbidden && !GomokuRules::isLegal(board, board.point(row, col), m_currentPlayer, m_settings.gomokuRule)) {
+                continue;
+            }
+            moves.set(row * BOARD_SIZE + col);
+        }
+    }
+    return moves;
+}
+
 void ChessLogic::placePiece(int row, int col)
 {
     m_board[row][col] = m_currentPlayer;
+    if (m_gameMode == GameMode::Go) {
+        m_goTree.play(m_goTree.board().point(row, col), m_currentPlayer);
+    } else if (m_gameMode == GameMode::Gomoku) {
+        m_gomokuBoard.play(m_gomokuBoard.point(row, col), m_currentPlayer);
+    } else if (m_gameMode == GameMode::Connect6) {
+        m_connect6.play(row, col, m_currentPlayer);
+    }
 }
 
 bool ChessLogic::checkWin(int row, int col)
 {
     if (m_gameMode == GameMode::Gomoku) {
         return checkGomokuWin(row, col);
+    } else if (m_gameMode == GameMode::Connect6) {
+        return m_connect6.isWin(row, col);
     } else if (m_gameMode == GameMode::Go) {
         return checkGoWin(row, col);
     }
@@ -134,45 +273,8 @@ bool ChessLogic::checkWin(int row, int col)
 
 bool ChessLogic::checkGomokuWin(int row, int col)
 {
-    PieceColor player = m_board[row][col];
-    if (player == PieceColor::Empty) return false;
-
-    // 检查四个方向是否有连续5个棋子
-    int directions[4][2] = {{0,1}, {1,0}, {1,1}, {1,-1}};
-
-    for (auto& dir : directions) {
-        int count = 1; // 包含当前棋子
-
-        // 正向检查
-        for (int i = 1; i <= 4; ++i) {
-            int r = row + dir[0] * i;
-            int c = col + dir[1] * i;
-            if (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE &&
-                m_board[r][c] == player) {
-                count++;
-            } else {
-                break;
-            }
-        }
-
-        // 反向检查
-        for (int i = 1; i <= 4; ++i) {
-            int r = row - dir[0] * i;
-            int c = col - dir[1] * i;
-            if (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE &&
-                m_board[r][c] == player) {
-                count++;
-            } else {
-                break;
-            }
-        }
-
-        if (count >= 5) {
-            return true;
-        }
-    }
-
-    return false;
+    // 按所选规则判断：自由规则五连及以上胜，标准规则恰好五连胜，连珠规则黑棋恰好五连、白棋五连及以上胜
+    return GomokuRules::isWin(m_gomokuBoard, m_gomokuBoard.point(row, col), m_settings.gomokuRule);
 }
 
 bool ChessLogic::checkGoWin(int row, int col)
@@ -187,6 +289,8 @@ void ChessLogic::captureStones(int row, int col)
 {
     if (m_moveHistory.empty()) return;
     
+    RULES_STATS_SCOPE(ChessLogicEngine, Capture);
+    
     PieceColor opponent = (m_currentPlayer == PieceColor::Black) ? 
                          PieceColor::White : PieceColor::Black;
     
@@ -210,6 +314,7 @@ void ChessLogic::captureStones(int row, int col)
                         ChessPiece(pos.first, pos.second, opponent));
                 }
                 
+                RULES_STATS_SAMPLE(ChessLogicEngine, GroupSize, group.size());
                 removeGroup(group);
                 if (opponent == PieceColor::Black) {
                     m_capturedBlack += group.size();
@@ -309,31 +414,68 @@ bool ChessLogic::isSuicide(int row, int col, PieceColor color)
 
 bool ChessLogic::wouldBeSuicide(int row, int col, PieceColor color) const
 {
-    // 创建临时棋盘副本
-    PieceColor tempBoard[BOARD_SIZE][BOARD_SIZE];
-    for (int i = 0; i < BOARD_SIZE; ++i) {
-        for (int j = 0; j < BOARD_SIZE; ++j) {
-            tempBoard[i][j] = m_board[i][j];
-        }
-    }
-    
-    // 临时放置棋子
-    tempBoard[row][col] = color;
+    PieceColor opponent = (color == PieceColor::Black) ? 
+                         PieceColor::White : PieceColor::Black;
     
-    // 检查是否有气（简化版本）
     int directions[4][2] = {{0,1}, {1,0}, {0,-1}, {-1,0}};
     for (auto& dir : directions) {
         int r = row + dir[0];
         int c = col + dir[1];
-        if (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE &&
-            tempBoard[r][c] == PieceColor::Empty) {
+        if (r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE) {
+            continue;
+        }
+        
+        if (m_board[r][c] == PieceColor::Empty) {
             return false; // 有气，不是自杀
         }
+        // 能提掉对方棋块（其唯一的气就是落子点）
+        if (m_board[r][c] == opponent && !groupHasLibertyExcept(r, c, opponent, row, col)) {
+            return false;
+        }
+        // 与仍有其它气的己方棋块相连
+        if (m_board[r][c] == color && groupHasLibertyExcept(r, c, color, row, col)) {
+            return false;
+        }
     }
     
     return true; // 无气，是自杀
 }
 
+bool ChessLogic::groupHasLibertyExcept(int row, int col, PieceColor color, int exceptRow, int exceptCol) const
+{
+    bool visited[BOARD_SIZE][BOARD_SIZE] = {false};
+    std::vector<std::pair<int, int>> stack;
+    stack.push_back({row, col});
+    visited[row][col] = true;
+    
+    int directions[4][2] = {{0,1}, {1,0}, {0,-1}, {-1,0}};
+    int visitedCount = 0;
+    while (!stack.empty()) {
+        auto [r, c] = stack.back();
+        stack.pop_back();
+        visitedCount++;
+        for (auto& dir : directions) {
+            int nr = r + dir[0];
+            int nc = c + dir[1];
+            if (nr < 0 || nr >= BOARD_SIZE || nc < 0 || nc >= BOARD_SIZE || visited[nr][nc]) {
+                continue;
+            }
+            if (m_board[nr][nc] == PieceColor::Empty) {
+                if (nr != exceptRow || nc != exceptCol) {
+                    RULES_STATS_SAMPLE(ChessLogicEngine, FloodFill, visitedCount);
+                    return true;
+                }
+            } else if (m_board[nr][nc] == color) {
+                visited[nr][nc] = true;
+                stack.push_back({nr, nc});
+            }
+        }
+    }
+    
+    RULES_STATS_SAMPLE(ChessLogicEngine, FloodFill, visitedCount);
+    return false;
+}
+
 PieceColor ChessLogic::getPieceAt(int row, int col) const
 {
     if (row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE) {
@@ -348,6 +490,9 @@ void ChessLogic::pass()
     if (m_gamePhase != GamePhase::Playing) return;
     
     m_consecutivePasses++;
+    if (m_gameMode == GameMode::Go) {
+        m_goTree.play(GoBoard::PASS_MOVE, m_currentPlayer);
+    }
     
     // 双方连续虚着则进入终局
     if (m_consecutivePasses >= 2) {
@@ -372,6 +517,8 @@ void ChessLogic::undo()
 {
     if (m_moveHistory.empty() || m_gamePhase != GamePhase::Playing) return;
     
+    RULES_STATS_SCOPE(ChessLogicEngine, Undo);
+    
     // 撤销上一步
     Move lastMove = m_moveHistory.back();
     m_moveHistory.pop_back();
@@ -379,10 +526,26 @@ void ChessLogic::undo()
     
     // 恢复棋盘状态
     m_board[lastMove.row][lastMove.col] = PieceColor::Empty;
+    if (m_gameMode == GameMode::Go) {
+        // ChessLogic的悔棋跳过其后的虚着，着法树里虚着也是一个节点，一并退回；退掉的节点留着可以重做
+        while (m_goTree.current() != GameTree::ROOT && m_goTree.board().lastMove() == GoBoard::PASS_MOVE) {
+            m_goTree.back();
+        }
+        m_goTree.back();
+    } else if (m_gameMode == GameMode::Gomoku) {
+        m_gomokuBoard.undo();
+    } else if (m_gameMode == GameMode::Connect6) {
+        m_connect6.undo();
+    }
     
-    // 恢复被提的棋子
+    // 恢复被提的棋子和提子数
     for (const auto& piece : lastMove.capturedPieces) {
         m_board[piece.row][piece.col] = piece.color;
+        if (piece.color == PieceColor::Black) {
+            m_capturedBlack--;
+        } else {
+            m_capturedWhite--;
+        }
     }
     
     // 恢复玩家
@@ -404,6 +567,26 @@ bool ChessLogic::canUndo() const
     return !m_moveHistory.empty() && m_gamePhase == GamePhase::Playing;
 }
 
+void ChessLogic::redo()
+{
+    if (!canRedo()) return;
+    // 照常走一遍落子流程（提子、劫、着法记录），着法树里已有这一手，只是光标走进去
+    int next = m_goTree.forwardChild();
+    int p = m_goTree.move(next);
+    if (p == GoBoard::PASS_MOVE) {
+        pass();
+    } else {
+        handleClick(m_goTree.board().rowOf(p), m_goTree.board().colOf(p));
+    }
+}
+
+bool ChessLogic::canRedo() const
+{
+    if (m_gameMode != GameMode::Go || m_gameOver || m_gamePhase != GamePhase::Playing) return false;
+    int next = m_goTree.forwardChild();
+    return next != GameTree::NO_NODE && m_goTree.color(next) == m_currentPlayer;
+}
+
 void ChessLogic::requestDraw()
 {
     if (m_gamePhase != GamePhase::Playing) return;
@@ -422,29 +605,35 @@ bool ChessLogic::isKoPoint(int row, int col) const
 
 void ChessLogic::checkAndSetKo(int row, int col)
 {
-    // 检查是否形成劫
-    PieceColor opponent = (m_currentPlayer == PieceColor::Black) ? 
-                         PieceColor::White : PieceColor::Black;
+    RULES_STATS_SCOPE(ChessLogicEngine, Ko);
     
-    int directions[4][2] = {{0,1}, {1,0}, {0,-1}, {-1,0}};
+    // 检查是否形成劫：这一步只提了一个子，且刚下的子是单子、只剩被提点一口气
+    const Move& lastMove = m_moveHistory.back();
     
-    for (auto& dir : directions) {
-        int r = row + dir[0];
-        int c = col + dir[1];
+    if (lastMove.capturedPieces.size() == 1) {
+        int directions[4][2] = {{0,1}, {1,0}, {0,-1}, {-1,0}};
+        int liberties = 0;
+        bool isSingleStone = true;
         
-        if (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE &&
-            m_board[r][c] == opponent) {
-            
-            std::vector<std::pair<int, int>> group;
-            findGroup(r, c, opponent, group);
-            
-            // 如果只有一个棋子被提，且这个棋子能立即提回刚下的子，则形成劫
-            if (group.size() == 1 && !hasLiberties(r, c, opponent)) {
-                m_currentKo = KoPoint(r, c, opponent, m_moveCount);
-                emit koOccurred(r, c);
-                return;
+        for (auto& dir : directions) {
+            int r = row + dir[0];
+            int c = col + dir[1];
+            if (r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE) {
+                continue;
+            }
+            if (m_board[r][c] == PieceColor::Empty) {
+                liberties++;
+            } else if (m_board[r][c] == m_currentPlayer) {
+                isSingleStone = false;
             }
         }
+        
+        if (isSingleStone && liberties == 1) {
+            const ChessPiece& captured = lastMove.capturedPieces.front();
+            m_currentKo = KoPoint(captured.row, captured.col, captured.color, m_moveCount);
+            emit koOccurred(captured.row, captured.col);
+            return;
+        }
     }
     
     // 清除当前劫
@@ -472,6 +661,8 @@ void ChessLogic::calculateScore()
 {
     if (m_gameMode != GameMode::Go) return;
     
+    RULES_STATS_SCOPE(ChessLogicEngine, Scoring);
+    
     // 中国规则：子+目=总子数
     m_blackScore = 0;
     m_whiteScore = m_settings.komi; // 贴目
@@ -518,6 +709,7 @@ void ChessLogic::countTerritory()
                 bool touchesBlack = false, touchesWhite = false;
                 
                 findTerritory(i, j, visited, territory, touchesBlack, touchesWhite);
+                RULES_STATS_SAMPLE(ChessLogicEngine, FloodFill, territory.size());
                 
                 // 只有被一种颜色包围的空点才算作该方的领地
                 if (touchesBlack && !touchesWhite) {
@@ -535,13 +727,16 @@ void ChessLogic::findTerritory(int row, int col, bool visited[][BOARD_SIZE],
                               std::vector<std::pair<int, int>>& territory,
                               bool& touchesBlack, bool& touchesWhite)
 {
-    if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE || visited[row][col]) {
+    if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE) {
         return;
     }
     
-    visited[row][col] = true;
-    
     if (m_board[row][col] == PieceColor::Empty) {
+        // 只标记空点，边界上的棋子可能同时与多块空区域相邻
+        if (visited[row][col]) {
+            return;
+        }
+        visited[row][col] = true;
         territory.push_back({row, col});
         
         // 检查四个方向
@@ -629,6 +824,9 @@ int ChessLogic::getByoYomiPeriods(PieceColor color) const
 void ChessLogic::markDeadStones()
 {
     // 简化的死子标记：移除无法做出两眼的棋块
+    // 死活搜索用的GoBoard用setup一次摆好，只在提掉死子后重摆，不必每块重建
+    GoBoard board(BOARD_SIZE);
+    bool stale = true;
     bool processed[BOARD_SIZE][BOARD_SIZE] = {false};
     
     for (int i = 0; i < BOARD_SIZE; ++i) {
@@ -643,8 +841,22 @@ void ChessLogic::markDeadStones()
                     processed[pos.first][pos.second] = true;
                 }
                 
+                if (stale) {
+                    std::vector<int> black, white;
+                    for (int r = 0; r < BOARD_SIZE; ++r) {
+                        for (int c = 0; c < BOARD_SIZE; ++c) {
+                            if (m_board[r][c] == PieceColor::Black) black.push_back(board.point(r, c));
+                            if (m_board[r][c] == PieceColor::White) white.push_back(board.point(r, c));
+                        }
+                    }
+                    board.reset();
+                    board.setup(black, white, m_currentPlayer);
+                    stale = false;
+                }
+                
                 // 如果棋块是死的，从棋盘上移除
-                if (!isGroupAlive(group[0].first, group[0].second, color)) {
+                if (!isGroupAlive(board, group[0].first, group[0].second, color)) {
+                    stale = true;
                     for (auto& pos : group) {
                         m_board[pos.first][pos.second] = PieceColor::Empty;
                         // 增加对方的提子数
@@ -660,9 +872,19 @@ void ChessLogic::markDeadStones()
     }
 }
 
-bool ChessLogic::isGroupAlive(int row, int col, PieceColor color)
+bool ChessLogic::isGroupAlive(const GoBoard& board, int row, int col, PieceColor color)
 {
-    // 简化的活棋判断：检查是否有两个眼
+    // 被围住的小块用死活搜索精确判断（对方先走能否杀掉），区域太大或搜不完时退回数眼
+    const int MAX_REGION = 24;
+    int target = board.point(row, col);
+    std::vector<int> region;
+    if (TsumegoSolver::enclosedRegion(board, target, MAX_REGION, region)) {
+        PieceColor attacker = (color == PieceColor::Black) ? PieceColor::White : PieceColor::Black;
+        TsumegoSolver::Result result = m_tsumego.solve(board, target, region, attacker);
+        if (result.status == TsumegoSolver::Status::Dead) return false;
+        if (result.status != TsumegoSolver::Status::Unknown) return true; // 活棋和劫都不提
+    }
+    
     return hasTwoEyes(row, col, color);
 }
 
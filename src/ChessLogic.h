@@ -8,6 +8,12 @@
 #include <vector>
 #include <stack>
 #include "ChessPiece.h"
+#include "TsumegoSolver.h"
+#include "GameTree.h"
+#include "GoBatch.h"
+#include "GoBoard.h"
+#include "GomokuBoard.h"
+#include "KInARow.h"
 
 class ChessLogic : public QObject {
     Q_OBJECT
@@ -17,20 +23,37 @@ public:
 
     void handleClick(int row, int col);
     bool isValidMove(int row, int col) const;
+    // 轮到的一方全部合法着点，按row * BOARD_SIZE + col编号；围棋从m_goTree的棋盘一次算出，不必逐点调isValidMove
+    BoardBitset legalMoves() const;
     void placePiece(int row, int col);
     PieceColor getCurrentPlayer() const { return m_currentPlayer; }
     PieceColor getPieceAt(int row, int col) const;
     int getCapturedBlack() const { return m_capturedBlack; }
     int getCapturedWhite() const { return m_capturedWhite; }
+    const std::vector<Move>& getMoveHistory() const { return m_moveHistory; }
+    const GoBoard& getGoBoard() const { return m_goTree.board(); } // 围棋模式下与棋盘同步
+    const GameTree& getGameTree() const { return m_goTree; }
+    // 围棋：从当前局面用GoBatchPlayout并行下games局随机对局，得出黑胜率、平均目差和每点归属（按m_settings的贴目）
+    // threads为0时用所有核；不是围棋模式时返回空结果
+    BatchPlayoutStats batchPlayouts(long long games, int threads = 0) const;
     
     void setGameMode(GameMode mode);
     void resetGame();
     
+    // 摆子：一次放上一批棋子（让子、题目局面、SGF的AB/AW），不算着手也不提子，toPlay接着下
+    // 围棋只重建一次棋块和哈希，整批只发一次boardUpdated；只能在还没有着手时摆（围棋、五子棋）
+    // 有点越界、重复、已有子或摆出无气的棋块时整批不改，返回false
+    bool setupStones(const std::vector<ChessPiece>& stones, PieceColor toPlay);
+    // 围棋让子：按星位摆2-9颗黑子，白先
+    bool placeHandicap(int stones);
+    
     // 新增功能
     void pass(); // 虚着
     void resign(); // 认输
     void undo(); // 悔棋
     bool canUndo() const;
+    void redo(); // 围棋重下悔掉的那一手；悔棋后下了别的着法时，原来的着法留在着法树里成为变化
+    bool canRedo() const;
     void requestDraw(); // 请求和棋
     
     // 劫相关
@@ -69,7 +92,12 @@ public:
 
 private:
     static const int BOARD_SIZE = 19; // 围棋使用19x19棋盘
+    static const int GOMOKU_SIZE = 15; // 五子棋使用15x15棋盘
     PieceColor m_board[BOARD_SIZE][BOARD_SIZE];
+    GameTree m_goTree; // 围棋模式下与m_board同步，整盘合法着点查询用光标处棋盘维护的空点表和气；悔棋只退光标
+    // 五子棋模式下与m_board同步，胜负和禁手查行型表；禁手判断试下后即撤销，const查询可直接用
+    mutable GomokuBoard m_gomokuBoard;
+    Connect6 m_connect6; // 六子棋模式下与m_board同步，管判胜和每回合落子数
     PieceColor m_currentPlayer;
     bool m_gameOver;
     GameMode m_gameMode;
@@ -96,6 +124,9 @@ private:
     // 设置
     GameSettings m_settings;
     
+    // 终局判死活：被围住的小块用局部死活搜索
+    TsumegoSolver m_tsumego;
+    
     // 计时
     int m_blackTime;
     int m_whiteTime;
@@ -115,6 +146,7 @@ private:
     void removeGroup(const std::vector<std::pair<int, int>>& group);
     bool isSuicide(int row, int col, PieceColor color);
     bool wouldBeSuicide(int row, int col, PieceColor color) const;
+    bool groupHasLibertyExcept(int row, int col, PieceColor color, int exceptRow, int exceptCol) const;
     
     // 劫相关方法
     void checkAndSetKo(int row, int col);
@@ -126,7 +158,7 @@ private:
                        std::vector<std::pair<int, int>>& territory,
                        bool& touchesBlack, bool& touchesWhite);
     void markDeadStones();
-    bool isGroupAlive(int row, int col, PieceColor color);
+    bool isGroupAlive(const GoBoard& board, int row, int col, PieceColor color);
     bool hasTwoEyes(int row, int col, PieceColor color);
     bool isEye(int row, int col, PieceColor color);
     
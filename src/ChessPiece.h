@@ -15,7 +15,15 @@ enum class PieceColor {
 enum class GameMode {
     None,
     Go,
-    Gomoku
+    Gomoku,
+    Connect6 // 六子棋：19路，先手第一回合下一颗，之后每回合两颗，六连胜
+};
+
+// 五子棋规则：自由（五连及以上胜）、标准（恰好五连胜）、连珠（黑棋三三、四四、长连禁手）
+enum class GomokuRule {
+    Freestyle,
+    Standard,
+    Renju
 };
 
 enum class GameResult {
@@ -68,7 +76,10 @@ struct GameSettings {
     int mainTime; // 主时间（秒）
     int byoYomiTime; // 读秒时间（秒）
     int byoYomiPeriods; // 读秒次数
+    int hashSizeMb; // 搜索置换表大小（MB）
+    GomokuRule gomokuRule; // 五子棋规则
     
     GameSettings() 
-        : komi(6.5), mainTime(1800), byoYomiTime(30), byoYomiPeriods(3) {}
+        : komi(6.5), mainTime(1800), byoYomiTime(30), byoYomiPeriods(3), hashSizeMb(64),
+          gomokuRule(GomokuRule::Freestyle) {}
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <thread>
+
+// xoshiro256** 随机数生成器，比std::mt19937_64小而快，每个线程各用一个
+// 满足UniformRandomBitGenerator，可直接用于std::shuffle等
+class FastRng {
+public:
+    using result_type = uint64_t;
+
+    explicit FastRng(uint64_t seed = 0x853C49E6748FEA9BULL) { reseed(seed); }
+
+    void reseed(uint64_t seed)
+    {
+        // 用splitmix64展开种子，避免全零状态
+        for (auto& word : m_state) {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next()
+    {
+        uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    // [0, n) 内的均匀整数（Lemire乘法取高位，不用取模）
+    uint32_t below(uint32_t n) { return static_cast<uint32_t>(((next() >> 32) * n) >> 32); }
+    // [0, 1) 内的均匀浮点数
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    uint64_t operator()() { return next(); }
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+
+    // 本线程专用的生成器，首次使用时用随机设备和线程号播种
+    static FastRng& threadLocal()
+    {
+        thread_local FastRng rng(std::random_device{}() ^
+                                 (static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) << 32));
+        return rng;
+    }
+
+private:
+    uint64_t m_state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// 树状数组：单点修改、按前缀和抽样均为O(log n)，用于动态权重的随机选点
+class FenwickTree {
+public:
+    explicit FenwickTree(int size = 0) { resize(size); }
+
+    void resize(int size)
+    {
+        m_size = size;
+        m_tree.assign(size + 1, 0);
+        m_values.assign(size, 0);
+        m_total = 0;
+        m_highBit = 1;
+        while (m_highBit * 2 <= size) m_highBit *= 2;
+    }
+
+    void clear() { resize(m_size); }
+
+    int size() const { return m_size; }
+    int64_t total() const { return m_total; }
+    int value(int index) const { return m_values[index]; }
+
+    void set(int index, int value)
+    {
+        int delta = value - m_values[index];
+        if (delta == 0) return;
+        m_values[index] = value;
+        m_total += delta;
+        for (int i = index + 1; i <= m_size; i += i & -i) {
+            m_tree[i] += delta;
+        }
+    }
+
+    // 返回前缀和第一次超过target的下标，target需在[0, total)内
+    int find(int64_t target) const
+    {
+        int position = 0;
+        for (int step = m_highBit; step > 0; step >>= 1) {
+            int next = position + step;
+            if (next <= m_size && m_tree[next] <= target) {
+                position = next;
+                target -= m_tree[next];
+            }
+        }
+        return position;
+    }
+
+private:
+    int m_size;
+    int m_highBit;
+    int64_t m_total;
+    std::vector<int64_t> m_tree;
+    std::vector<int> m_values;
+};
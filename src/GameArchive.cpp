@@ -0,0 +1,369 @@
+// GameArchive.cpp
+#include "GameArchive.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "GameTree.h"
+
+namespace {
+
+const char BINARY_MAGIC[4] = {'G', 'O', 'G', 'A'};
+const uint32_t BINARY_VERSION = 1;
+
+class SgfParser {
+public:
+    SgfParser(const std::string& text, std::string* error, GameTree* tree = nullptr)
+        : m_text(text), m_pos(0), m_error(error), m_tree(tree), m_nodes(0) {}
+
+    bool parse(std::vector<GameRecord>& games)
+    {
+        while (skipSpace()) {
+            if (m_text[m_pos] != '(') return fail("expected '('");
+            GameRecord game;
+            if (!parseTree(game, true) || !finish(game)) return false;
+            games.push_back(std::move(game));
+        }
+        return true;
+    }
+
+    bool parseFirstTree()
+    {
+        m_tree->reset(GoBoard::MAX_SIZE);
+        if (!skipSpace() || m_text[m_pos] != '(') return fail("expected '('");
+        GameRecord game;
+        return parseTree(game, true);
+    }
+
+private:
+    const std::string& m_text;
+    size_t m_pos;
+    std::string* m_error;
+    GameTree* m_tree; // 非空时所有变化都落到树上
+    int m_nodes;
+
+    bool fail(const char* message)
+    {
+        if (m_error) *m_error = "offset " + std::to_string(m_pos) + ": " + message;
+        return false;
+    }
+
+    bool skipSpace()
+    {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+            m_pos++;
+        }
+        return m_pos < m_text.size();
+    }
+
+    // mainLine为false的变化只检查语法，不记录
+    bool parseTree(GameRecord& game, bool mainLine)
+    {
+        m_pos++; // '('
+        int start = m_tree ? m_tree->current() : 0;
+        bool firstChild = true;
+        while (skipSpace()) {
+            char c = m_text[m_pos];
+            if (c == ';') {
+                m_pos++;
+                if (!parseNode(game, mainLine || m_tree)) return false;
+                if (m_tree && ++m_nodes == 1 && !startTree(game)) return false;
+            } else if (c == '(') {
+                if (!parseTree(game, mainLine && firstChild)) return false;
+                firstChild = false;
+            } else if (c == ')') {
+                m_pos++;
+                // 变化读完回到分叉处
+                if (m_tree) m_tree->navigate(start);
+                return true;
+            } else {
+                return fail("unexpected character");
+            }
+        }
+        return fail("unterminated game tree");
+    }
+
+    bool parseNode(GameRecord& game, bool record)
+    {
+        while (skipSpace() && std::isalpha(static_cast<unsigned char>(m_text[m_pos]))) {
+            // 老格式的属性名夹有小写字母（AddBlack），只认大写部分
+            std::string name;
+            while (m_pos < m_text.size() && std::isalpha(static_cast<unsigned char>(m_text[m_pos]))) {
+                if (std::isupper(static_cast<unsigned char>(m_text[m_pos]))) name += m_text[m_pos];
+                m_pos++;
+            }
+            bool any = false;
+            std::string value;
+            while (skipSpace() && m_text[m_pos] == '[') {
+                if (!readValue(value)) return false;
+                if (record && !applyProperty(game, name, value)) return false;
+                any = true;
+            }
+            if (!any) return fail("property without value");
+        }
+        return true;
+    }
+
+    bool readValue(std::string& value)
+    {
+        value.clear();
+        m_pos++; // '['
+        while (m_pos < m_text.size()) {
+            char c = m_text[m_pos++];
+            if (c == ']') return true;
+            if (c == '\\' && m_pos < m_text.size()) c = m_text[m_pos++];
+            value += c;
+        }
+        return fail("unterminated property value");
+    }
+
+    // 着点先按字母原样存下（'t'即19），SZ可能在后面，读完整棵树后再检查范围
+    static bool readPoint(const std::string& value, size_t at, int& row, int& col)
+    {
+        if (at + 2 > value.size() || !std::islower(static_cast<unsigned char>(value[at])) ||
+            !std::islower(static_cast<unsigned char>(value[at + 1]))) return false;
+        col = value[at] - 'a';
+        row = value[at + 1] - 'a';
+        return true;
+    }
+
+    // 根节点读完后才知道棋盘大小和摆子，这时建树，根节点里的着法也在这时落下
+    bool startTree(GameRecord& game)
+    {
+        if (!finish(game)) return false;
+        if (game.size < 5 || game.size > GoBoard::MAX_SIZE) return fail("unsupported board size");
+        m_tree->reset(game.size);
+        PieceColor first = game.moves.empty() ? game.toPlay : game.moves.front().color;
+        if (!game.setup.empty() || first != PieceColor::Black) {
+            std::vector<int> black;
+            std::vector<int> white;
+            for (const ChessPiece& stone : game.setup) {
+                (stone.color == PieceColor::Black ? black : white).push_back(m_tree->board().point(stone.row, stone.col));
+            }
+            if (!m_tree->setup(black, white, first)) return fail("invalid setup");
+        }
+        for (const ChessPiece& move : game.moves) {
+            if (!playOnTree(move.row, move.col, move.color)) return false;
+        }
+        return true;
+    }
+
+    bool playOnTree(int row, int col, PieceColor color)
+    {
+        if (row == 19 && col == 19 && m_tree->size() <= 19) row = col = -1;
+        if (row >= m_tree->size() || col >= m_tree->size()) return fail("move outside the board");
+        int p = row < 0 ? GoBoard::PASS_MOVE : m_tree->board().point(row, col);
+        if (!m_tree->play(p, color)) return fail("illegal move");
+        return true;
+    }
+
+    bool applyProperty(GameRecord& game, const std::string& name, const std::string& value)
+    {
+        if (name == "B" || name == "W") {
+            PieceColor color = name == "B" ? PieceColor::Black : PieceColor::White;
+            int row = -1;
+            int col = -1;
+            if (!value.empty() && !readPoint(value, 0, row, col)) return fail("bad move");
+            if (m_tree && m_nodes > 0) return playOnTree(row, col, color);
+            game.moves.emplace_back(row, col, color);
+        } else if (m_tree && m_nodes > 0 && (name == "AB" || name == "AW" || name == "AE")) {
+            return fail("setup inside the game tree is not supported");
+        } else if (name == "AB" || name == "AW") {
+            PieceColor color = name == "AB" ? PieceColor::Black : PieceColor::White;
+            int row = 0;
+            int col = 0;
+            if (!readPoint(value, 0, row, col)) return fail("bad setup point");
+            int lastRow = row;
+            int lastCol = col;
+            // 压缩写法 "aa:cc" 表示一个矩形
+            if (value.size() > 2 && (value[2] != ':' || !readPoint(value, 3, lastRow, lastCol))) {
+                return fail("bad setup rectangle");
+            }
+            for (int r = std::min(row, lastRow); r <= std::max(row, lastRow); ++r) {
+                for (int c = std::min(col, lastCol); c <= std::max(col, lastCol); ++c) {
+                    game.setup.emplace_back(r, c, color);
+                }
+            }
+        } else if (name == "SZ") {
+            char* end = nullptr;
+            long size = std::strtol(value.c_str(), &end, 10);
+            if (*end == ':' && std::strtol(end + 1, nullptr, 10) != size) return fail("non-square board");
+            game.size = static_cast<int>(size);
+        } else if (name == "KM") {
+            game.komi = std::atof(value.c_str());
+        } else if (name == "PL") {
+            game.toPlay = !value.empty() && (value[0] == 'W' || value[0] == 'w') ? PieceColor::White : PieceColor::Black;
+        } else if (name == "RE") {
+            // B+R、W+3.5、0、Draw、Void、?
+            game.winner = PieceColor::Empty;
+            game.score = 0.0;
+            if (value.size() >= 2 && value[1] == '+' && (value[0] == 'B' || value[0] == 'W')) {
+                game.winner = value[0] == 'B' ? PieceColor::Black : PieceColor::White;
+                char* end = nullptr;
+                double margin = std::strtod(value.c_str() + 2, &end);
+                if (end != value.c_str() + 2 && std::isfinite(margin)) {
+                    game.score = game.winner == PieceColor::Black ? margin : -margin;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool finish(GameRecord& game)
+    {
+        if (game.size < 2 || game.size > 25) return fail("unsupported board size");
+        for (ChessPiece& move : game.moves) {
+            // 19路以内"tt"也表示虚着
+            if (move.row == 19 && move.col == 19 && game.size <= 19) move.row = move.col = -1;
+            if (move.row >= game.size || move.col >= game.size) return fail("move outside the board");
+        }
+        for (const ChessPiece& stone : game.setup) {
+            if (stone.row >= game.size || stone.col >= game.size) return fail("setup stone outside the board");
+        }
+        return true;
+    }
+};
+
+bool writeBytes(FILE* file, const void* data, size_t size)
+{
+    return std::fwrite(data, 1, size, file) == size;
+}
+
+// 按小端写，不依赖本机字节序
+bool writeInt(FILE* file, uint32_t value, int bytes)
+{
+    unsigned char buffer[4];
+    for (int i = 0; i < bytes; ++i) {
+        buffer[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    return writeBytes(file, buffer, bytes);
+}
+
+bool readInt(FILE* file, uint32_t& value, int bytes)
+{
+    unsigned char buffer[4];
+    if (std::fread(buffer, 1, bytes, file) != static_cast<size_t>(bytes)) return false;
+    value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint32_t>(buffer[i]) << (8 * i);
+    }
+    return true;
+}
+
+uint16_t encodePoint(const ChessPiece& piece, int size)
+{
+    int index = piece.row < 0 ? GameArchive::PASS_CODE : piece.row * size + piece.col;
+    return static_cast<uint16_t>(static_cast<int>(piece.color) << 12 | index);
+}
+
+bool decodePoint(uint32_t code, int size, ChessPiece& piece)
+{
+    int color = static_cast<int>(code >> 12);
+    int index = static_cast<int>(code & 0xFFF);
+    if (color != 1 && color != 2) return false;
+    piece.color = static_cast<PieceColor>(color);
+    if (index == GameArchive::PASS_CODE) {
+        piece.row = piece.col = -1;
+        return true;
+    }
+    if (index >= size * size) return false;
+    piece.row = index / size;
+    piece.col = index % size;
+    return true;
+}
+
+} // namespace
+
+bool GameArchive::parseSgf(const std::string& text, std::vector<GameRecord>& games, std::string* error)
+{
+    SgfParser parser(text, error);
+    return parser.parse(games);
+}
+
+bool GameArchive::parseSgfTree(const std::string& text, GameTree& tree, std::string* error)
+{
+    SgfParser parser(text, error, &tree);
+    return parser.parseFirstTree();
+}
+
+bool GameArchive::writeHeader(FILE* file)
+{
+    return writeBytes(file, BINARY_MAGIC, sizeof(BINARY_MAGIC)) && writeInt(file, BINARY_VERSION, 4);
+}
+
+bool GameArchive::writeGame(FILE* file, const GameRecord& game)
+{
+    if (game.size < 2 || game.size > 25 || game.setup.size() > 0xFFFF || game.moves.size() > 0xFFFF) return false;
+    bool ok = writeInt(file, static_cast<uint32_t>(game.size), 1) &&
+              writeInt(file, static_cast<uint32_t>(game.winner), 1) &&
+              writeInt(file, static_cast<uint32_t>(static_cast<int32_t>(std::lround(game.komi * 2))), 2) &&
+              writeInt(file, static_cast<uint32_t>(static_cast<int32_t>(std::lround(game.score * 2))), 4) &&
+              writeInt(file, static_cast<uint32_t>(game.setup.size()), 2) &&
+              writeInt(file, static_cast<uint32_t>(game.moves.size()), 2);
+    // 第一手由谁下不单独存：有着法时看第一手，没有时用不着
+    for (size_t i = 0; ok && i < game.setup.size(); ++i) {
+        ok = writeInt(file, encodePoint(game.setup[i], game.size), 2);
+    }
+    for (size_t i = 0; ok && i < game.moves.size(); ++i) {
+        ok = writeInt(file, encodePoint(game.moves[i], game.size), 2);
+    }
+    return ok;
+}
+
+bool GameArchive::readHeader(FILE* file)
+{
+    char magic[sizeof(BINARY_MAGIC)];
+    uint32_t version = 0;
+    return std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+           !std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) && readInt(file, version, 4) && version == BINARY_VERSION;
+}
+
+bool GameArchive::readGame(FILE* file, GameRecord& game, std::string* error)
+{
+    if (error) error->clear();
+    uint32_t size = 0;
+    if (!readInt(file, size, 1)) return false; // 文件末尾
+    uint32_t winner = 0;
+    uint32_t komi = 0;
+    uint32_t score = 0;
+    uint32_t setupCount = 0;
+    uint32_t moveCount = 0;
+    if (!readInt(file, winner, 1) || !readInt(file, komi, 2) || !readInt(file, score, 4) ||
+        !readInt(file, setupCount, 2) || !readInt(file, moveCount, 2)) {
+        if (error) *error = "truncated game header";
+        return false;
+    }
+    if (size < 2 || size > 25 || winner > 2) {
+        if (error) *error = "bad game header";
+        return false;
+    }
+    game = GameRecord();
+    game.size = static_cast<int>(size);
+    game.winner = static_cast<PieceColor>(winner);
+    game.komi = static_cast<int16_t>(komi) / 2.0;
+    game.score = static_cast<int32_t>(score) / 2.0;
+    game.setup.resize(setupCount);
+    game.moves.resize(moveCount);
+    for (uint32_t i = 0; i < setupCount + moveCount; ++i) {
+        uint32_t code = 0;
+        ChessPiece& piece = i < setupCount ? game.setup[i] : game.moves[i - setupCount];
+        if (!readInt(file, code, 2) || !decodePoint(code, game.size, piece)) {
+            if (error) *error = "bad point in game record";
+            return false;
+        }
+    }
+    if (!game.moves.empty()) game.toPlay = game.moves.front().color;
+    return true;
+}
+
+bool GameArchive::isBinary(const std::string& path)
+{
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    char magic[sizeof(BINARY_MAGIC)];
+    bool binary = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                  !std::memcmp(magic, BINARY_MAGIC, sizeof(magic));
+    std::fclose(file);
+    return binary;
+}
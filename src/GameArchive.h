@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "ChessPiece.h"
+
+class GameTree;
+
+// 一盘围棋的主线棋谱，SGF和二进制棋谱读出来都是这个
+struct GameRecord {
+    int size = 19;
+    double komi = 7.5;
+    PieceColor winner = PieceColor::Empty; // 和棋、无胜负或不明时为Empty
+    double score = 0.0;                    // 黑减白的目数（已扣贴目），中盘胜等不明时为0
+    std::vector<ChessPiece> setup;         // AB/AW摆的子（含让子）
+    PieceColor toPlay = PieceColor::Black; // 第一手由谁下
+    std::vector<ChessPiece> moves;         // row为-1表示虚着
+};
+
+// 棋谱读写
+// SGF：一个文件可以有多棵棋局树，只取每棵树的主线（每个分支的第一个变化）
+// 二进制棋谱（小端）：8字节头 "GOGA", version=1；之后逐盘
+//   uint8 size, int8 winner(0/1/2), int16 komi*2, int32 score*2, uint16 setupCount, uint16 moveCount
+//   再依次是setupCount个和moveCount个uint16着点：颜色<<12 | (row * size + col)，虚着为0xFFF
+class GameArchive {
+public:
+    static const uint16_t PASS_CODE = 0xFFF;
+
+    // 解析text中的所有棋局，追加到games；出错时error写入位置和原因，出错前已完整读出的棋局保留
+    static bool parseSgf(const std::string& text, std::vector<GameRecord>& games, std::string* error = nullptr);
+    // 把第一盘棋连同所有变化读进tree（先清空），光标停在根上；变化中间的摆子不支持
+    static bool parseSgfTree(const std::string& text, GameTree& tree, std::string* error = nullptr);
+
+    // 二进制棋谱按盘流式读写，整个文件不必同时放在内存里
+    static bool writeHeader(FILE* file);
+    static bool writeGame(FILE* file, const GameRecord& game);
+    static bool readHeader(FILE* file);
+    // 读到文件末尾时返回false且error为空
+    static bool readGame(FILE* file, GameRecord& game, std::string* error = nullptr);
+
+    // 文件以"GOGA"开头时为二进制棋谱
+    static bool isBinary(const std::string& path);
+};
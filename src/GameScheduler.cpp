@@ -0,0 +1,298 @@
+// GameScheduler.cpp
+#include "GameScheduler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+const int TIMER_CHECK_INTERVAL = 16;   // 忙时每执行这么多个任务看一次定时堆
+const int64_t MAX_IDLE_US = 10000;     // 空闲线程最多睡这么久就醒来看一眼
+
+thread_local const GameScheduler* t_scheduler = nullptr;
+thread_local int t_worker = -1;
+
+} // namespace
+
+GameScheduler::GameScheduler(int threads)
+    : m_quit(false)
+    , m_live(0)
+    , m_nextWorker(0)
+    , m_epoch(0)
+    , m_sleepers(0)
+    , m_registry(nullptr)
+{
+    threads = std::max(threads, 1);
+    for (int i = 0; i < threads; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < threads; ++i) {
+        m_workers[i]->thread = std::thread(&GameScheduler::run, this, i);
+    }
+}
+
+GameScheduler::~GameScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_quit.store(true);
+    }
+    m_idle.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    // 还没结束的任务（排队的、挂起的）一并删除
+    while (m_registry) {
+        GameTask* task = m_registry;
+        m_registry = task->m_next;
+        delete task;
+    }
+}
+
+int64_t GameScheduler::nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int GameScheduler::callerWorker() const
+{
+    return t_scheduler == this ? t_worker : -1;
+}
+
+void GameScheduler::spawn(std::unique_ptr<GameTask> task)
+{
+    GameTask* raw = task.release();
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        raw->m_next = m_registry;
+        if (m_registry) m_registry->m_prev = raw;
+        m_registry = raw;
+    }
+    m_live.fetch_add(1);
+    raw->m_state.store(GameTask::Queued);
+    int worker = callerWorker();
+    push(worker >= 0 ? worker : static_cast<int>(m_nextWorker.fetch_add(1) % m_workers.size()), raw);
+}
+
+void GameScheduler::wake(GameTask* task)
+{
+    int state = task->m_state.load();
+    while (true) {
+        if (state == GameTask::Parked) {
+            if (task->m_state.compare_exchange_weak(state, GameTask::Queued)) {
+                int worker = callerWorker();
+                push(worker >= 0 ? worker : static_cast<int>(m_nextWorker.fetch_add(1) % m_workers.size()), task);
+                return;
+            }
+        } else if (state == GameTask::Running) {
+            // 正在运行：留个记号，它挂起时发现后直接重新排队
+            if (task->m_state.compare_exchange_weak(state, GameTask::Notified)) return;
+        } else if (state == GameTask::TimedOut) {
+            // 到点排上了队但还没运行，回复赶上了，就不算超时
+            if (task->m_state.compare_exchange_weak(state, GameTask::Queued)) return;
+        } else {
+            return; // 已在队列中或已被通知过
+        }
+    }
+}
+
+void GameScheduler::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_doneMutex);
+    m_allDone.wait(lock, [this] { return m_live.load() == 0; });
+}
+
+long long GameScheduler::resumes() const
+{
+    long long total = 0;
+    for (const auto& worker : m_workers) {
+        total += worker->resumes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+long long GameScheduler::steals() const
+{
+    long long total = 0;
+    for (const auto& worker : m_workers) {
+        total += worker->steals.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void GameScheduler::push(int index, GameTask* task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->queue.push_back(task);
+    }
+    m_epoch.fetch_add(1);
+    if (m_sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_idle.notify_one();
+    }
+}
+
+GameTask* GameScheduler::popLocal(int index)
+{
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.queue.empty()) return nullptr;
+    GameTask* task = worker.queue.front();
+    worker.queue.pop_front();
+    return task;
+}
+
+GameTask* GameScheduler::steal(int index)
+{
+    // 从别的线程队列尾部拿走一半，拿的时候只锁对方，放进自己队列时只锁自己
+    std::vector<GameTask*> taken;
+    int count = static_cast<int>(m_workers.size());
+    for (int k = 1; k < count && taken.empty(); ++k) {
+        Worker& victim = *m_workers[(index + k) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        size_t half = (victim.queue.size() + 1) / 2;
+        for (size_t i = 0; i < half; ++i) {
+            taken.push_back(victim.queue.back());
+            victim.queue.pop_back();
+        }
+    }
+    if (taken.empty()) return nullptr;
+    Worker& self = *m_workers[index];
+    self.steals.fetch_add(1, std::memory_order_relaxed);
+    GameTask* task = taken.back();
+    taken.pop_back();
+    if (!taken.empty()) {
+        std::lock_guard<std::mutex> lock(self.mutex);
+        self.queue.insert(self.queue.end(), taken.rbegin(), taken.rend());
+    }
+    return task;
+}
+
+int64_t GameScheduler::fireTimers(int index, int64_t now)
+{
+    Worker& worker = *m_workers[index];
+    std::vector<Timer> due;
+    int64_t next = -1;
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        while (!worker.timers.empty() && worker.timers.front().deadlineUs <= now) {
+            std::pop_heap(worker.timers.begin(), worker.timers.end());
+            due.push_back(worker.timers.back());
+            worker.timers.pop_back();
+        }
+        if (!worker.timers.empty()) next = worker.timers.front().deadlineUs;
+    }
+    for (const Timer& timer : due) {
+        GameTask* task = timer.task;
+        // 挂起后已被wake过（代数变了）或者正在队列里的，都是过期项
+        int parked = GameTask::Parked;
+        if (task->m_generation.load() == timer.generation &&
+            task->m_state.compare_exchange_strong(parked, GameTask::TimedOut)) {
+            push(index, task);
+        }
+        release(task);
+    }
+    return next;
+}
+
+void GameScheduler::execute(int index, GameTask* task)
+{
+    Worker& worker = *m_workers[index];
+    bool timedOut = task->m_state.exchange(GameTask::Running) == GameTask::TimedOut;
+    TaskStep step = task->resume(*this, index, timedOut);
+    worker.resumes.fetch_add(1, std::memory_order_relaxed);
+
+    switch (step.kind) {
+    case TaskStep::Yield:
+        task->m_state.store(GameTask::Queued);
+        push(index, task);
+        break;
+    case TaskStep::Done:
+        finish(task);
+        break;
+    case TaskStep::Wait: {
+        uint32_t generation = task->m_generation.fetch_add(1) + 1;
+        if (step.deadlineUs >= 0) {
+            // 定时项只由本线程出堆，挂起之前放进去不会提前触发
+            task->m_refs.fetch_add(1);
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.timers.push_back({step.deadlineUs, task, generation});
+            std::push_heap(worker.timers.begin(), worker.timers.end());
+        }
+        int running = GameTask::Running;
+        if (!task->m_state.compare_exchange_strong(running, GameTask::Parked)) {
+            // 运行期间被wake过，不挂起
+            task->m_generation.fetch_add(1);
+            task->m_state.store(GameTask::Queued);
+            push(index, task);
+        }
+        break;
+    }
+    }
+}
+
+void GameScheduler::finish(GameTask* task)
+{
+    release(task);
+    if (m_live.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(m_doneMutex);
+        m_allDone.notify_all();
+    }
+}
+
+void GameScheduler::release(GameTask* task)
+{
+    if (task->m_refs.fetch_sub(1) != 1) return;
+    {
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        if (task->m_prev) task->m_prev->m_next = task->m_next;
+        else m_registry = task->m_next;
+        if (task->m_next) task->m_next->m_prev = task->m_prev;
+    }
+    delete task;
+}
+
+void GameScheduler::run(int index)
+{
+    t_scheduler = this;
+    t_worker = index;
+    int sinceTimers = 0;
+    int64_t nextTimer = -1;
+    while (!m_quit.load()) {
+        if (++sinceTimers >= TIMER_CHECK_INTERVAL) {
+            sinceTimers = 0;
+            nextTimer = fireTimers(index, nowUs());
+        }
+        GameTask* task = popLocal(index);
+        if (!task) {
+            nextTimer = fireTimers(index, nowUs());
+            task = popLocal(index);
+        }
+        if (!task) task = steal(index);
+        if (task) {
+            execute(index, task);
+            continue;
+        }
+
+        // 没活干：先登记为睡眠者再看一次队列，之后的入队一定会改m_epoch或者叫醒我们
+        m_sleepers.fetch_add(1);
+        uint64_t seen = m_epoch.load();
+        task = steal(index);
+        if (task) {
+            m_sleepers.fetch_sub(1);
+            execute(index, task);
+            continue;
+        }
+        int64_t now = nowUs();
+        int64_t until = nextTimer < 0 ? now + MAX_IDLE_US : std::min(nextTimer, now + MAX_IDLE_US);
+        {
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            m_idle.wait_until(lock,
+                              std::chrono::steady_clock::time_point(std::chrono::microseconds(until)),
+                              [&] { return m_quit.load() || m_epoch.load() != seen; });
+        }
+        m_sleepers.fetch_sub(1);
+        sinceTimers = TIMER_CHECK_INTERVAL;
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class GameScheduler;
+
+// 一次resume之后任务的去向
+struct TaskStep {
+    enum Kind { Yield, Wait, Done };
+
+    Kind kind;
+    int64_t deadlineUs; // Wait时的超时时刻（GameScheduler::nowUs），-1表示只等wake
+
+    static TaskStep yield() { return {Yield, -1}; }
+    static TaskStep wait(int64_t deadlineUs = -1) { return {Wait, deadlineUs}; }
+    static TaskStep sleepUntil(int64_t deadlineUs) { return {Wait, deadlineUs}; }
+    static TaskStep done() { return {Done, -1}; }
+};
+
+// 可挂起的对局任务
+// C++17没有协程，对局写成状态机：每次resume推进到下一个等待点（等对方着手、等读秒到点）就返回，
+// 不占栈，一个任务只有对象本身那么大
+class GameTask {
+public:
+    GameTask() = default;
+    virtual ~GameTask() = default;
+    GameTask(const GameTask&) = delete;
+    GameTask& operator=(const GameTask&) = delete;
+
+    // worker为执行线程号（0..threads-1），可用来取线程私有的资源
+    // timedOut为true表示上次Wait是到点醒来的，而不是被wake
+    virtual TaskStep resume(GameScheduler& scheduler, int worker, bool timedOut) = 0;
+
+private:
+    friend class GameScheduler;
+    // TimedOut与Queued一样在队列里，只是表示它是到点醒来的；排队期间被wake就改回Queued
+    enum State { Queued, TimedOut, Running, Notified, Parked };
+
+    std::atomic<int> m_state{Queued};
+    std::atomic<uint32_t> m_generation{0}; // 每次挂起加一，过期的定时项据此丢弃
+    std::atomic<int> m_refs{1};            // 存活本身一份，每个未出堆的定时项一份，归零时删除
+    GameTask* m_prev = nullptr; // 全部存活任务的侵入式链表，析构时回收
+    GameTask* m_next = nullptr;
+};
+
+// 把大量对局多路复用到少量线程上的调度器
+// 每个线程一条运行队列和一个定时堆；队列空时从其他线程的队列尾部偷一半过来
+// 任务由调度器持有，resume返回Done后删除；wake可以在任何线程调用，但任务必须还没结束
+class GameScheduler {
+public:
+    explicit GameScheduler(int threads);
+    ~GameScheduler();
+    GameScheduler(const GameScheduler&) = delete;
+    GameScheduler& operator=(const GameScheduler&) = delete;
+
+    static int64_t nowUs();
+
+    // 在工作线程里调用时放进本线程的队列，否则轮流分给各线程
+    void spawn(std::unique_ptr<GameTask> task);
+    // 唤醒Wait中的任务；任务正在运行时，它这次返回Wait后立即重新排队
+    void wake(GameTask* task);
+    // 阻塞到所有任务都结束
+    void waitIdle();
+
+    int threads() const { return static_cast<int>(m_workers.size()); }
+    long long liveTasks() const { return m_live.load(std::memory_order_relaxed); }
+    long long resumes() const;
+    long long steals() const;
+
+private:
+    struct Timer {
+        int64_t deadlineUs;
+        GameTask* task;
+        uint32_t generation;
+
+        bool operator<(const Timer& other) const { return deadlineUs > other.deadlineUs; } // 小顶堆
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<GameTask*> queue;
+        std::vector<Timer> timers;
+        std::atomic<long long> resumes{0};
+        std::atomic<long long> steals{0};
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool> m_quit;
+    std::atomic<long long> m_live;
+    std::atomic<unsigned> m_nextWorker;
+
+    // 空闲线程在这里睡；m_epoch每次入队加一，用来发现睡前错过的入队
+    std::mutex m_idleMutex;
+    std::condition_variable m_idle;
+    std::atomic<uint64_t> m_epoch;
+    std::atomic<int> m_sleepers;
+
+    std::mutex m_doneMutex;
+    std::condition_variable m_allDone;
+
+    std::mutex m_registryMutex;
+    GameTask* m_registry;
+
+    void run(int index);
+    void push(int index, GameTask* task);
+    GameTask* popLocal(int index);
+    GameTask* steal(int index);
+    // 把本线程到点的定时项放回队列，返回最早的未到期时刻（没有时为-1）
+    int64_t fireTimers(int index, int64_t now);
+    void execute(int index, GameTask* task);
+    void finish(GameTask* task);
+    void release(GameTask* task);
+    int callerWorker() const;
+};
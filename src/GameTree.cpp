@@ -0,0 +1,211 @@
+// GameTree.cpp
+#include "GameTree.h"
+
+GameTree::GameTree(int size)
+    : m_board(size)
+    , m_current(ROOT)
+    , m_freeList(NO_NODE)
+    , m_freeCount(0)
+{
+    reset(size);
+}
+
+void GameTree::reset(int size)
+{
+    if (size != m_board.size()) {
+        m_board = GoBoard(size);
+    } else {
+        m_board.reset();
+    }
+    m_rootBoard = m_board;
+    m_nodes.clear();
+    m_nodes.push_back(Node{NO_NODE, NO_NODE, NO_NODE, NO_NODE, 0, GoBoard::NO_POINT, 0, 1});
+    m_current = ROOT;
+    m_freeList = NO_NODE;
+    m_freeCount = 0;
+}
+
+bool GameTree::setup(const std::vector<int>& black, const std::vector<int>& white, PieceColor toPlay)
+{
+    if (m_current != ROOT || m_nodes[ROOT].firstChild != NO_NODE) return false;
+    if (!m_board.setup(black, white, toPlay)) return false;
+    m_rootBoard = m_board;
+    return true;
+}
+
+int GameTree::allocate(int parent, int move, PieceColor color)
+{
+    Node node{parent, NO_NODE, NO_NODE, NO_NODE, m_nodes[parent].depth + 1,
+              static_cast<int16_t>(move), static_cast<uint8_t>(color), 1};
+    int index;
+    if (m_freeList != NO_NODE) {
+        index = m_freeList;
+        m_freeList = m_nodes[index].nextSibling;
+        m_freeCount--;
+        m_nodes[index] = node;
+    } else {
+        index = static_cast<int>(m_nodes.size());
+        m_nodes.push_back(node);
+    }
+    // 新变化接在最后，第一个子节点始终是主线
+    int* link = &m_nodes[parent].firstChild;
+    while (*link != NO_NODE) {
+        link = &m_nodes[*link].nextSibling;
+    }
+    *link = index;
+    return index;
+}
+
+bool GameTree::play(int p, PieceColor color)
+{
+    for (int child = m_nodes[m_current].firstChild; child != NO_NODE; child = m_nodes[child].nextSibling) {
+        if (m_nodes[child].move == p && m_nodes[child].color == static_cast<uint8_t>(color)) {
+            m_board.play(p, color);
+            m_nodes[m_current].lastVisited = child;
+            m_current = child;
+            return true;
+        }
+    }
+    if (!m_board.play(p, color)) return false;
+    int child = allocate(m_current, p, color);
+    m_nodes[m_current].lastVisited = child;
+    m_current = child;
+    return true;
+}
+
+bool GameTree::back()
+{
+    if (m_current == ROOT) return false;
+    m_board.undo();
+    int parentNode = m_nodes[m_current].parent;
+    m_nodes[parentNode].lastVisited = m_current;
+    m_current = parentNode;
+    return true;
+}
+
+int GameTree::forwardChild() const
+{
+    const Node& node = m_nodes[m_current];
+    return node.lastVisited != NO_NODE ? node.lastVisited : node.firstChild;
+}
+
+bool GameTree::forward()
+{
+    int child = forwardChild();
+    if (child == NO_NODE) return false;
+    m_board.play(m_nodes[child].move, color(child));
+    m_current = child;
+    return true;
+}
+
+void GameTree::navigate(int node)
+{
+    if (!isValid(node)) return;
+    // 先不动棋盘，两边一起往上走到公共祖先，数出要撤销的手数
+    int from = m_current;
+    int ancestor = node;
+    int undos = 0;
+    while (from != ancestor) {
+        if (m_nodes[from].depth >= m_nodes[ancestor].depth) {
+            from = m_nodes[from].parent;
+            undos++;
+        } else {
+            ancestor = m_nodes[ancestor].parent;
+        }
+    }
+    // 两种走法从公共祖先往下的落子相同；从根重放多下祖先以上的几手再加一次复制棋盘，省掉全部撤销
+    if ((m_nodes[ancestor].depth + 2) * UNDOS_PER_PLAY < undos) {
+        // 换回根局面，撤销记录随之清空
+        m_board = m_rootBoard;
+        m_current = ROOT;
+        ancestor = ROOT;
+    } else {
+        while (m_current != ancestor) {
+            back();
+        }
+    }
+    m_path.clear();
+    for (int n = node; n != ancestor; n = m_nodes[n].parent) {
+        m_path.push_back(n);
+    }
+    for (size_t i = m_path.size(); i-- > 0;) {
+        int child = m_path[i];
+        m_board.play(m_nodes[child].move, color(child));
+        m_nodes[m_current].lastVisited = child;
+        m_current = child;
+    }
+}
+
+int GameTree::childCount(int node) const
+{
+    int count = 0;
+    for (int child = m_nodes[node].firstChild; child != NO_NODE; child = m_nodes[child].nextSibling) {
+        count++;
+    }
+    return count;
+}
+
+bool GameTree::isValid(int node) const
+{
+    return node >= 0 && node < static_cast<int>(m_nodes.size()) && m_nodes[node].live;
+}
+
+size_t GameTree::memoryBytes() const
+{
+    return sizeof(*this) + m_nodes.capacity() * sizeof(Node) + m_path.capacity() * sizeof(int);
+}
+
+void GameTree::release(int node)
+{
+    // 用显式栈，很长的变化也不会递归过深
+    m_path.clear();
+    m_path.push_back(node);
+    while (!m_path.empty()) {
+        int n = m_path.back();
+        m_path.pop_back();
+        for (int child = m_nodes[n].firstChild; child != NO_NODE; child = m_nodes[child].nextSibling) {
+            m_path.push_back(child);
+        }
+        m_nodes[n].live = 0;
+        m_nodes[n].nextSibling = m_freeList;
+        m_freeList = n;
+        m_freeCount++;
+    }
+}
+
+bool GameTree::removeVariation(int node)
+{
+    if (!isValid(node) || node == ROOT) return false;
+    // 光标在这个子树里时先退出来
+    for (int n = m_current; n != NO_NODE; n = m_nodes[n].parent) {
+        if (n == node) {
+            navigate(m_nodes[node].parent);
+            break;
+        }
+    }
+    int parentNode = m_nodes[node].parent;
+    int* link = &m_nodes[parentNode].firstChild;
+    while (*link != node) {
+        link = &m_nodes[*link].nextSibling;
+    }
+    *link = m_nodes[node].nextSibling;
+    if (m_nodes[parentNode].lastVisited == node) m_nodes[parentNode].lastVisited = NO_NODE;
+    release(node);
+    return true;
+}
+
+void GameTree::promoteToMainLine(int node)
+{
+    if (!isValid(node)) return;
+    for (int n = node; n != ROOT; n = m_nodes[n].parent) {
+        int parentNode = m_nodes[n].parent;
+        if (m_nodes[parentNode].firstChild == n) continue;
+        int* link = &m_nodes[parentNode].firstChild;
+        while (*link != n) {
+            link = &m_nodes[*link].nextSibling;
+        }
+        *link = m_nodes[n].nextSibling;
+        m_nodes[n].nextSibling = m_nodes[parentNode].firstChild;
+        m_nodes[parentNode].firstChild = n;
+    }
+}
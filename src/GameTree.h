@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "GoBoard.h"
+
+// 带变化的围棋着法树：SGF的分支、分析时试下的变化、悔棋后还能重做
+// 节点放在一个池里（24字节、按下标相连），删掉的子树回收到空闲链表；节点不存局面
+// 局面只有一份：根局面（摆子、让子）作为检查点，光标所在路径上每一手的改动由GoBoard的撤销记录保存
+// 在两个节点间跳转时先撤销到公共祖先、再沿目标路径落子，代价与两条路径的差成正比；
+// 要撤销的手数多到比从根多下的几手还费时时，改从根局面的副本重放
+class GameTree {
+public:
+    static const int NO_NODE = -1;
+    static const int ROOT = 0;
+    // 撤销只是回写改动记录，一手落子的时间大约够撤销这么多手；navigate按它选走法
+    static const int UNDOS_PER_PLAY = 8;
+
+    explicit GameTree(int size = GoBoard::MAX_SIZE);
+
+    // 清空成只有根节点的空棋盘
+    void reset(int size);
+    // 把根局面换成摆好的棋子，同GoBoard::setup；只能在根下还没有着法时调用
+    bool setup(const std::vector<int>& black, const std::vector<int>& white, PieceColor toPlay);
+
+    int size() const { return m_board.size(); }
+    const GoBoard& board() const { return m_board; } // 光标处的局面
+    int current() const { return m_current; }
+
+    // 在光标处下一手（GoBoard点号，可为PASS_MOVE），已有同样的子节点时直接走进去，否则新开一个变化
+    // 非法着法返回false，光标不动
+    bool play(int p, PieceColor color);
+    // 退回父节点，子节点保留，之后可forward回来
+    bool back();
+    // 走进上次从这里走过的子节点（没有时为第一个子节点），即重做
+    bool forward();
+    int forwardChild() const;
+    // 跳到任意节点
+    void navigate(int node);
+
+    // 删掉node及其所有后代（不能删根），光标在其中时退到node的父节点；节点号之后可能被复用
+    bool removeVariation(int node);
+    // 把node所在的变化在每一层都调到第一个，成为主线
+    void promoteToMainLine(int node);
+
+    // 节点查询
+    int parent(int node) const { return m_nodes[node].parent; }
+    int firstChild(int node) const { return m_nodes[node].firstChild; }
+    int nextSibling(int node) const { return m_nodes[node].nextSibling; }
+    int childCount(int node) const;
+    int move(int node) const { return m_nodes[node].move; }     // 根节点为NO_POINT
+    PieceColor color(int node) const { return static_cast<PieceColor>(m_nodes[node].color); }
+    int depth(int node) const { return m_nodes[node].depth; }
+    bool isValid(int node) const;
+    int nodeCount() const { return static_cast<int>(m_nodes.size()) - m_freeCount; }
+    size_t memoryBytes() const;
+
+private:
+    struct Node {
+        int parent;
+        int firstChild;
+        int nextSibling;   // 空闲节点用它串成链表
+        int lastVisited;   // forward的去处
+        int depth;
+        int16_t move;
+        uint8_t color;
+        uint8_t live;
+    };
+
+    GoBoard m_board;
+    GoBoard m_rootBoard;     // 根局面的副本，撤销记录为空
+    std::vector<Node> m_nodes;
+    int m_current;
+    int m_freeList;
+    int m_freeCount;
+    std::vector<int> m_path; // navigate用的临时栈
+
+    int allocate(int parent, int move, PieceColor color);
+    void release(int node);
+};
@@ -0,0 +1,624 @@
+// GoBatch.cpp
+#include "GoBatch.h"
+#include "GoNetwork.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+// AVX2内核：与GoNetwork相同，GCC/Clang按函数开启目标指令集并在运行时检测，MSVC需以/arch:AVX2编译
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GO_BATCH_HAS_AVX2 1
+#define GO_BATCH_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#include <immintrin.h>
+#define GO_BATCH_HAS_AVX2 1
+#define GO_BATCH_AVX2_TARGET
+#endif
+
+namespace {
+
+const int LANES = GoBatchPlayout::LANES;
+
+int popcount(uint32_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcount(x);
+#else
+    int count = 0;
+    for (; x; x &= x - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+int lowestBit(uint32_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(x);
+#else
+    int bit = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// 行内沿mask向两侧填满（Kogge-Stone，移1、2、4、8、16位），g须是mask的子集
+inline uint32_t fillRow(uint32_t g, uint32_t mask)
+{
+    uint32_t left = g, right = g;
+    uint32_t leftPass = mask, rightPass = mask;
+    for (int shift = 1; shift < 32; shift <<= 1) {
+        left |= leftPass & (left << shift);
+        right |= rightPass & (right >> shift);
+        leftPass &= leftPass << shift;
+        rightPass &= rightPass >> shift;
+    }
+    return left | right;
+}
+
+uint32_t growRow(uint32_t (&group)[GoBoard::MAX_SIZE][LANES], const uint32_t (&mask)[GoBoard::MAX_SIZE][LANES],
+                 int r, int size)
+{
+    uint32_t changed = 0;
+    for (int lane = 0; lane < LANES; ++lane) {
+        uint32_t vertical = group[r][lane];
+        if (r > 0) vertical |= group[r - 1][lane];
+        if (r + 1 < size) vertical |= group[r + 1][lane];
+        uint32_t next = fillRow(vertical & mask[r][lane], mask[r][lane]);
+        if (next != group[r][lane]) changed |= 1u << lane;
+        group[r][lane] = next;
+    }
+    return changed;
+}
+
+void growScalar(uint32_t (&group)[GoBoard::MAX_SIZE][LANES], const uint32_t (&mask)[GoBoard::MAX_SIZE][LANES],
+                int size)
+{
+    // 行内一步填满，行间自上而下、自下而上原地扫描，直到各盘都不再变化
+    while (true) {
+        uint32_t changed = 0;
+        for (int r = 0; r < size; ++r) {
+            changed |= growRow(group, mask, r, size);
+        }
+        for (int r = size - 1; r >= 0; --r) {
+            changed |= growRow(group, mask, r, size);
+        }
+        if (!changed) return;
+    }
+}
+
+void dilateScalar(const uint32_t (&group)[GoBoard::MAX_SIZE][LANES], const uint32_t (&mask)[GoBoard::MAX_SIZE][LANES],
+                  uint32_t (&out)[GoBoard::MAX_SIZE][LANES], int size)
+{
+    for (int r = 0; r < size; ++r) {
+        for (int lane = 0; lane < LANES; ++lane) {
+            uint32_t g = group[r][lane];
+            uint32_t up = r > 0 ? group[r - 1][lane] : 0;
+            uint32_t down = r + 1 < size ? group[r + 1][lane] : 0;
+            out[r][lane] = (g | (g << 1) | (g >> 1) | up | down) & mask[r][lane];
+        }
+    }
+}
+
+#ifdef GO_BATCH_HAS_AVX2
+GO_BATCH_AVX2_TARGET
+inline __m256i loadRow(const uint32_t (&rows)[GoBoard::MAX_SIZE][LANES], int r)
+{
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(rows[r]));
+}
+
+GO_BATCH_AVX2_TARGET
+inline __m256i fillRowAvx2(__m256i g, __m256i mask)
+{
+    __m256i left = g, right = g;
+    __m256i leftPass = mask, rightPass = mask;
+    for (int shift = 1; shift < 32; shift <<= 1) {
+        __m128i count = _mm_cvtsi32_si128(shift);
+        left = _mm256_or_si256(left, _mm256_and_si256(leftPass, _mm256_sll_epi32(left, count)));
+        right = _mm256_or_si256(right, _mm256_and_si256(rightPass, _mm256_srl_epi32(right, count)));
+        leftPass = _mm256_and_si256(leftPass, _mm256_sll_epi32(leftPass, count));
+        rightPass = _mm256_and_si256(rightPass, _mm256_srl_epi32(rightPass, count));
+    }
+    return _mm256_or_si256(left, right);
+}
+
+GO_BATCH_AVX2_TARGET
+void growAvx2(uint32_t (&group)[GoBoard::MAX_SIZE][LANES], const uint32_t (&mask)[GoBoard::MAX_SIZE][LANES], int size)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    while (true) {
+        __m256i changed = zero;
+        __m256i above = zero;
+        for (int r = 0; r < size; ++r) {
+            __m256i g = loadRow(group, r);
+            __m256i m = loadRow(mask, r);
+            __m256i below = r + 1 < size ? loadRow(group, r + 1) : zero;
+            __m256i vertical = _mm256_and_si256(_mm256_or_si256(g, _mm256_or_si256(above, below)), m);
+            __m256i next = fillRowAvx2(vertical, m);
+            changed = _mm256_or_si256(changed, _mm256_xor_si256(next, g));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(group[r]), next);
+            above = next;
+        }
+        __m256i below = zero;
+        for (int r = size - 1; r >= 0; --r) {
+            __m256i g = loadRow(group, r);
+            __m256i m = loadRow(mask, r);
+            __m256i up = r > 0 ? loadRow(group, r - 1) : zero;
+            __m256i vertical = _mm256_and_si256(_mm256_or_si256(g, _mm256_or_si256(up, below)), m);
+            __m256i next = fillRowAvx2(vertical, m);
+            changed = _mm256_or_si256(changed, _mm256_xor_si256(next, g));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(group[r]), next);
+            below = next;
+        }
+        if (_mm256_testz_si256(changed, changed)) return;
+    }
+}
+
+GO_BATCH_AVX2_TARGET
+void dilateAvx2(const uint32_t (&group)[GoBoard::MAX_SIZE][LANES], const uint32_t (&mask)[GoBoard::MAX_SIZE][LANES],
+                uint32_t (&out)[GoBoard::MAX_SIZE][LANES], int size)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    for (int r = 0; r < size; ++r) {
+        __m256i g = loadRow(group, r);
+        __m256i up = r > 0 ? loadRow(group, r - 1) : zero;
+        __m256i down = r + 1 < size ? loadRow(group, r + 1) : zero;
+        __m256i horizontal = _mm256_or_si256(_mm256_slli_epi32(g, 1), _mm256_srli_epi32(g, 1));
+        __m256i next = _mm256_or_si256(_mm256_or_si256(g, horizontal), _mm256_or_si256(up, down));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out[r]), _mm256_and_si256(next, loadRow(mask, r)));
+    }
+}
+#endif
+
+int popcount64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    int count = 0;
+    for (; x; x &= x - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+} // namespace
+
+GoBatchPlayout::GoBatchPlayout(const GoBoard& start)
+    : m_size(start.size())
+    , m_stride(start.size() + 1)
+    , m_rowMask((1u << start.size()) - 1)
+    , m_komi(6.5)
+    , m_maxMoves(3 * GoBoard::MAX_SIZE * GoBoard::MAX_SIZE)
+    , m_boardMoves(0)
+    , m_lanes(LANES)
+    , m_pendingCount(0)
+{
+    m_dirs[0] = -m_stride;
+    m_dirs[1] = 1;
+    m_dirs[2] = m_stride;
+    m_dirs[3] = -1;
+
+    m_grow = [](Plane& group, const Plane& mask, int size) { growScalar(group.rows, mask.rows, size); };
+    m_dilate = [](const Plane& group, const Plane& mask, Plane& out, int size) {
+        dilateScalar(group.rows, mask.rows, out.rows, size);
+    };
+#ifdef GO_BATCH_HAS_AVX2
+    if (GoNetwork::hasAvx2()) {
+        m_grow = [](Plane& group, const Plane& mask, int size) { growAvx2(group.rows, mask.rows, size); };
+        m_dilate = [](const Plane& group, const Plane& mask, Plane& out, int size) {
+            dilateAvx2(group.rows, mask.rows, out.rows, size);
+        };
+    }
+#endif
+    std::memset(m_pending, 0, sizeof(m_pending));
+    for (int color = GoBoard::Black; color <= GoBoard::White; ++color) {
+        for (int code = 0; code < 256; ++code) {
+            bool eye = true;
+            bool empty = false;
+            for (int d = 0; d < 4; ++d) {
+                int cell = (code >> (2 * d)) & 3;
+                if (cell != color && cell != GoBoard::Border) eye = false;
+                if (cell == GoBoard::Empty) empty = true;
+            }
+            m_moveKind[color - 1][code] = eye ? OwnEye : (empty ? HasEmptyNeighbour : NeedsCheck);
+        }
+    }
+
+    // 起始局面：先摆子，再逐块求棋块和气
+    Lane& lane = m_start;
+    std::memset(&lane, 0, sizeof(lane));
+    for (int p = 0; p < MAX_POINTS; ++p) {
+        lane.cells[p] = GoBoard::Border;
+    }
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int p = point(row, col);
+            lane.cells[p] = GoBoard::Empty;
+            lane.emptyIndex[p] = static_cast<uint16_t>(lane.emptyCount);
+            lane.empties[lane.emptyCount++] = static_cast<uint16_t>(p);
+            int cell = start.cell(start.point(row, col));
+            if (cell == GoBoard::Black || cell == GoBoard::White) setStone(lane, p, cell);
+        }
+    }
+    for (int p = m_stride; p < (m_size + 1) * m_stride; ++p) {
+        lane.around[p] = 0;
+        for (int d = 0; d < 4; ++d) {
+            lane.around[p] = static_cast<uint8_t>(lane.around[p] | lane.cells[p + m_dirs[d]] << (2 * d));
+        }
+    }
+    std::vector<int> stack;
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int head = point(row, col);
+            int color = lane.cells[head];
+            if (color == GoBoard::Empty || lane.chainSize[head] > 0) continue;
+            // 这一块的子按发现顺序连成环，都记在head名下
+            m_startChains.push_back(head);
+            lane.chain[head] = static_cast<uint16_t>(head);
+            lane.chainSize[head] = 1;
+            int last = head;
+            stack.assign(1, head);
+            while (!stack.empty()) {
+                int p = stack.back();
+                stack.pop_back();
+                for (int dir : m_dirs) {
+                    int n = p + dir;
+                    if (lane.cells[n] == GoBoard::Empty) addLiberty(lane, head, n);
+                    if (lane.cells[n] != color || lane.chain[n] == head) continue;
+                    lane.chain[n] = static_cast<uint16_t>(head);
+                    lane.chainSize[n] = 1; // 只作已访问标记，下面清掉
+                    lane.next[last] = static_cast<uint16_t>(n);
+                    last = n;
+                    stack.push_back(n);
+                }
+            }
+            lane.next[last] = static_cast<uint16_t>(head);
+        }
+    }
+    for (int head : m_startChains) {
+        int size = 0;
+        int p = head;
+        do {
+            size++;
+            p = lane.next[p];
+        } while (p != head);
+        for (p = lane.next[head]; p != head; p = lane.next[p]) {
+            lane.chainSize[p] = 0;
+        }
+        lane.chainSize[head] = static_cast<uint16_t>(size);
+    }
+
+    lane.toPlay = static_cast<int>(start.toPlay());
+    lane.ko = NO_POINT;
+    lane.koColor = GoBoard::Empty;
+    if (start.koPoint() != GoBoard::NO_POINT) {
+        lane.ko = point(start.rowOf(start.koPoint()), start.colOf(start.koPoint()));
+        lane.koColor = static_cast<int>(start.koColor());
+    }
+    lane.passes = start.lastMove() == GoBoard::PASS_MOVE ? 1 : 0;
+    lane.moves = 0;
+    lane.active = false;
+    for (Lane& other : m_lanes) {
+        resetLane(other);
+        other.active = false;
+    }
+}
+
+void GoBatchPlayout::resetLane(Lane& lane) const
+{
+    // 气位集很大，只复制起始局面里有的棋块
+    std::memcpy(lane.cells, m_start.cells, sizeof(Lane) - offsetof(Lane, cells));
+    for (int head : m_startChains) {
+        std::memcpy(lane.liberties[head], m_start.liberties[head], sizeof(lane.liberties[head]));
+    }
+    lane.active = true;
+}
+
+void GoBatchPlayout::addLiberty(Lane& lane, int chain, int p)
+{
+    uint64_t& word = lane.liberties[chain][p >> 6];
+    uint64_t bit = uint64_t(1) << (p & 63);
+    lane.libertyCount[chain] = static_cast<uint16_t>(lane.libertyCount[chain] + ((word & bit) == 0));
+    word |= bit;
+}
+
+void GoBatchPlayout::removeLiberty(Lane& lane, int chain, int p)
+{
+    uint64_t& word = lane.liberties[chain][p >> 6];
+    uint64_t bit = uint64_t(1) << (p & 63);
+    lane.libertyCount[chain] = static_cast<uint16_t>(lane.libertyCount[chain] - ((word & bit) != 0));
+    word &= ~bit;
+}
+
+void GoBatchPlayout::setStone(Lane& lane, int p, int color) const
+{
+    lane.cells[p] = static_cast<uint8_t>(color);
+    int last = lane.empties[--lane.emptyCount];
+    lane.empties[lane.emptyIndex[p]] = static_cast<uint16_t>(last);
+    lane.emptyIndex[last] = lane.emptyIndex[p];
+    lane.stones[color - 1][p / m_stride - 1] |= 1u << (p % m_stride);
+    // p是邻点n在反方向上的邻点
+    for (int d = 0; d < 4; ++d) {
+        uint8_t& around = lane.around[p + m_dirs[d]];
+        around = static_cast<uint8_t>(around + (color << (2 * ((d + 2) & 3))));
+    }
+}
+
+void GoBatchPlayout::clearStone(Lane& lane, int p) const
+{
+    int color = lane.cells[p];
+    lane.stones[color - 1][p / m_stride - 1] &= ~(1u << (p % m_stride));
+    for (int d = 0; d < 4; ++d) {
+        uint8_t& around = lane.around[p + m_dirs[d]];
+        around = static_cast<uint8_t>(around - (color << (2 * ((d + 2) & 3))));
+    }
+    lane.cells[p] = GoBoard::Empty;
+    lane.emptyIndex[p] = static_cast<uint16_t>(lane.emptyCount);
+    lane.empties[lane.emptyCount++] = static_cast<uint16_t>(p);
+}
+
+bool GoBatchPlayout::isLegal(const Lane& lane, int p, int color) const
+{
+    if (p == lane.ko && color == lane.koColor) return false;
+    for (int dir : m_dirs) {
+        int n = p + dir;
+        int cell = lane.cells[n];
+        if (cell == GoBoard::Empty) return true;
+        if (cell == GoBoard::Border) continue;
+        // 与还有别的气的己方棋块相连，或者提掉只剩这口气的对方棋块（空点p一定是邻块的气）
+        bool otherLiberty = lane.libertyCount[lane.chain[n]] > 1;
+        if (otherLiberty == (cell == color)) return true;
+    }
+    return false;
+}
+
+int GoBatchPlayout::selectMove(const Lane& lane, FastRng& rng) const
+{
+    int count = lane.emptyCount;
+    if (count == 0) return NO_POINT;
+    int color = lane.toPlay;
+    const uint8_t* kinds = m_moveKind[color - 1];
+    int start = static_cast<int>(rng.below(static_cast<uint32_t>(count)));
+    for (int i = 0; i < count; ++i) {
+        int index = start + i;
+        int p = lane.empties[index < count ? index : index - count];
+        int kind = kinds[lane.around[p]];
+        if (kind == OwnEye) continue;
+        if (kind == HasEmptyNeighbour ? p != lane.ko || color != lane.koColor : isLegal(lane, p, color)) return p;
+    }
+    return NO_POINT;
+}
+
+void GoBatchPlayout::capture(Lane& lane, int chain, int byColor, int& count, int& lastPoint) const
+{
+    int p = chain;
+    do {
+        int next = lane.next[p];
+        clearStone(lane, p);
+        // 提掉的点成为相邻的提子方棋块的气
+        for (int dir : m_dirs) {
+            int n = p + dir;
+            if (lane.cells[n] == byColor) addLiberty(lane, lane.chain[n], p);
+        }
+        count++;
+        lastPoint = p;
+        p = next;
+    } while (p != chain);
+}
+
+void GoBatchPlayout::play(Lane& lane, int p)
+{
+    int color = lane.toPlay;
+    int opponent = GoBoard::opponent(color);
+    setStone(lane, p, color);
+
+    // 先自成一块，再并入相邻的己方棋块（小块并入大块）
+    int own = p;
+    lane.chain[p] = static_cast<uint16_t>(p);
+    lane.next[p] = static_cast<uint16_t>(p);
+    lane.chainSize[p] = 1;
+    lane.libertyCount[p] = 0;
+    for (uint64_t& word : lane.liberties[p]) {
+        word = 0;
+    }
+    for (int dir : m_dirs) {
+        int n = p + dir;
+        int cell = lane.cells[n];
+        if (cell == GoBoard::Empty) {
+            addLiberty(lane, own, n);
+            continue;
+        }
+        if (cell != color || lane.chain[n] == own) continue;
+        int keep = lane.chain[n];
+        int merged = own;
+        if (lane.chainSize[keep] < lane.chainSize[merged]) std::swap(keep, merged);
+        int q = merged;
+        do {
+            lane.chain[q] = static_cast<uint16_t>(keep);
+            q = lane.next[q];
+        } while (q != merged);
+        std::swap(lane.next[keep], lane.next[merged]);
+        lane.chainSize[keep] = static_cast<uint16_t>(lane.chainSize[keep] + lane.chainSize[merged]);
+        int count = 0;
+        for (int i = 0; i < LIBERTY_WORDS; ++i) {
+            lane.liberties[keep][i] |= lane.liberties[merged][i];
+            count += popcount64(lane.liberties[keep][i]);
+        }
+        lane.libertyCount[keep] = static_cast<uint16_t>(count);
+        own = keep;
+    }
+    removeLiberty(lane, own, p);
+
+    // 相邻的对方棋块去掉这口气，没气了就提掉
+    int captured = 0;
+    int capturedPoint = NO_POINT;
+    for (int dir : m_dirs) {
+        int n = p + dir;
+        if (lane.cells[n] != opponent) continue;
+        int chain = lane.chain[n];
+        removeLiberty(lane, chain, p);
+        if (lane.libertyCount[chain] == 0) capture(lane, chain, color, captured, capturedPoint);
+    }
+
+    // 提一子、落下的是孤子且只剩一口气（就是刚提掉的点）时成劫
+    bool ko = captured == 1 && lane.chainSize[own] == 1 && lane.libertyCount[own] == 1;
+    lane.ko = ko ? capturedPoint : NO_POINT;
+    lane.koColor = opponent;
+}
+
+void GoBatchPlayout::run(int games, FastRng& rng, std::vector<PlayoutResult>& results, std::vector<int>* ownership)
+{
+    if (ownership) ownership->resize(m_size * m_size, 0);
+    int started = 0;
+    for (Lane& lane : m_lanes) {
+        if (started < games) {
+            resetLane(lane);
+            started++;
+        } else {
+            lane.active = false;
+        }
+    }
+
+    int active = started;
+    while (active > 0) {
+        // 各盘同步下一手
+        for (Lane& lane : m_lanes) {
+            if (!lane.active) continue;
+            int move = selectMove(lane, rng);
+            if (move == NO_POINT) {
+                lane.passes++;
+                lane.ko = NO_POINT;
+            } else {
+                play(lane, move);
+                lane.passes = 0;
+            }
+            lane.toPlay = GoBoard::opponent(lane.toPlay);
+            lane.moves++;
+            m_boardMoves++;
+            if (lane.passes < 2 && lane.moves < m_maxMoves) continue;
+
+            finishLane(lane, results, ownership);
+            if (started < games) {
+                resetLane(lane);
+                started++;
+            } else {
+                lane.active = false;
+                active--;
+            }
+        }
+    }
+    if (m_pendingCount > 0) scorePending(results, ownership);
+}
+
+void GoBatchPlayout::finishLane(Lane& lane, std::vector<PlayoutResult>& results, std::vector<int>* ownership)
+{
+    int slot = m_pendingCount++;
+    for (int c = 0; c < 2; ++c) {
+        for (int r = 0; r < m_size; ++r) {
+            m_pending[c].rows[r][slot] = lane.stones[c][r];
+        }
+    }
+    m_pendingMoves[slot] = lane.moves;
+    if (m_pendingCount == LANES) scorePending(results, ownership);
+}
+
+void GoBatchPlayout::scorePending(std::vector<PlayoutResult>& results, std::vector<int>* ownership)
+{
+    // 数子：空点从各色棋子向外泛洪，只被一方摸到的空点归该方
+    Plane empty, reach[2];
+    for (int r = 0; r < m_size; ++r) {
+        for (int lane = 0; lane < LANES; ++lane) {
+            empty.rows[r][lane] = m_rowMask & ~(m_pending[0].rows[r][lane] | m_pending[1].rows[r][lane]);
+        }
+    }
+    for (int c = 0; c < 2; ++c) {
+        m_dilate(m_pending[c], empty, reach[c], m_size);
+        m_grow(reach[c], empty, m_size);
+    }
+
+    for (int lane = 0; lane < m_pendingCount; ++lane) {
+        int area[2] = {0, 0};
+        for (int r = 0; r < m_size; ++r) {
+            uint32_t black = m_pending[0].rows[r][lane] | (reach[0].rows[r][lane] & ~reach[1].rows[r][lane]);
+            uint32_t white = m_pending[1].rows[r][lane] | (reach[1].rows[r][lane] & ~reach[0].rows[r][lane]);
+            area[0] += popcount(black);
+            area[1] += popcount(white);
+            if (!ownership) continue;
+            for (uint32_t bits = black; bits; bits &= bits - 1) {
+                (*ownership)[r * m_size + lowestBit(bits)]++;
+            }
+            for (uint32_t bits = white; bits; bits &= bits - 1) {
+                (*ownership)[r * m_size + lowestBit(bits)]--;
+            }
+        }
+        PlayoutResult result;
+        result.score = area[0] - area[1] - m_komi;
+        result.moves = m_pendingMoves[lane];
+        results.push_back(result);
+    }
+    // 空出来的槽清零，凑不满时不影响下一批
+    std::memset(m_pending, 0, sizeof(m_pending));
+    m_pendingCount = 0;
+}
+
+BatchPlayoutStats runBatchPlayouts(const GoBoard& start, long long games, int threads, uint64_t seed, double komi)
+{
+    BatchPlayoutStats stats;
+    if (threads < 1) threads = 1;
+    int points = start.size() * start.size();
+    // 每个线程一次领一小批，领完为止
+    const int CHUNK = 64;
+    std::atomic<long long> next(0);
+    std::vector<std::vector<PlayoutResult>> results(threads);
+    std::vector<std::vector<int>> ownership(threads);
+    std::vector<long long> moves(threads, 0);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            FastRng rng(seed + static_cast<uint64_t>(t) * 0x9E3779B97F4A7C15ULL);
+            GoBatchPlayout batch(start);
+            batch.setKomi(komi);
+            while (true) {
+                long long begin = next.fetch_add(CHUNK, std::memory_order_relaxed);
+                if (begin >= games) break;
+                int count = static_cast<int>(std::min<long long>(CHUNK, games - begin));
+                batch.run(count, rng, results[t], &ownership[t]);
+            }
+            moves[t] = batch.boardMoves();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    stats.ownership.assign(points, 0.0);
+    double scoreSum = 0.0;
+    for (int t = 0; t < threads; ++t) {
+        stats.boardMoves += moves[t];
+        for (const PlayoutResult& result : results[t]) {
+            stats.games++;
+            scoreSum += result.score;
+            if (result.winner() == PieceColor::Black) stats.blackWins++;
+        }
+        for (int i = 0; i < static_cast<int>(ownership[t].size()); ++i) {
+            stats.ownership[i] += ownership[t][i];
+        }
+    }
+    if (stats.games > 0) {
+        stats.meanScore = scoreSum / stats.games;
+        for (double& value : stats.ownership) {
+            value /= static_cast<double>(stats.games);
+        }
+    }
+    return stats;
+}
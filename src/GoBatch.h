@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "FastRng.h"
+#include "GoBoard.h"
+#include "GoPlayout.h"
+
+// 同步推进多盘棋的批量走子引擎，用于蒙特卡洛归属、贴目调参和生成训练数据
+// 每步给LANES盘棋各下一手；每盘一维带边框棋盘，每个棋块一个气的位集（每点一位，64位一字），落子/提子时增量更新：
+// 另记每块的气数，判提子、判自杀、判劫只看邻块的气数，不泛洪
+// 下完的盘把棋子位平面放进结构体数组布局的待数子批里（LANES盘的同一行连续存放，正好是一个AVX2寄存器），
+// 凑满LANES盘再一起泛洪数子
+// 落子策略同GoPlayout的Uniform：空点表中随机起点顺序扫描，取第一个合法且不填己方眼的点；
+// 每点记着四邻的颜色码，查表即知是不是眼、有没有空邻点，只有四邻都有子的点才去看邻块的气数
+// 某盘下完就从起始局面重开，直到开出所需局数；每个线程各用一个实例
+class GoBatchPlayout {
+public:
+    static const int LANES = 8;
+
+    explicit GoBatchPlayout(const GoBoard& start);
+
+    void setKomi(double komi) { m_komi = komi; }
+    void setMaxMoves(int maxMoves) { m_maxMoves = maxMoves; }
+    int size() const { return m_size; }
+
+    // 下games局，结果按数子的顺序追加到results
+    // ownership非空时按row * size + col累加每局终局的归属：黑+1，白-1，单官0
+    void run(int games, FastRng& rng, std::vector<PlayoutResult>& results, std::vector<int>* ownership = nullptr);
+
+    // 累计落子数（含虚着）
+    long long boardMoves() const { return m_boardMoves; }
+
+private:
+    // 点号(row + 1) * (size + 1) + col，右边框与下一行的左边框共用
+    static const int MAX_POINTS = (GoBoard::MAX_SIZE + 2) * (GoBoard::MAX_SIZE + 1);
+    static const int LIBERTY_WORDS = (MAX_POINTS + 63) / 64;
+    static const int NO_POINT = 0; // 0号点总在边框上
+    // 按四邻颜色码给空点分类
+    enum MoveKind : uint8_t { OwnEye, HasEmptyNeighbour, NeedsCheck };
+
+    struct alignas(32) Plane {
+        uint32_t rows[GoBoard::MAX_SIZE][LANES];
+    };
+
+    // 一盘棋；棋块号取棋块中某颗子的点号，气位集和气数按棋块号存放
+    struct Lane {
+        uint64_t liberties[MAX_POINTS][LIBERTY_WORDS];
+        uint8_t cells[MAX_POINTS];
+        uint8_t around[MAX_POINTS];      // 四邻（北、东、南、西）的格子值，各占2位
+        uint16_t libertyCount[MAX_POINTS];
+        uint16_t chain[MAX_POINTS];      // 所在棋块号
+        uint16_t next[MAX_POINTS];       // 棋块内的子连成环
+        uint16_t chainSize[MAX_POINTS];
+        uint16_t empties[MAX_POINTS];    // 空点表
+        uint16_t emptyIndex[MAX_POINTS];
+        int emptyCount;
+        uint32_t stones[2][GoBoard::MAX_SIZE]; // 黑、白的行位平面，数子用
+        int toPlay;
+        int ko;
+        int koColor;
+        int passes;
+        int moves;
+        bool active;
+    };
+
+    // 沿mask泛洪到不再变化
+    using GrowKernel = void (*)(Plane& group, const Plane& mask, int size);
+    // 四邻扩张一步再与mask求交
+    using DilateKernel = void (*)(const Plane& group, const Plane& mask, Plane& out, int size);
+
+    int m_size;
+    int m_stride;
+    int m_dirs[4];
+    uint8_t m_moveKind[2][256]; // [落子方 - 1][四邻颜色码]
+    uint32_t m_rowMask;
+    double m_komi;
+    int m_maxMoves;
+    long long m_boardMoves;
+    GrowKernel m_grow;
+    DilateKernel m_dilate;
+
+    Lane m_start;                    // 起始局面
+    std::vector<int> m_startChains;  // 起始局面的棋块号，重开时只复制这些气位集
+    std::vector<Lane> m_lanes;
+
+    // 待数子的盘
+    Plane m_pending[2];
+    int m_pendingMoves[LANES];
+    int m_pendingCount;
+
+    int point(int row, int col) const { return (row + 1) * m_stride + col; }
+    void resetLane(Lane& lane) const;
+    // 在空点表中随机起点扫描，返回第一个合法且不是己方眼的点，没有时返回NO_POINT
+    int selectMove(const Lane& lane, FastRng& rng) const;
+    bool isLegal(const Lane& lane, int p, int color) const;
+    void play(Lane& lane, int p);
+    void capture(Lane& lane, int chain, int byColor, int& count, int& lastPoint) const;
+    static void addLiberty(Lane& lane, int chain, int p);
+    static void removeLiberty(Lane& lane, int chain, int p);
+    void setStone(Lane& lane, int p, int color) const;
+    void clearStone(Lane& lane, int p) const;
+
+    // 下完的盘放进待数子批，凑满LANES盘时数子
+    void finishLane(Lane& lane, std::vector<PlayoutResult>& results, std::vector<int>* ownership);
+    // 给待数子批中的前m_pendingCount盘数子，结果追加到results并累加归属
+    void scorePending(std::vector<PlayoutResult>& results, std::vector<int>* ownership);
+};
+
+// 多线程批量走子的汇总
+struct BatchPlayoutStats {
+    long long games = 0;
+    long long boardMoves = 0;
+    long long blackWins = 0;
+    double meanScore = 0.0;         // 黑减白，已扣贴目
+    std::vector<double> ownership;  // 按row * size + col，[-1, 1]
+};
+
+// threads个线程各用一个GoBatchPlayout，共下games局
+BatchPlayoutStats runBatchPlayouts(const GoBoard& start, long long games, int threads, uint64_t seed, double komi);
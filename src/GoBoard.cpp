@@ -0,0 +1,790 @@
+// GoBoard.cpp
+#include "GoBoard.h"
+#include "RulesStats.h"
+#include <algorithm>
+#include <cstring>
+
+GoBoard::GoBoard(int size)
+    : m_size(size < 1 ? 1 : (size > MAX_SIZE ? MAX_SIZE : size))
+    , m_stride(m_size + 2)
+    , m_ko(NO_POINT)
+    , m_koColor(Empty)
+    , m_toPlay(Black)
+    , m_lastCaptures(0)
+    , m_lastMove(NO_POINT)
+    , m_hash(0)
+    , m_recording(true)
+{
+    m_dirs[0] = 1;
+    m_dirs[1] = -1;
+    m_dirs[2] = m_stride;
+    m_dirs[3] = -m_stride;
+    // 与pattern3的位顺序一致
+    const int offsets8[8] = {-m_stride, 1, m_stride, -1, 1 - m_stride, 1 + m_stride, m_stride - 1, -m_stride - 1};
+    for (int i = 0; i < 8; ++i) {
+        m_neighbours8[i] = offsets8[i];
+    }
+    reset();
+}
+
+const uint64_t* GoBoard::zobrist()
+{
+    // 固定种子的splitmix64，保证不同进程之间哈希一致
+    static const std::vector<uint64_t> table = [] {
+        std::vector<uint64_t> keys(MAX_POINTS * 3);
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (auto& key : keys) {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }();
+    return table.data();
+}
+
+void GoBoard::reset()
+{
+    std::memset(&m_d, 0, sizeof(m_d));
+    for (int p = 0; p < MAX_POINTS; ++p) {
+        m_d.cells[p] = Border;
+    }
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int p = point(row, col);
+            m_d.cells[p] = Empty;
+            m_d.emptyIndex[p] = m_d.emptyCount;
+            m_d.emptyList[m_d.emptyCount++] = p;
+        }
+    }
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int p = point(row, col);
+            int code = 0;
+            for (int i = 0; i < 8; ++i) {
+                code |= m_d.cells[p + m_neighbours8[i]] << (2 * i);
+            }
+            m_d.pattern3[p] = code;
+        }
+    }
+    m_ko = NO_POINT;
+    m_koColor = Empty;
+    m_toPlay = Black;
+    m_lastCaptures = 0;
+    m_lastMove = NO_POINT;
+    m_hash = 0;
+    m_trail.clear();
+    m_frames.clear();
+}
+
+void GoBoard::setRecording(bool enabled)
+{
+    m_recording = enabled;
+    if (!enabled) {
+        m_trail.clear();
+        m_frames.clear();
+    }
+}
+
+uint64_t GoBoard::positionKey() const
+{
+    // 每个点的Empty键不参与棋子哈希，借来表示劫点
+    uint64_t key = m_hash;
+    if (m_toPlay == White) key ^= 0xD1B54A32D192ED03ULL;
+    if (m_ko != NO_POINT) key ^= zobrist()[m_ko * 3 + Empty];
+    return key;
+}
+
+PieceColor GoBoard::at(int p) const
+{
+    int c = m_d.cells[p];
+    return c == Border ? PieceColor::Empty : static_cast<PieceColor>(c);
+}
+
+bool GoBoard::isInAtari(int p) const
+{
+    int g = m_d.group[p];
+    int libs = m_d.libs[g];
+    // 伪气全部落在同一点上 <=> 只有一口真气
+    return libs > 0 && static_cast<int64_t>(libs) * m_d.libSumSq[g] ==
+                       static_cast<int64_t>(m_d.libSum[g]) * m_d.libSum[g];
+}
+
+int GoBoard::atariLiberty(int p) const
+{
+    int g = m_d.group[p];
+    return m_d.libs[g] > 0 ? m_d.libSum[g] / m_d.libs[g] : NO_POINT;
+}
+
+int GoBoard::libertyCount(int p, int limit) const
+{
+    int g = m_d.group[p];
+    if (g == 0) return 0;
+    if (m_d.libs[g] == 0) return 0;
+    if (isInAtari(p)) return 1;
+
+    // 遍历棋块统计真气，遇到limit提前返回
+    bool seen[MAX_POINTS] = {false};
+    int count = 0;
+    int s = g;
+    do {
+        for (int dir : m_dirs) {
+            int n = s + dir;
+            if (m_d.cells[n] == Empty && !seen[n]) {
+                seen[n] = true;
+                if (++count >= limit) return count;
+            }
+        }
+        s = m_d.next[s];
+    } while (s != g);
+    return count;
+}
+
+int GoBoard::liberties(int p, int maxCount, int out[]) const
+{
+    int g = m_d.group[p];
+    if (g == 0 || m_d.libs[g] == 0 || maxCount <= 0) return 0;
+    if (isInAtari(p)) {
+        out[0] = atariLiberty(p);
+        return 1;
+    }
+
+    // maxCount很小，直接在已找到的气里查重，省掉整盘的标记数组
+    int count = 0;
+    int s = g;
+    do {
+        for (int dir : m_dirs) {
+            int n = s + dir;
+            if (m_d.cells[n] != Empty || std::find(out, out + count, n) != out + count) continue;
+            out[count++] = n;
+            if (count >= maxCount) return count;
+        }
+        s = m_d.next[s];
+    } while (s != g);
+    return count;
+}
+
+bool GoBoard::isLegal(int p, PieceColor color) const
+{
+    RULES_STATS_SCOPE(GoBoardEngine, Legality);
+    if (p == PASS_MOVE) return true;
+    if (!isOnBoard(p) || m_d.cells[p] != Empty) return false;
+
+    int c = static_cast<int>(color);
+    if (p == m_ko && c == m_koColor) return false;
+
+    int o = opponent(c);
+    for (int dir : m_dirs) {
+        int n = p + dir;
+        int cell = m_d.cells[n];
+        if (cell == Empty) return true;
+        if (cell == c && !isInAtari(n)) return true; // 相连后仍有别的气
+        if (cell == o && isInAtari(n)) return true;  // 能提子
+    }
+    return false; // 自杀
+}
+
+void GoBoard::legalMoves(PieceColor color, BoardBitset& out, bool skipOwnEyes, bool superko) const
+{
+    RULES_STATS_SCOPE(GoBoardEngine, Legality);
+    out.clear();
+    int c = static_cast<int>(color);
+    int o = opponent(c);
+    // pattern3低8位是四个正邻点，每点2位：空点为00，己方和边框在c的那一位上都是1
+    const int ownBits = c == Black ? 0x55 : 0xAA;
+
+    // 历史局面的棋子哈希，用来查全局同形
+    std::vector<uint64_t> history;
+    if (superko) {
+        history.reserve(m_frames.size() + 1);
+        for (const Frame& frame : m_frames) {
+            history.push_back(frame.hash);
+        }
+        history.push_back(m_hash);
+        std::sort(history.begin(), history.end());
+    }
+
+    for (int i = 0; i < m_d.emptyCount; ++i) {
+        int p = m_d.emptyList[i];
+        int four = m_d.pattern3[p] & 0xFF;
+        if (skipOwnEyes && (four & ownBits) == ownBits) continue;
+        if (p == m_ko && c == m_koColor) continue;
+
+        if (((four | (four >> 1)) & 0x55) == 0x55) {
+            // 四面都是子或边框：要么连到不止一口气的己方棋块，要么提子
+            bool legal = false;
+            for (int dir : m_dirs) {
+                int cell = m_d.cells[p + dir];
+                if ((cell == c && !isInAtari(p + dir)) || (cell == o && isInAtari(p + dir))) {
+                    legal = true;
+                    break;
+                }
+            }
+            if (!legal) continue;
+        }
+
+        if (superko) {
+            uint64_t hash = m_hash ^ zobrist()[p * 3 + c];
+            int captured[4];
+            int capturedCount = 0;
+            for (int dir : m_dirs) {
+                int n = p + dir;
+                if (m_d.cells[n] != o || !isInAtari(n)) continue;
+                int g = m_d.group[n];
+                if (std::find(captured, captured + capturedCount, g) != captured + capturedCount) continue;
+                captured[capturedCount++] = g;
+                int s = g;
+                do {
+                    hash ^= zobrist()[s * 3 + o];
+                    s = m_d.next[s];
+                } while (s != g);
+            }
+            if (std::binary_search(history.begin(), history.end(), hash)) continue;
+        }
+        out.set(rowOf(p) * m_size + colOf(p));
+    }
+}
+
+void GoBoard::pushFrame(int move, int color)
+{
+    if (!m_recording) return;
+    m_frames.push_back({move, color, m_ko, m_koColor, m_toPlay, m_lastCaptures, m_lastMove, m_hash, m_trail.size()});
+}
+
+bool GoBoard::play(int p, PieceColor color)
+{
+    if (p == PASS_MOVE) {
+        pass(color);
+        return true;
+    }
+    if (!isLegal(p, color)) return false;
+
+    RULES_STATS_SCOPE(GoBoardEngine, Place);
+    int c = static_cast<int>(color);
+    int o = opponent(c);
+    pushFrame(p, c);
+
+    // 放置单子棋块
+    setCell(p, c);
+    m_hash ^= zobrist()[p * 3 + c];
+    removeEmpty(p);
+    set(m_d.group[p], p);
+    set(m_d.next[p], p);
+    set(m_d.size[p], 1);
+    set(m_d.libs[p], 0);
+    set(m_d.libSum[p], 0);
+    set(m_d.libSumSq[p], 0);
+    for (int dir : m_dirs) {
+        if (m_d.cells[p + dir] == Empty) addLiberty(p, p + dir);
+    }
+
+    // 相邻棋块失去这口气
+    for (int dir : m_dirs) {
+        int n = p + dir;
+        int cell = m_d.cells[n];
+        if (cell == Black || cell == White) removeLiberty(m_d.group[n], p);
+    }
+
+    // 提掉无气的对方棋块
+    m_lastCaptures = 0;
+    int captured = 0;
+    int capturedPoint = NO_POINT;
+    for (int dir : m_dirs) {
+        int n = p + dir;
+        if (m_d.cells[n] == o && m_d.libs[m_d.group[n]] == 0) {
+            captured += captureGroup(m_d.group[n]);
+            capturedPoint = n;
+        }
+    }
+
+    // 与相邻的己方棋块合并
+    for (int dir : m_dirs) {
+        int n = p + dir;
+        if (m_d.cells[n] == c && m_d.group[n] != m_d.group[p]) {
+            mergeGroups(m_d.group[p], m_d.group[n]);
+        }
+    }
+
+    // 单子提单子且落下的子只剩被提点一口气时形成劫
+    RULES_STATS_SCOPE(GoBoardEngine, Ko);
+    if (captured == 1 && m_d.size[m_d.group[p]] == 1 && isInAtari(p)) {
+        m_ko = capturedPoint;
+        m_koColor = o;
+    } else {
+        m_ko = NO_POINT;
+        m_koColor = Empty;
+    }
+    m_lastMove = p;
+    m_toPlay = o;
+    return true;
+}
+
+void GoBoard::pass(PieceColor color)
+{
+    pushFrame(PASS_MOVE, static_cast<int>(color));
+    m_ko = NO_POINT;
+    m_koColor = Empty;
+    m_lastCaptures = 0;
+    m_lastMove = PASS_MOVE;
+    m_toPlay = opponent(static_cast<int>(color));
+}
+
+bool GoBoard::setup(const std::vector<int>& black, const std::vector<int>& white, PieceColor toPlay)
+{
+    int cells[MAX_POINTS];
+    std::memcpy(cells, m_d.cells, sizeof(cells));
+    const std::vector<int>* lists[2] = {&black, &white};
+    for (int c = Black; c <= White; ++c) {
+        for (int p : *lists[c - 1]) {
+            if (!isOnBoard(p) || cells[p] != Empty) return false;
+            cells[p] = c;
+        }
+    }
+
+    // 每个棋块至少要挨着一个空点
+    bool seen[MAX_POINTS] = {false};
+    std::vector<int> stack;
+    for (int start = 0; start < MAX_POINTS; ++start) {
+        int c = cells[start];
+        if ((c != Black && c != White) || seen[start]) continue;
+        bool hasLiberty = false;
+        seen[start] = true;
+        stack.assign(1, start);
+        while (!stack.empty()) {
+            int s = stack.back();
+            stack.pop_back();
+            for (int dir : m_dirs) {
+                int n = s + dir;
+                if (cells[n] == Empty) hasLiberty = true;
+                if (cells[n] == c && !seen[n]) {
+                    seen[n] = true;
+                    stack.push_back(n);
+                }
+            }
+        }
+        if (!hasLiberty) return false;
+    }
+
+    std::memcpy(m_d.cells, cells, sizeof(cells));
+    rebuildFromCells();
+    m_ko = NO_POINT;
+    m_koColor = Empty;
+    m_toPlay = static_cast<int>(toPlay) == White ? White : Black;
+    m_lastCaptures = 0;
+    m_lastMove = NO_POINT;
+    m_trail.clear();
+    m_frames.clear();
+    return true;
+}
+
+void GoBoard::rebuildFromCells()
+{
+    m_d.emptyCount = 0;
+    m_hash = 0;
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int p = point(row, col);
+            int code = 0;
+            for (int i = 0; i < 8; ++i) {
+                code |= m_d.cells[p + m_neighbours8[i]] << (2 * i);
+            }
+            m_d.pattern3[p] = code;
+            m_d.group[p] = 0;
+            if (m_d.cells[p] == Empty) {
+                m_d.emptyIndex[p] = m_d.emptyCount;
+                m_d.emptyList[m_d.emptyCount++] = p;
+            } else {
+                m_hash ^= zobrist()[p * 3 + m_d.cells[p]];
+            }
+        }
+    }
+
+    // 按连通分量建棋块：第一个子为根，棋块内串成循环链表，伪气按棋子-空点相邻关系计
+    std::vector<int> stones;
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int root = point(row, col);
+            int c = m_d.cells[root];
+            if (c == Empty || m_d.group[root] != 0) continue;
+            m_d.group[root] = root;
+            stones.assign(1, root);
+            for (size_t i = 0; i < stones.size(); ++i) {
+                for (int dir : m_dirs) {
+                    int n = stones[i] + dir;
+                    if (m_d.cells[n] == c && m_d.group[n] == 0) {
+                        m_d.group[n] = root;
+                        stones.push_back(n);
+                    }
+                }
+            }
+            m_d.size[root] = static_cast<int>(stones.size());
+            m_d.libs[root] = 0;
+            m_d.libSum[root] = 0;
+            m_d.libSumSq[root] = 0;
+            for (size_t i = 0; i < stones.size(); ++i) {
+                int s = stones[i];
+                m_d.next[s] = stones[(i + 1) % stones.size()];
+                for (int dir : m_dirs) {
+                    int n = s + dir;
+                    if (m_d.cells[n] != Empty) continue;
+                    m_d.libs[root]++;
+                    m_d.libSum[root] += n;
+                    m_d.libSumSq[root] += n * n;
+                }
+            }
+        }
+    }
+}
+
+void GoBoard::undo()
+{
+    if (m_frames.empty()) return;
+
+    RULES_STATS_SCOPE(GoBoardEngine, Undo);
+    const Frame frame = m_frames.back();
+    m_frames.pop_back();
+
+    int* words = reinterpret_cast<int*>(&m_d);
+    while (m_trail.size() > frame.trailSize) {
+        const TrailEntry& entry = m_trail.back();
+        words[entry.index] = entry.value;
+        m_trail.pop_back();
+    }
+    m_ko = frame.ko;
+    m_koColor = frame.koColor;
+    m_toPlay = frame.toPlay;
+    m_lastCaptures = frame.lastCaptures;
+    m_lastMove = frame.lastMove;
+    m_hash = frame.hash;
+}
+
+void GoBoard::setCell(int p, int value)
+{
+    // p是邻点q的第i个邻居时，q的图案码第i个字段随之改变
+    int delta = m_d.cells[p] ^ value;
+    set(m_d.cells[p], value);
+    for (int i = 0; i < 8; ++i) {
+        int q = p - m_neighbours8[i];
+        set(m_d.pattern3[q], m_d.pattern3[q] ^ (delta << (2 * i)));
+    }
+}
+
+void GoBoard::addLiberty(int g, int lib)
+{
+    set(m_d.libs[g], m_d.libs[g] + 1);
+    set(m_d.libSum[g], m_d.libSum[g] + lib);
+    set(m_d.libSumSq[g], m_d.libSumSq[g] + lib * lib);
+}
+
+void GoBoard::removeLiberty(int g, int lib)
+{
+    set(m_d.libs[g], m_d.libs[g] - 1);
+    set(m_d.libSum[g], m_d.libSum[g] - lib);
+    set(m_d.libSumSq[g], m_d.libSumSq[g] - lib * lib);
+}
+
+void GoBoard::addEmpty(int p)
+{
+    set(m_d.emptyIndex[p], m_d.emptyCount);
+    set(m_d.emptyList[m_d.emptyCount], p);
+    set(m_d.emptyCount, m_d.emptyCount + 1);
+}
+
+void GoBoard::removeEmpty(int p)
+{
+    // 与末尾交换后删除
+    int index = m_d.emptyIndex[p];
+    int last = m_d.emptyList[m_d.emptyCount - 1];
+    set(m_d.emptyList[index], last);
+    set(m_d.emptyIndex[last], index);
+    set(m_d.emptyCount, m_d.emptyCount - 1);
+}
+
+int GoBoard::captureGroup(int g)
+{
+    RULES_STATS_SCOPE(GoBoardEngine, Capture);
+    int color = m_d.cells[g];
+    int count = 0;
+
+    // 先清空所有棋子，再给相邻棋块加气，避免给正在被提的棋块加气
+    int s = g;
+    do {
+        setCell(s, Empty);
+        set(m_d.group[s], 0);
+        m_hash ^= zobrist()[s * 3 + color];
+        addEmpty(s);
+        m_capturedPoints[m_lastCaptures + count] = s;
+        ++count;
+        s = m_d.next[s];
+    } while (s != g);
+
+    s = g;
+    do {
+        for (int dir : m_dirs) {
+            int n = s + dir;
+            int cell = m_d.cells[n];
+            if (cell == Black || cell == White) addLiberty(m_d.group[n], s);
+        }
+        s = m_d.next[s];
+    } while (s != g);
+
+    set(m_d.captured[color], m_d.captured[color] + count);
+    m_lastCaptures += count;
+    RULES_STATS_SAMPLE(GoBoardEngine, GroupSize, count);
+    return count;
+}
+
+void GoBoard::mergeGroups(int a, int b)
+{
+    // 小棋块并入大棋块
+    if (m_d.size[a] < m_d.size[b]) {
+        int tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    int s = b;
+    do {
+        set(m_d.group[s], a);
+        s = m_d.next[s];
+    } while (s != b);
+
+    int nextA = m_d.next[a];
+    set(m_d.next[a], m_d.next[b]);
+    set(m_d.next[b], nextA);
+    set(m_d.size[a], m_d.size[a] + m_d.size[b]);
+    set(m_d.libs[a], m_d.libs[a] + m_d.libs[b]);
+    set(m_d.libSum[a], m_d.libSum[a] + m_d.libSum[b]);
+    set(m_d.libSumSq[a], m_d.libSumSq[a] + m_d.libSumSq[b]);
+}
+
+bool GoBoard::isSimpleEye(int p, PieceColor color) const
+{
+    if (m_d.cells[p] != Empty) return false;
+    int c = static_cast<int>(color);
+    for (int dir : m_dirs) {
+        int cell = m_d.cells[p + dir];
+        if (cell != c && cell != Border) return false;
+    }
+    return true;
+}
+
+void GoBoard::areaScore(int& black, int& white) const
+{
+    RULES_STATS_SCOPE(GoBoardEngine, Scoring);
+    black = 0;
+    white = 0;
+
+    bool visited[MAX_POINTS] = {false};
+    std::vector<int> stack;
+    stack.reserve(MAX_POINTS);
+
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int p = point(row, col);
+            int cell = m_d.cells[p];
+            if (cell == Black) {
+                ++black;
+            } else if (cell == White) {
+                ++white;
+            } else if (!visited[p]) {
+                // 找到连通的空区域
+                bool touchesBlack = false, touchesWhite = false;
+                int regionSize = 0;
+                visited[p] = true;
+                stack.push_back(p);
+                while (!stack.empty()) {
+                    int q = stack.back();
+                    stack.pop_back();
+                    ++regionSize;
+                    for (int dir : m_dirs) {
+                        int n = q + dir;
+                        int ncell = m_d.cells[n];
+                        if (ncell == Empty && !visited[n]) {
+                            visited[n] = true;
+                            stack.push_back(n);
+                        } else if (ncell == Black) {
+                            touchesBlack = true;
+                        } else if (ncell == White) {
+                            touchesWhite = true;
+                        }
+                    }
+                }
+                RULES_STATS_SAMPLE(GoBoardEngine, FloodFill, regionSize);
+                if (touchesBlack && !touchesWhite) {
+                    black += regionSize;
+                } else if (touchesWhite && !touchesBlack) {
+                    white += regionSize;
+                }
+            }
+        }
+    }
+}
+
+void GoBoard::passAliveArea(int owner[MAX_POINTS]) const
+{
+    for (int p = 0; p < MAX_POINTS; ++p) {
+        owner[p] = Empty;
+    }
+    passAliveFor(Black, owner);
+    passAliveFor(White, owner);
+}
+
+bool GoBoard::isPassAlive(int p) const
+{
+    int color = m_d.cells[p];
+    if (color != Black && color != White) return false;
+    int owner[MAX_POINTS];
+    for (int q = 0; q < MAX_POINTS; ++q) {
+        owner[q] = Empty;
+    }
+    passAliveFor(color, owner);
+    return owner[p] == color;
+}
+
+void GoBoard::passAliveFor(int color, int owner[MAX_POINTS]) const
+{
+    // 区域：不含color棋子的连通块（空点和对方棋子），按区域连续存放在order中
+    int regionOf[MAX_POINTS];
+    int order[MAX_POINTS];
+    int regionStart[MAX_POINTS + 1];
+    int regionCount = 0;
+    int length = 0;
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            regionOf[point(row, col)] = -1;
+        }
+    }
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int p = point(row, col);
+            if (m_d.cells[p] == color || regionOf[p] >= 0) continue;
+            regionStart[regionCount] = length;
+            regionOf[p] = regionCount;
+            order[length++] = p;
+            for (int head = regionStart[regionCount]; head < length; ++head) {
+                int q = order[head];
+                for (int dir : m_dirs) {
+                    int n = q + dir;
+                    int cell = m_d.cells[n];
+                    if (cell != color && cell != Border && regionOf[n] < 0) {
+                        regionOf[n] = regionCount;
+                        order[length++] = n;
+                    }
+                }
+            }
+            regionCount++;
+        }
+    }
+    regionStart[regionCount] = length;
+
+    // 每个区域相邻的棋块，以及该区域对哪个棋块是"要害"（区域内每个空点都是该棋块的气）
+    // 按点数计，一个区域内被某棋块用作气的空点数等于区域空点数即为要害
+    std::vector<int> blocks;
+    std::vector<char> vital;
+    std::vector<int> blockStart(regionCount + 1);
+    int seen[MAX_POINTS];
+    int libCount[MAX_POINTS];
+    for (int p = 0; p < MAX_POINTS; ++p) {
+        seen[p] = -1;
+    }
+    for (int id = 0; id < regionCount; ++id) {
+        blockStart[id] = static_cast<int>(blocks.size());
+        int empties = 0;
+        for (int k = regionStart[id]; k < regionStart[id + 1]; ++k) {
+            int q = order[k];
+            bool empty = m_d.cells[q] == Empty;
+            if (empty) empties++;
+            int counted[4];
+            int countedSize = 0;
+            for (int dir : m_dirs) {
+                if (m_d.cells[q + dir] != color) continue;
+                int g = m_d.group[q + dir];
+                if (seen[g] != id) {
+                    seen[g] = id;
+                    libCount[g] = 0;
+                    blocks.push_back(g);
+                }
+                if (!empty || std::find(counted, counted + countedSize, g) != counted + countedSize) continue;
+                counted[countedSize++] = g;
+                libCount[g]++;
+            }
+        }
+        for (size_t k = blockStart[id]; k < blocks.size(); ++k) {
+            vital.push_back(libCount[blocks[k]] == empties);
+        }
+    }
+    blockStart[regionCount] = static_cast<int>(blocks.size());
+
+    // 反复删除要害区域少于两个的棋块，以及与已删除棋块相邻的区域
+    char blockAlive[MAX_POINTS] = {0};
+    std::vector<char> regionAlive(regionCount, 1);
+    for (int g : blocks) {
+        blockAlive[g] = 1;
+    }
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        int vitalCount[MAX_POINTS] = {0};
+        for (int id = 0; id < regionCount; ++id) {
+            if (!regionAlive[id]) continue;
+            for (int k = blockStart[id]; k < blockStart[id + 1]; ++k) {
+                if (vital[k]) vitalCount[blocks[k]]++;
+            }
+        }
+        for (int g : blocks) {
+            if (blockAlive[g] && vitalCount[g] < 2) {
+                blockAlive[g] = 0;
+                changed = true;
+            }
+        }
+        for (int id = 0; id < regionCount; ++id) {
+            if (!regionAlive[id]) continue;
+            for (int k = blockStart[id]; k < blockStart[id + 1]; ++k) {
+                if (!blockAlive[blocks[k]]) {
+                    regionAlive[id] = 0;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int p = point(row, col);
+            if (m_d.cells[p] == color && blockAlive[m_d.group[p]]) owner[p] = color;
+        }
+    }
+    // 存活区域若是某个活棋块的要害，整块归该方
+    for (int id = 0; id < regionCount; ++id) {
+        if (!regionAlive[id]) continue;
+        bool owned = false;
+        for (int k = blockStart[id]; k < blockStart[id + 1]; ++k) {
+            if (vital[k] && blockAlive[blocks[k]]) owned = true;
+        }
+        if (!owned) continue;
+        for (int k = regionStart[id]; k < regionStart[id + 1]; ++k) {
+            owner[order[k]] = color;
+        }
+    }
+}
+
+std::string GoBoard::toString() const
+{
+    std::string text;
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int p = point(row, col);
+            int cell = m_d.cells[p];
+            if (p == m_ko) {
+                text += '*';
+            } else {
+                text += cell == Black ? 'X' : (cell == White ? 'O' : '.');
+            }
+        }
+        text += '\n';
+    }
+    return text;
+}
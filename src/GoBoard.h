@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardBitset.h"
+#include "ChessPiece.h"
+
+// 不依赖Qt的围棋规则核心
+// 一维带边框棋盘，增量维护棋块、伪气和Zobrist哈希，落子/撤销无需拷贝棋盘
+class GoBoard {
+public:
+    static const int MAX_SIZE = 19;
+    // 上下各两行、左右各一列边框，保证距离2以内的邻点不会越界
+    static const int MAX_STRIDE = MAX_SIZE + 2;
+    static const int MAX_POINTS = (MAX_SIZE + 4) * MAX_STRIDE;
+    static const int PASS_MOVE = -1;
+    static const int NO_POINT = 0; // 0号点总在边框上
+
+    enum Cell { Empty = 0, Black = 1, White = 2, Border = 3 };
+
+    explicit GoBoard(int size = MAX_SIZE);
+
+    void reset();
+    int size() const { return m_size; }
+    int stride() const { return m_stride; }
+
+    // 坐标换算
+    int point(int row, int col) const { return (row + 2) * m_stride + col + 1; }
+    int rowOf(int p) const { return p / m_stride - 2; }
+    int colOf(int p) const { return p % m_stride - 1; }
+    bool isOnBoard(int p) const { return p > 0 && p < MAX_POINTS && m_d.cells[p] != Border; }
+
+    int cell(int p) const { return m_d.cells[p]; }
+    // 八个邻点（北、东、南、西、东北、东南、西南、西北）各占2位的3x3图案码，随落子增量更新
+    int pattern3(int p) const { return m_d.pattern3[p]; }
+    int neighbour8(int i) const { return m_neighbours8[i]; }
+    PieceColor at(int p) const;
+    PieceColor at(int row, int col) const { return at(point(row, col)); }
+
+    // 落子与撤销
+    bool isLegal(int p, PieceColor color) const;
+    bool play(int p, PieceColor color); // 非法着法返回false，棋盘不变
+    // color的全部合法着点（不含虚着），按row * size + col编号
+    // 只扫空点表：有空邻点的直接合法，其余按棋块伪气判断能否连出气或提子，不做泛洪
+    // skipOwnEyes去掉己方眼形（同isSimpleEye）；superko再去掉造成全局同形的点，只认得有撤销记录的局面
+    void legalMoves(PieceColor color, BoardBitset& out, bool skipOwnEyes = false, bool superko = false) const;
+    // 摆子（让子、题目局面、SGF的AB/AW）：在当前局面上一次放上一批棋子，不提子，
+    // 之后整盘重建一次棋块、气、图案码和哈希；摆好的局面成为新的起点（清空撤销记录和劫）
+    // 有点不在盘上、重复、已有子或摆出无气的棋块时整批不改，返回false
+    bool setup(const std::vector<int>& black, const std::vector<int>& white, PieceColor toPlay);
+    void pass(PieceColor color);
+    void undo();
+    bool canUndo() const { return !m_frames.empty(); }
+    int undoDepth() const { return static_cast<int>(m_frames.size()); } // 可撤销的手数
+    // 关闭记录后不再保存撤销信息（用于快速走子）
+    void setRecording(bool enabled);
+    bool isRecording() const { return m_recording; }
+
+    PieceColor toPlay() const { return static_cast<PieceColor>(m_toPlay); }
+    int koPoint() const { return m_ko; }            // 当前禁入的劫点，NO_POINT表示无劫
+    PieceColor koColor() const { return static_cast<PieceColor>(m_koColor); }
+    uint64_t hash() const { return m_hash; }
+    // 上一手之前的棋子哈希，没有撤销记录时同hash()；派生数据据此判断自己是否正好落后一手
+    uint64_t previousHash() const { return m_frames.empty() ? m_hash : m_frames.back().hash; }
+    // 置换表用的局面键：棋子哈希再混入轮到谁下和劫点
+    uint64_t positionKey() const;
+    int capturedBlack() const { return m_d.captured[Black]; } // 被提的黑子数
+    int capturedWhite() const { return m_d.captured[White]; } // 被提的白子数
+    int lastMove() const { return m_lastMove; }    // NO_POINT表示还没有着手
+    int lastCaptureCount() const { return m_lastCaptures; }
+    // 上一手提掉的子，只在play之后、下一次play/undo之前有效
+    int lastCapturedPoint(int i) const { return m_capturedPoints[i]; }
+
+    // 棋块查询
+    int groupOf(int p) const { return m_d.group[p]; }
+    int groupSize(int p) const { return m_d.size[m_d.group[p]]; }
+    int nextStone(int p) const { return m_d.next[p]; }
+    bool isInAtari(int p) const;
+    int atariLiberty(int p) const; // 仅在isInAtari时有意义
+    int libertyCount(int p, int limit = MAX_POINTS) const;
+    // 把p所在棋块的真气写入out，凑够maxCount口就停；返回写入的个数（用于战术读秒，maxCount应很小）
+    int liberties(int p, int maxCount, int out[]) const;
+
+    // 空点列表
+    int emptyCount() const { return m_d.emptyCount; }
+    int emptyPoint(int i) const { return m_d.emptyList[i]; }
+
+    bool isSimpleEye(int p, PieceColor color) const;
+
+    // 数子：棋子数+只与一方相邻的空区域（与ChessLogic::countTerritory一致）
+    void areaScore(int& black, int& white) const;
+    // Benson算法求无条件活棋（虚着也活）及其眼位，owner[p]为Black/White/Empty
+    void passAliveArea(int owner[MAX_POINTS]) const;
+    // 只对p所在棋块的颜色做一遍Benson，p为空点时返回false
+    bool isPassAlive(int p) const;
+
+    std::string toString() const;
+
+    static int opponent(int color) { return 3 - color; }
+
+private:
+    // 所有可撤销的状态都放在一个纯int结构里，撤销日志按下标记录旧值
+    struct Data {
+        int cells[MAX_POINTS];
+        int pattern3[MAX_POINTS];
+        int group[MAX_POINTS];      // 棋块根点，空点为0
+        int next[MAX_POINTS];       // 棋块内循环链表
+        int size[MAX_POINTS];       // 以下按根点索引
+        int libs[MAX_POINTS];       // 伪气数（每个棋子-空点相邻关系计一次）
+        int libSum[MAX_POINTS];
+        int libSumSq[MAX_POINTS];
+        int emptyList[MAX_POINTS];
+        int emptyIndex[MAX_POINTS];
+        int emptyCount;
+        int captured[3];
+    };
+
+    struct TrailEntry {
+        int index;
+        int value;
+    };
+
+    struct Frame {
+        int move;
+        int color;
+        int ko;
+        int koColor;
+        int toPlay;
+        int lastCaptures;
+        int lastMove;
+        uint64_t hash;
+        size_t trailSize;
+    };
+
+    int m_size;
+    int m_stride;
+    int m_dirs[4];
+    int m_neighbours8[8];
+    Data m_d;
+    int m_ko;
+    int m_koColor;
+    int m_toPlay;
+    int m_lastCaptures;
+    int m_lastMove;
+    int m_capturedPoints[MAX_POINTS];
+    uint64_t m_hash;
+    bool m_recording;
+    std::vector<TrailEntry> m_trail;
+    std::vector<Frame> m_frames;
+
+    void set(int& ref, int value)
+    {
+        if (m_recording) {
+            m_trail.push_back({static_cast<int>(&ref - reinterpret_cast<int*>(&m_d)), ref});
+        }
+        ref = value;
+    }
+
+    void pushFrame(int move, int color);
+    void setCell(int p, int value);
+    void addLiberty(int g, int lib);
+    void removeLiberty(int g, int lib);
+    void addEmpty(int p);
+    void removeEmpty(int p);
+    int captureGroup(int g);
+    void mergeGroups(int a, int b);
+    void passAliveFor(int color, int owner[MAX_POINTS]) const;
+    // 由cells重算空点表、图案码、棋块和哈希
+    void rebuildFromCells();
+
+    static const uint64_t* zobrist();
+};
@@ -0,0 +1,330 @@
+// GoCoreApi.cpp
+#include "GoCoreApi.h"
+#include <utility>
+#include <vector>
+#include "BoardBitset.h"
+#include "GoBoard.h"
+
+struct gocore_game {
+    explicit gocore_game(int size) : board(size) {}
+    GoBoard board;
+};
+
+static_assert(GOCORE_BITSET_WORDS == BoardBitset::WORDS, "bitset layout must match BoardBitset");
+static_assert(GOCORE_MAX_SIZE == GoBoard::MAX_SIZE, "size limit must match GoBoard");
+static_assert(GOCORE_PASS == GoBoard::PASS_MOVE, "pass must match GoBoard");
+
+namespace {
+
+bool isColor(int color)
+{
+    return color == GOCORE_BLACK || color == GOCORE_WHITE;
+}
+
+// 接口上的row * size + col编号换成带边框的点，越界时返回false
+bool toPoint(const GoBoard& board, int index, int& p)
+{
+    if (index == GOCORE_PASS) {
+        p = GoBoard::PASS_MOVE;
+        return true;
+    }
+    int size = board.size();
+    if (index < 0 || index >= size * size) return false;
+    p = board.point(index / size, index % size);
+    return true;
+}
+
+// 以下几个帮助函数把GoBoard里临时数组、撤销记录扩容时的bad_alloc挡在extern "C"之内，按出错返回
+
+// 带记录落子时撤销记录扩容失败：改动都已记下，撤回这半步，棋盘保持原样
+bool play(GoBoard& board, int p)
+{
+    int depth = board.undoDepth();
+    try {
+        return board.play(p, board.toPlay());
+    } catch (...) {
+        if (board.undoDepth() > depth) board.undo();
+        return false;
+    }
+}
+
+int legalMoves(const GoBoard& board, int flags, uint64_t* words)
+{
+    BoardBitset moves;
+    try {
+        board.legalMoves(board.toPlay(), moves, (flags & GOCORE_SKIP_OWN_EYES) != 0, (flags & GOCORE_SUPERKO) != 0);
+    } catch (...) {
+        moves.clear();
+    }
+    for (int i = 0; i < BoardBitset::WORDS; ++i) {
+        words[i] = moves.word(i);
+    }
+    return moves.count();
+}
+
+double score(const GoBoard& board, double komi, int* black, int* white)
+{
+    int blackArea = 0;
+    int whiteArea = 0;
+    try {
+        board.areaScore(blackArea, whiteArea);
+    } catch (...) {
+        if (black) *black = 0;
+        if (white) *white = 0;
+        return 0.0;
+    }
+    if (black) *black = blackArea;
+    if (white) *white = whiteArea;
+    return blackArea - whiteArea - komi;
+}
+
+int writeBoard(const GoBoard& board, int8_t* out)
+{
+    int size = board.size();
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            *out++ = static_cast<int8_t>(board.at(row, col));
+        }
+    }
+    return size * size;
+}
+
+} // namespace
+
+int gocore_api_version(void)
+{
+    return GOCORE_API_VERSION;
+}
+
+gocore_game* gocore_create(int size)
+{
+    if (size < 5 || size > GoBoard::MAX_SIZE) return nullptr;
+    try {
+        return new gocore_game(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+gocore_game* gocore_clone(const gocore_game* game)
+{
+    if (!game) return nullptr;
+    // 复制撤销记录也要分配内存
+    try {
+        return new gocore_game(*game);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void gocore_destroy(gocore_game* game)
+{
+    delete game;
+}
+
+void gocore_reset(gocore_game* game)
+{
+    if (game) game->board.reset();
+}
+
+void gocore_set_recording(gocore_game* game, int enabled)
+{
+    if (game) game->board.setRecording(enabled != 0);
+}
+
+int gocore_size(const gocore_game* game)
+{
+    return game ? game->board.size() : 0;
+}
+
+int gocore_to_play(const gocore_game* game)
+{
+    return game ? static_cast<int>(game->board.toPlay()) : GOCORE_EMPTY;
+}
+
+int gocore_at(const gocore_game* game, int point)
+{
+    int p = 0;
+    if (!game || point == GOCORE_PASS || !toPoint(game->board, point, p)) return GOCORE_EMPTY;
+    return static_cast<int>(game->board.at(p));
+}
+
+uint64_t gocore_hash(const gocore_game* game)
+{
+    return game ? game->board.positionKey() : 0;
+}
+
+int gocore_ko_point(const gocore_game* game)
+{
+    if (!game || game->board.koPoint() == GoBoard::NO_POINT) return GOCORE_PASS;
+    const GoBoard& board = game->board;
+    return board.rowOf(board.koPoint()) * board.size() + board.colOf(board.koPoint());
+}
+
+int gocore_captured(const gocore_game* game, int color)
+{
+    if (!game || !isColor(color)) return 0;
+    return color == GOCORE_BLACK ? game->board.capturedBlack() : game->board.capturedWhite();
+}
+
+int gocore_board(const gocore_game* game, int8_t* out)
+{
+    if (!game || !out) return 0;
+    return writeBoard(game->board, out);
+}
+
+int gocore_setup(gocore_game* game, const int* black, int blackCount, const int* white, int whiteCount, int toPlay)
+{
+    if (!game || !isColor(toPlay) || blackCount < 0 || whiteCount < 0) return 0;
+    if ((blackCount > 0 && !black) || (whiteCount > 0 && !white)) return 0;
+    GoBoard& board = game->board;
+    try {
+        std::vector<int> blackPoints(blackCount);
+        std::vector<int> whitePoints(whiteCount);
+        // 虚着在这里没有意义，和越界一样算错
+        for (int i = 0; i < blackCount; ++i) {
+            if (black[i] == GOCORE_PASS || !toPoint(board, black[i], blackPoints[i])) return 0;
+        }
+        for (int i = 0; i < whiteCount; ++i) {
+            if (white[i] == GOCORE_PASS || !toPoint(board, white[i], whitePoints[i])) return 0;
+        }
+        // 重建棋块时内存不足会留下半成品，在副本上摆好再换进来
+        GoBoard result(board);
+        if (!result.setup(blackPoints, whitePoints, static_cast<PieceColor>(toPlay))) return 0;
+        board = std::move(result);
+        return 1;
+    } catch (...) {
+        return 0;
+    }
+}
+
+int gocore_play(gocore_game* game, int point)
+{
+    int p = 0;
+    if (!game || !toPoint(game->board, point, p)) return 0;
+    return play(game->board, p);
+}
+
+int gocore_is_legal(const gocore_game* game, int point)
+{
+    int p = 0;
+    if (!game || !toPoint(game->board, point, p)) return 0;
+    return game->board.isLegal(p, game->board.toPlay());
+}
+
+int gocore_undo(gocore_game* game)
+{
+    if (!game || !game->board.canUndo()) return 0;
+    game->board.undo();
+    return 1;
+}
+
+int gocore_last_captures(const gocore_game* game)
+{
+    return game ? game->board.lastCaptureCount() : 0;
+}
+
+int gocore_legal_moves(const gocore_game* game, int flags, uint64_t* words)
+{
+    if (!game || !words) return 0;
+    return legalMoves(game->board, flags, words);
+}
+
+double gocore_score(const gocore_game* game, double komi, int* black, int* white)
+{
+    if (!game) return 0.0;
+    return score(game->board, komi, black, white);
+}
+
+int gocore_play_many(gocore_game* game, const int* points, int count)
+{
+    if (!game || !points) return 0;
+    GoBoard& board = game->board;
+    int played = 0;
+    for (; played < count; ++played) {
+        int p = 0;
+        if (!toPoint(board, points[played], p) || !play(board, p)) break;
+    }
+    return played;
+}
+
+int gocore_undo_many(gocore_game* game, int count)
+{
+    if (!game) return 0;
+    int undone = 0;
+    for (; undone < count && game->board.canUndo(); ++undone) {
+        game->board.undo();
+    }
+    return undone;
+}
+
+int gocore_try_moves(gocore_game* game, const int* points, int count, int* captures, uint64_t* hashes)
+{
+    if (!game || !points || !captures) return 0;
+    GoBoard& board = game->board;
+    if (!board.isRecording()) return -1;
+    int legal = 0;
+    for (int i = 0; i < count; ++i) {
+        int p = 0;
+        if (!toPoint(board, points[i], p) || !play(board, p)) {
+            captures[i] = -1;
+            if (hashes) hashes[i] = 0;
+            continue;
+        }
+        captures[i] = board.lastCaptureCount();
+        if (hashes) hashes[i] = board.positionKey();
+        board.undo();
+        legal++;
+    }
+    return legal;
+}
+
+int gocore_play_batch(gocore_game* const* games, const int* points, int count, int8_t* ok)
+{
+    if (!games || !points) return 0;
+    int played = 0;
+    for (int i = 0; i < count; ++i) {
+        int success = gocore_play(games[i], points[i]);
+        if (ok) ok[i] = static_cast<int8_t>(success);
+        played += success;
+    }
+    return played;
+}
+
+void gocore_legal_moves_batch(const gocore_game* const* games, int count, int flags, uint64_t* words, int* counts)
+{
+    if (!games || !words) return;
+    for (int i = 0; i < count; ++i) {
+        uint64_t* out = words + static_cast<size_t>(i) * GOCORE_BITSET_WORDS;
+        int moves = 0;
+        if (games[i]) {
+            moves = legalMoves(games[i]->board, flags, out);
+        } else {
+            for (int w = 0; w < GOCORE_BITSET_WORDS; ++w) {
+                out[w] = 0;
+            }
+        }
+        if (counts) counts[i] = moves;
+    }
+}
+
+void gocore_score_batch(const gocore_game* const* games, int count, double komi, double* out)
+{
+    if (!games || !out) return;
+    for (int i = 0; i < count; ++i) {
+        out[i] = games[i] ? score(games[i]->board, komi, nullptr, nullptr) : 0.0;
+    }
+}
+
+int gocore_board_batch(const gocore_game* const* games, int count, int8_t* out)
+{
+    if (!games || !out || count <= 0 || !games[0]) return 0;
+    int size = games[0]->board.size();
+    for (int i = 1; i < count; ++i) {
+        if (!games[i] || games[i]->board.size() != size) return 0;
+    }
+    for (int i = 0; i < count; ++i) {
+        out += writeBoard(games[i]->board, out);
+    }
+    return 1;
+}
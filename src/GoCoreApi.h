@@ -0,0 +1,112 @@
+#pragma once
+
+// 围棋规则核心的C接口，编译成共享库gocore，供训练、统计等其它语言的程序通过FFI调用
+// 只用C类型，句柄不透明；点按row * size + col编号，GOCORE_PASS为虚着
+// 出错（空句柄、越界、非法着法、内存不足）一律通过返回值表示，不抛异常、不打印
+// 批量接口一次调用处理多手棋或多盘棋，摊薄每次跨语言调用的开销
+// 同一盘棋不能被多个线程同时调用，不同的盘之间互不影响
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(GOCORE_API_BUILD)
+#    define GOCORE_API __declspec(dllexport)
+#  else
+#    define GOCORE_API __declspec(dllimport)
+#  endif
+#else
+#  define GOCORE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 接口有不兼容的改动时加一
+#define GOCORE_API_VERSION 1
+
+#define GOCORE_EMPTY 0
+#define GOCORE_BLACK 1
+#define GOCORE_WHITE 2
+
+#define GOCORE_PASS (-1)
+#define GOCORE_MAX_SIZE 19
+// 合法着点位集的64位字数，第i点在words[i / 64]的第i % 64位
+#define GOCORE_BITSET_WORDS 6
+
+// gocore_legal_moves的选项
+#define GOCORE_SKIP_OWN_EYES 1 // 去掉己方的简单眼
+#define GOCORE_SUPERKO 2       // 去掉造成全局同形的点，只认得还能撤销的局面
+
+typedef struct gocore_game gocore_game;
+
+GOCORE_API int gocore_api_version(void);
+
+// 创建size路（5-19）的空棋盘，黑先；size不合法时返回NULL
+GOCORE_API gocore_game* gocore_create(int size);
+GOCORE_API gocore_game* gocore_clone(const gocore_game* game);
+GOCORE_API void gocore_destroy(gocore_game* game);
+GOCORE_API void gocore_reset(gocore_game* game);
+
+// 关闭记录后不能撤销，落子更快（用于快速走子）；关闭时清空已有的撤销记录
+GOCORE_API void gocore_set_recording(gocore_game* game, int enabled);
+
+GOCORE_API int gocore_size(const gocore_game* game);
+GOCORE_API int gocore_to_play(const gocore_game* game);
+GOCORE_API int gocore_at(const gocore_game* game, int point);
+// 局面键：棋子哈希再混入轮到谁下和劫点
+GOCORE_API uint64_t gocore_hash(const gocore_game* game);
+// 劫点，没有时返回GOCORE_PASS
+GOCORE_API int gocore_ko_point(const gocore_game* game);
+// color被提的子数
+GOCORE_API int gocore_captured(const gocore_game* game, int color);
+// 把size * size个点写入out，值为GOCORE_EMPTY/BLACK/WHITE；返回点数
+GOCORE_API int gocore_board(const gocore_game* game, int8_t* out);
+
+// 摆子（让子、题目局面）：成为新的起点，清空撤销记录；失败时棋盘不变，返回0
+GOCORE_API int gocore_setup(gocore_game* game, const int* black, int blackCount,
+                            const int* white, int whiteCount, int toPlay);
+
+// 轮到的一方下在point（可为GOCORE_PASS）；非法时棋盘不变，返回0
+GOCORE_API int gocore_play(gocore_game* game, int point);
+GOCORE_API int gocore_is_legal(const gocore_game* game, int point);
+// 撤销一手，没有可撤销的返回0
+GOCORE_API int gocore_undo(gocore_game* game);
+// 上一手提掉的子数
+GOCORE_API int gocore_last_captures(const gocore_game* game);
+
+// 轮到的一方的合法着点（不含虚着）写入words[GOCORE_BITSET_WORDS]，返回个数
+GOCORE_API int gocore_legal_moves(const gocore_game* game, int flags, uint64_t* words);
+
+// 数子（棋子+只与一方相邻的空区域），black、white可为NULL；返回黑减白再减komi
+GOCORE_API double gocore_score(const gocore_game* game, double komi, int* black, int* white);
+
+// 批量接口
+
+// 依次下points中的count手，遇到非法着法就停在它之前；返回实际下了的手数
+GOCORE_API int gocore_play_many(gocore_game* game, const int* points, int count);
+// 撤销至多count手，返回实际撤销的手数
+GOCORE_API int gocore_undo_many(gocore_game* game, int count);
+
+// 对count个候选点各试下一手再撤销，局面不变：
+// captures[i]为提子数，非法时为-1；hashes可为NULL，非NULL时写入试下后的局面键
+// 需要记录开着；返回合法的候选个数，记录关着时返回-1
+GOCORE_API int gocore_try_moves(gocore_game* game, const int* points, int count,
+                                int* captures, uint64_t* hashes);
+
+// 多盘棋各下一手：games[i]下points[i]，ok非NULL时写入各盘是否成功；返回成功的盘数
+GOCORE_API int gocore_play_batch(gocore_game* const* games, const int* points, int count, int8_t* ok);
+
+// 多盘棋的合法着点：words按盘连续存放，每盘GOCORE_BITSET_WORDS个字；counts可为NULL
+GOCORE_API void gocore_legal_moves_batch(const gocore_game* const* games, int count, int flags,
+                                         uint64_t* words, int* counts);
+
+// 多盘棋的数子结果，out[i]同gocore_score的返回值
+GOCORE_API void gocore_score_batch(const gocore_game* const* games, int count, double komi, double* out);
+
+// 多盘棋的棋面，out按盘连续存放，每盘size * size个点；各盘须同样大小，否则返回0
+GOCORE_API int gocore_board_batch(const gocore_game* const* games, int count, int8_t* out);
+
+#ifdef __cplusplus
+}
+#endif
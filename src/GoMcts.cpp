@@ -0,0 +1,266 @@
+// GoMcts.cpp
+#include "GoMcts.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const float EXPLORATION = 1.0f;
+const float FIRST_PLAY_URGENCY = 1.1f; // 未访问的子结点先于已访问的被选中
+const int EXPAND_VISITS = 2;
+const int REUSE_PLIES = 4; // reusePosition最多往回找的手数
+
+} // namespace
+
+GoMcts::GoMcts(PlayoutPolicy policy, const GoPatterns* patterns)
+    : m_playout(policy, patterns)
+    , m_komi(6.5)
+    , m_maxNodes(1 << 20)
+    , m_ownershipSum(GoBoard::MAX_POINTS, 0.0f)
+    , m_ownershipSamples(0)
+{
+    m_root.setRecording(false);
+    setPosition(m_root);
+}
+
+void GoMcts::setKomi(double komi)
+{
+    m_komi = komi;
+    m_playout.setKomi(komi);
+}
+
+void GoMcts::setPosition(const GoBoard& board)
+{
+    m_root = board;
+    m_root.setRecording(false);
+    clearTree();
+}
+
+void GoMcts::clearTree()
+{
+    m_nodes.clear();
+    m_nodes.push_back({GoBoard::NO_POINT, -1, 0, 0, 0.0f});
+    std::fill(m_ownershipSum.begin(), m_ownershipSum.end(), 0.0f);
+    m_ownershipSamples = 0;
+}
+
+bool GoMcts::advance(int move)
+{
+    const Node& oldRoot = m_nodes[0];
+    int next = -1;
+    for (int i = 0; i < oldRoot.childCount; ++i) {
+        if (m_nodes[oldRoot.firstChild + i].move == move) {
+            next = oldRoot.firstChild + i;
+            break;
+        }
+    }
+    if (!m_root.play(move, m_root.toPlay()) || next < 0) {
+        clearTree();
+        return false;
+    }
+
+    // 收集新根以下的子结点区间：列表本身当队列，区间里展开过的结点再把自己的区间加进来
+    Node root = m_nodes[next];
+    root.wins = root.visits - root.wins; // 根结点的胜场按轮到的一方计，与它作子结点时相反
+    m_kept.clear();
+    if (root.firstChild >= 0) m_kept.push_back({root.firstChild, root.childCount, 0});
+    for (size_t k = 0; k < m_kept.size(); ++k) {
+        for (int i = m_kept[k].first; i < m_kept[k].first + m_kept[k].count; ++i) {
+            const Node& node = m_nodes[i];
+            if (node.firstChild >= 0) m_kept.push_back({node.firstChild, node.childCount, 0});
+        }
+    }
+    // 区间按旧位置排序后整段原地前移：新位置不超过旧位置，不会覆盖还没搬的区间
+    std::sort(m_kept.begin(), m_kept.end(), [](const Block& a, const Block& b) { return a.first < b.first; });
+    int size = 1;
+    for (Block& block : m_kept) {
+        block.moved = size;
+        if (block.moved != block.first) {
+            std::copy(m_nodes.begin() + block.first, m_nodes.begin() + block.first + block.count,
+                      m_nodes.begin() + block.moved);
+        }
+        size += block.count;
+    }
+    m_nodes[0] = root;
+    for (int i = 0; i < size; ++i) {
+        if (m_nodes[i].firstChild >= 0) m_nodes[i].firstChild = movedBlock(m_nodes[i].firstChild);
+    }
+    // 数组截短，其余分支一次丢弃，容量留着
+    m_nodes.resize(size);
+    std::fill(m_ownershipSum.begin(), m_ownershipSum.end(), 0.0f);
+    m_ownershipSamples = 0;
+    return true;
+}
+
+int GoMcts::movedBlock(int first) const
+{
+    auto it = std::lower_bound(m_kept.begin(), m_kept.end(), first,
+                               [](const Block& block, int value) { return block.first < value; });
+    return it->moved;
+}
+
+bool GoMcts::reusePosition(const GoBoard& board)
+{
+    // 从board往回退，直到回到当前根局面
+    uint64_t rootKey = m_root.positionKey();
+    int moves[REUSE_PLIES];
+    int count = 0;
+    bool sameSize = board.size() == m_root.size();
+    bool found = sameSize && board.positionKey() == rootKey;
+    if (!found && sameSize && board.canUndo()) {
+        GoBoard previous = board;
+        while (!found && count < REUSE_PLIES && previous.canUndo()) {
+            moves[count++] = previous.lastMove();
+            previous.undo();
+            found = previous.positionKey() == rootKey;
+        }
+    }
+
+    bool reused = found;
+    for (int i = count; i-- > 0 && reused;) {
+        reused = advance(moves[i]);
+    }
+    m_root = board;
+    m_root.setRecording(false);
+    if (!reused) clearTree();
+    return reused;
+}
+
+void GoMcts::expand(int index, const GoBoard& board)
+{
+    // 子结点：所有合法且不填己方眼的点，外加虚着
+    if (static_cast<int>(m_nodes.size()) + board.emptyCount() + 1 > m_maxNodes) return;
+    PieceColor color = board.toPlay();
+    int first = static_cast<int>(m_nodes.size());
+    for (int i = 0; i < board.emptyCount(); ++i) {
+        int p = board.emptyPoint(i);
+        if (!board.isSimpleEye(p, color) && board.isLegal(p, color)) {
+            m_nodes.push_back({p, -1, 0, 0, 0.0f});
+        }
+    }
+    m_nodes.push_back({GoBoard::PASS_MOVE, -1, 0, 0, 0.0f});
+    m_nodes[index].firstChild = first;
+    m_nodes[index].childCount = static_cast<int>(m_nodes.size()) - first;
+}
+
+int GoMcts::selectChild(int index) const
+{
+    const Node& parent = m_nodes[index];
+    float logVisits = std::log(static_cast<float>(parent.visits + 1));
+    int best = parent.firstChild;
+    float bestScore = -1.0f;
+    for (int i = 0; i < parent.childCount; ++i) {
+        const Node& child = m_nodes[parent.firstChild + i];
+        float score;
+        if (child.visits == 0) {
+            // 虚着只在没有别的未访问点时才试
+            score = child.move == GoBoard::PASS_MOVE ? 0.0f : FIRST_PLAY_URGENCY;
+        } else {
+            score = child.wins / child.visits + EXPLORATION * std::sqrt(logVisits / child.visits);
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            best = parent.firstChild + i;
+        }
+    }
+    return best;
+}
+
+void GoMcts::search(int iterations, FastRng& rng)
+{
+    for (int n = 0; n < iterations; ++n) {
+        GoBoard board = m_root;
+        m_path.clear();
+        m_path.push_back(0);
+
+        // 选点：沿已扩展的结点下行，访问足够多的叶子就地扩展
+        int index = 0;
+        int passes = 0;
+        while (passes < 2) {
+            if (m_nodes[index].firstChild < 0) {
+                if (m_nodes[index].visits < EXPAND_VISITS) break;
+                expand(index, board);
+                if (m_nodes[index].firstChild < 0) break;
+            }
+            index = selectChild(index);
+            int move = m_nodes[index].move;
+            board.play(move, board.toPlay());
+            passes = move == GoBoard::PASS_MOVE ? passes + 1 : 0;
+            m_path.push_back(index);
+        }
+
+        PlayoutResult result = m_playout.run(board, rng);
+        accumulateOwnership(board);
+
+        // 回传：结点的胜场按走出该着的一方计（奇数层为根局面轮到的一方），根结点也记轮到的一方
+        bool rootSideWon = result.winner() == m_root.toPlay();
+        for (size_t i = 0; i < m_path.size(); ++i) {
+            Node& node = m_nodes[m_path[i]];
+            node.visits++;
+            bool rootSideMoved = i == 0 || i % 2 == 1;
+            if (rootSideMoved == rootSideWon) node.wins += 1.0f;
+        }
+    }
+}
+
+void GoMcts::accumulateOwnership(const GoBoard& board)
+{
+    // 棋子归本方，空点只与一方相邻时归该方
+    for (int row = 0; row < board.size(); ++row) {
+        for (int col = 0; col < board.size(); ++col) {
+            int p = board.point(row, col);
+            int cell = board.cell(p);
+            if (cell == GoBoard::Empty) {
+                bool black = false, white = false;
+                for (int i = 0; i < 4; ++i) {
+                    int n = board.cell(p + board.neighbour8(i));
+                    black = black || n == GoBoard::Black;
+                    white = white || n == GoBoard::White;
+                }
+                cell = black == white ? GoBoard::Empty : (black ? GoBoard::Black : GoBoard::White);
+            }
+            if (cell == GoBoard::Black) {
+                m_ownershipSum[p] += 1.0f;
+            } else if (cell == GoBoard::White) {
+                m_ownershipSum[p] -= 1.0f;
+            }
+        }
+    }
+    m_ownershipSamples++;
+}
+
+float GoMcts::ownership(int p) const
+{
+    return m_ownershipSamples > 0 ? m_ownershipSum[p] / m_ownershipSamples : 0.0f;
+}
+
+float GoMcts::rootWinRate() const
+{
+    const Node& root = m_nodes[0];
+    return root.visits > 0 ? root.wins / root.visits : 0.5f;
+}
+
+int GoMcts::bestMove() const
+{
+    std::vector<Candidate> best;
+    candidates(best, 1);
+    return best.empty() ? GoBoard::PASS_MOVE : best[0].move;
+}
+
+void GoMcts::candidates(std::vector<Candidate>& out, int maxCount) const
+{
+    out.clear();
+    const Node& root = m_nodes[0];
+    if (root.firstChild < 0) return;
+    for (int i = 0; i < root.childCount; ++i) {
+        const Node& child = m_nodes[root.firstChild + i];
+        if (child.visits == 0) continue;
+        Candidate candidate;
+        candidate.move = child.move;
+        candidate.visits = child.visits;
+        candidate.winRate = child.wins / child.visits;
+        out.push_back(candidate);
+    }
+    std::sort(out.begin(), out.end(), [](const Candidate& a, const Candidate& b) { return a.visits > b.visits; });
+    if (static_cast<int>(out.size()) > maxCount) out.resize(maxCount);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include "FastRng.h"
+#include "GoBoard.h"
+#include "GoPlayout.h"
+
+// 蒙特卡洛树搜索（UCT），结点连续存放在一个数组里，子结点按区间引用
+// 每次迭代从根局面拷贝一份棋盘，沿树选点、扩展、走子到终局并回传胜负，同时累计各点归属
+// 走棋后可保留实际着法下的子树：它的子结点区间在数组里整段原地前移，其余分支随数组截短一次丢弃（结点是纯数据）
+class GoMcts {
+public:
+    struct Candidate {
+        int move = GoBoard::PASS_MOVE;
+        int visits = 0;
+        float winRate = 0.0f; // 根局面轮到的一方的胜率
+    };
+
+    explicit GoMcts(PlayoutPolicy policy = PlayoutPolicy::Tactical, const GoPatterns* patterns = nullptr);
+
+    void setKomi(double komi);
+    void setMaxNodes(int maxNodes) { m_maxNodes = maxNodes; }
+    // 换局面，整棵树作废
+    void setPosition(const GoBoard& board);
+    // 根局面走了move（哪一方的都行）：该子结点下的子树留作新树，其余丢弃；没有这个子结点时树清空，返回false
+    bool advance(int move);
+    // board是当前根之后几手的局面时（从board的撤销记录里找），沿这几手advance，否则同setPosition
+    // 返回是否保留了旧的搜索
+    bool reusePosition(const GoBoard& board);
+    const GoBoard& position() const { return m_root; }
+
+    void search(int iterations, FastRng& rng);
+
+    int iterations() const { return m_nodes.empty() ? 0 : m_nodes[0].visits; }
+    int nodeCount() const { return static_cast<int>(m_nodes.size()); }
+    int bestMove() const;
+    float rootWinRate() const;
+    // 按访问次数从多到少
+    void candidates(std::vector<Candidate>& out, int maxCount) const;
+    // 各点终局归属的平均值，黑为正，[-1, 1]
+    float ownership(int p) const;
+
+private:
+    struct Node {
+        int move;
+        int firstChild;  // -1表示未扩展
+        int childCount;
+        int visits;
+        float wins;      // 以走出move的一方计
+    };
+
+    // 一段连续的子结点，advance搬动时用
+    struct Block {
+        int first;
+        int count;
+        int moved; // 搬动后的起点
+    };
+
+    GoBoard m_root;
+    GoPlayout m_playout;
+    double m_komi;
+    int m_maxNodes;
+    std::vector<Node> m_nodes;
+    std::vector<Block> m_kept; // advance时要保留的子结点区间
+    std::vector<int> m_path;
+    std::vector<float> m_ownershipSum;
+    int m_ownershipSamples;
+
+    void clearTree();
+    int movedBlock(int first) const;
+    void expand(int index, const GoBoard& board);
+    int selectChild(int index) const;
+    void accumulateOwnership(const GoBoard& board);
+};
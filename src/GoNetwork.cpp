@@ -0,0 +1,480 @@
+// GoNetwork.cpp
+#include "GoNetwork.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GO_NETWORK_MMAP 1
+#endif
+
+// AVX2内核：GCC/Clang按函数开启目标指令集并在运行时检测，MSVC需以/arch:AVX2编译
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GO_NETWORK_HAS_AVX2 1
+#define GO_NETWORK_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(__AVX2__)
+#include <immintrin.h>
+#define GO_NETWORK_HAS_AVX2 1
+#define GO_NETWORK_AVX2_TARGET
+#endif
+
+namespace {
+
+const int HEADER_BYTES = 32;
+const uint32_t FILE_VERSION = 1;
+
+using DotKernel = int32_t (*)(const int16_t* const taps[9], const int16_t* weights, int channels);
+
+int32_t dot9Scalar(const int16_t* const taps[9], const int16_t* weights, int channels)
+{
+    int32_t sum = 0;
+    for (int t = 0; t < 9; ++t) {
+        const int16_t* in = taps[t];
+        const int16_t* w = weights + t * channels;
+        for (int k = 0; k < channels; ++k) {
+            sum += in[k] * w[k];
+        }
+    }
+    return sum;
+}
+
+#ifdef GO_NETWORK_HAS_AVX2
+GO_NETWORK_AVX2_TARGET
+int32_t dot9Avx2(const int16_t* const taps[9], const int16_t* weights, int channels)
+{
+    // 每次16个int16相乘、相邻两两相加成8个int32
+    __m256i acc = _mm256_setzero_si256();
+    for (int t = 0; t < 9; ++t) {
+        const int16_t* in = taps[t];
+        const int16_t* w = weights + t * channels;
+        for (int k = 0; k < channels; k += 16) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + k));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + k));
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+        }
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+DotKernel selectKernel()
+{
+#ifdef GO_NETWORK_HAS_AVX2
+    if (GoNetwork::hasAvx2()) return dot9Avx2;
+#endif
+    return dot9Scalar;
+}
+
+float dot(const float* a, const float* b, int n)
+{
+    float sum = 0.0f;
+    for (int k = 0; k < n; ++k) {
+        sum += a[k] * b[k];
+    }
+    return sum;
+}
+
+uint32_t readUint32(const char* data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+GoNetwork::GoNetwork()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_mapped(false)
+    , m_channels(0)
+    , m_blocks(0)
+    , m_valueHidden(0)
+    , m_policyWeights(nullptr)
+    , m_policyBias(nullptr)
+    , m_passWeights(nullptr)
+    , m_passBias(nullptr)
+    , m_valueWeights1(nullptr)
+    , m_valueBias1(nullptr)
+    , m_valueWeights2(nullptr)
+    , m_valueBias2(nullptr)
+    , m_precision(Precision::Auto)
+{
+}
+
+GoNetwork::~GoNetwork()
+{
+    unload();
+}
+
+bool GoNetwork::hasAvx2()
+{
+#if defined(GO_NETWORK_HAS_AVX2) && defined(__GNUC__)
+    return __builtin_cpu_supports("avx2");
+#elif defined(GO_NETWORK_HAS_AVX2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+GoNetwork::Precision GoNetwork::precision() const
+{
+    if (m_precision != Precision::Auto) return m_precision;
+    return hasAvx2() ? Precision::Int16 : Precision::Float32;
+}
+
+void GoNetwork::unload()
+{
+#ifdef GO_NETWORK_MMAP
+    if (m_mapped && m_data) munmap(m_data, m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_buffer.clear();
+    m_convs.clear();
+    m_channels = 0;
+    m_blocks = 0;
+    m_valueHidden = 0;
+}
+
+bool GoNetwork::load(const std::string& path, std::string* error)
+{
+    unload();
+
+#ifdef GO_NETWORK_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                m_data = data;
+                m_size = static_cast<size_t>(info.st_size);
+                m_mapped = true;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    if (!m_data) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            if (error) *error = "cannot open " + path;
+            return false;
+        }
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+
+    const char* bytes = static_cast<const char*>(m_data);
+    if (m_size < HEADER_BYTES || std::memcmp(bytes, "GONN", 4) != 0 || readUint32(bytes + 4) != FILE_VERSION) {
+        if (error) *error = "not a network file: " + path;
+        unload();
+        return false;
+    }
+    int planes = static_cast<int>(readUint32(bytes + 8));
+    int channels = static_cast<int>(readUint32(bytes + 12));
+    int blocks = static_cast<int>(readUint32(bytes + 16));
+    int hidden = static_cast<int>(readUint32(bytes + 20));
+    if (planes != FEATURE_PLANES || channels <= 0 || channels > 1024 || blocks < 0 || blocks > 128 ||
+        hidden <= 0 || hidden > 4096) {
+        if (error) *error = "unsupported network shape in " + path;
+        unload();
+        return false;
+    }
+
+    size_t floats = static_cast<size_t>(channels) * 9 * planes + channels
+                    + static_cast<size_t>(blocks) * 2 * (static_cast<size_t>(channels) * 9 * channels + channels)
+                    + channels + 1 + channels + 1
+                    + static_cast<size_t>(hidden) * channels + hidden + hidden + 1;
+    if (m_size < HEADER_BYTES + floats * sizeof(float)) {
+        if (error) *error = "truncated network file: " + path;
+        unload();
+        return false;
+    }
+
+    m_channels = channels;
+    m_blocks = blocks;
+    m_valueHidden = hidden;
+    const float* cursor = reinterpret_cast<const float*>(bytes + HEADER_BYTES);
+    auto take = [&cursor](size_t count) {
+        const float* begin = cursor;
+        cursor += count;
+        return begin;
+    };
+    auto addConv = [&](int inChannels) {
+        ConvLayer layer;
+        layer.inChannels = inChannels;
+        layer.paddedIn = (inChannels + 15) / 16 * 16;
+        layer.weights = take(static_cast<size_t>(channels) * 9 * inChannels);
+        layer.bias = take(channels);
+        m_convs.push_back(std::move(layer));
+    };
+
+    addConv(planes);
+    for (int b = 0; b < blocks; ++b) {
+        addConv(channels);
+        addConv(channels);
+    }
+    m_policyWeights = take(channels);
+    m_policyBias = take(1);
+    m_passWeights = take(channels);
+    m_passBias = take(1);
+    m_valueWeights1 = take(static_cast<size_t>(hidden) * channels);
+    m_valueBias1 = take(hidden);
+    m_valueWeights2 = take(hidden);
+    m_valueBias2 = take(1);
+
+    for (auto& layer : m_convs) {
+        quantise(layer);
+    }
+    return true;
+}
+
+void GoNetwork::quantise(ConvLayer& layer)
+{
+    // 每个输出通道单独取比例，使最大绝对值映射到127
+    layer.quantised.assign(static_cast<size_t>(m_channels) * 9 * layer.paddedIn, 0);
+    layer.scales.assign(m_channels, 1.0f);
+    for (int o = 0; o < m_channels; ++o) {
+        const float* w = layer.weights + static_cast<size_t>(o) * 9 * layer.inChannels;
+        float maxAbs = 0.0f;
+        for (int k = 0; k < 9 * layer.inChannels; ++k) {
+            maxAbs = std::max(maxAbs, std::fabs(w[k]));
+        }
+        float scale = maxAbs > 0.0f ? 127.0f / maxAbs : 1.0f;
+        layer.scales[o] = scale;
+        int16_t* q = layer.quantised.data() + static_cast<size_t>(o) * 9 * layer.paddedIn;
+        for (int t = 0; t < 9; ++t) {
+            for (int k = 0; k < layer.inChannels; ++k) {
+                q[t * layer.paddedIn + k] = static_cast<int16_t>(std::lround(w[t * layer.inChannels + k] * scale));
+            }
+        }
+    }
+}
+
+void GoNetwork::convolve(const ConvLayer& layer, const float* input, float* output, int side, bool useInt16,
+                         std::vector<int16_t>& scratch) const
+{
+    const int grid = side + 2;
+    const int inC = layer.inChannels;
+    const int offsets[9] = {-grid - 1, -grid, -grid + 1, -1, 0, 1, grid - 1, grid, grid + 1};
+
+    if (!useInt16) {
+        for (int r = 1; r <= side; ++r) {
+            for (int c = 1; c <= side; ++c) {
+                int pix = r * grid + c;
+                float* out = output + static_cast<size_t>(pix) * m_channels;
+                for (int o = 0; o < m_channels; ++o) {
+                    const float* w = layer.weights + static_cast<size_t>(o) * 9 * inC;
+                    float sum = layer.bias[o];
+                    for (int t = 0; t < 9; ++t) {
+                        sum += dot(input + static_cast<size_t>(pix + offsets[t]) * inC, w + t * inC, inC);
+                    }
+                    out[o] = sum;
+                }
+            }
+        }
+        return;
+    }
+
+    // 本局面本层的激活比例：最大绝对值映射到127
+    float maxAbs = 0.0f;
+    for (int i = 0; i < grid * grid * inC; ++i) {
+        maxAbs = std::max(maxAbs, std::fabs(input[i]));
+    }
+    float inputScale = maxAbs > 0.0f ? 127.0f / maxAbs : 1.0f;
+
+    const int padded = layer.paddedIn;
+    scratch.assign(static_cast<size_t>(grid) * grid * padded, 0);
+    for (int pix = 0; pix < grid * grid; ++pix) {
+        for (int k = 0; k < inC; ++k) {
+            scratch[static_cast<size_t>(pix) * padded + k] =
+                static_cast<int16_t>(std::lround(input[static_cast<size_t>(pix) * inC + k] * inputScale));
+        }
+    }
+
+    static const DotKernel dot9 = selectKernel();
+    const int16_t* taps[9];
+    for (int r = 1; r <= side; ++r) {
+        for (int c = 1; c <= side; ++c) {
+            int pix = r * grid + c;
+            for (int t = 0; t < 9; ++t) {
+                taps[t] = scratch.data() + static_cast<size_t>(pix + offsets[t]) * padded;
+            }
+            float* out = output + static_cast<size_t>(pix) * m_channels;
+            for (int o = 0; o < m_channels; ++o) {
+                int32_t acc = dot9(taps, layer.quantised.data() + static_cast<size_t>(o) * 9 * padded, padded);
+                out[o] = layer.bias[o] + static_cast<float>(acc) / (inputScale * layer.scales[o]);
+            }
+        }
+    }
+}
+
+GoNetwork::Input GoNetwork::inputFromBoard(const GoBoard& board)
+{
+    Input input;
+    input.board = &board;
+    input.history[0] = board.lastMove();
+    return input;
+}
+
+void GoNetwork::buildFeatures(const Input& input, float* planes, int side)
+{
+    // 调用方已清零；平面顺序：
+    // 0 己方子 1 对方子 2 空点 3-5 己方1/2/3+气 6-8 对方1/2/3+气 9 劫点 10-13 最近四手 14 黑方下 15 棋盘内
+    const GoBoard& board = *input.board;
+    const int grid = side + 2;
+    int own = static_cast<int>(board.toPlay());
+    int liberties[GoBoard::MAX_POINTS];
+    std::fill(liberties, liberties + GoBoard::MAX_POINTS, 0);
+
+    for (int row = 0; row < side; ++row) {
+        for (int col = 0; col < side; ++col) {
+            int p = board.point(row, col);
+            float* f = planes + static_cast<size_t>((row + 1) * grid + col + 1) * FEATURE_PLANES;
+            int cell = board.cell(p);
+            if (cell == GoBoard::Empty) {
+                f[2] = 1.0f;
+            } else {
+                int root = board.groupOf(p);
+                if (liberties[root] == 0) liberties[root] = board.libertyCount(p, 3);
+                int libs = std::min(std::max(liberties[root], 1), 3);
+                bool mine = cell == own;
+                f[mine ? 0 : 1] = 1.0f;
+                f[(mine ? 2 : 5) + libs] = 1.0f;
+            }
+            if (own == GoBoard::Black) f[14] = 1.0f;
+            f[15] = 1.0f;
+        }
+    }
+
+    auto mark = [&](int p, int plane) {
+        if (p == GoBoard::NO_POINT || p == GoBoard::PASS_MOVE || !board.isOnBoard(p)) return;
+        planes[static_cast<size_t>((board.rowOf(p) + 1) * grid + board.colOf(p) + 1) * FEATURE_PLANES + plane] = 1.0f;
+    };
+    if (static_cast<int>(board.koColor()) == own) mark(board.koPoint(), 9);
+    for (int h = 0; h < HISTORY_MOVES; ++h) {
+        mark(input.history[h], 10 + h);
+    }
+}
+
+void GoNetwork::evaluate(const Input* inputs, Output* outputs, int count) const
+{
+    if (!isLoaded() || count <= 0) return;
+
+    const bool useInt16 = precision() == Precision::Int16;
+    const int C = m_channels;
+    std::vector<int> sides(count);
+    std::vector<size_t> offsets(count + 1, 0);
+    for (int i = 0; i < count; ++i) {
+        sides[i] = inputs[i].board->size();
+        offsets[i + 1] = offsets[i] + static_cast<size_t>(sides[i] + 2) * (sides[i] + 2);
+    }
+    const size_t pixels = offsets[count];
+
+    std::vector<float> features(pixels * FEATURE_PLANES, 0.0f);
+    std::vector<float> x(pixels * C, 0.0f), y(pixels * C, 0.0f), z(pixels * C, 0.0f);
+    std::vector<int16_t> scratch;
+    auto relu = [](float* data, size_t n) {
+        for (size_t k = 0; k < n; ++k) {
+            data[k] = std::max(data[k], 0.0f);
+        }
+    };
+
+    // 逐层处理整批局面，同一层权重留在缓存里
+    for (int i = 0; i < count; ++i) {
+        buildFeatures(inputs[i], features.data() + offsets[i] * FEATURE_PLANES, sides[i]);
+        convolve(m_convs[0], features.data() + offsets[i] * FEATURE_PLANES, x.data() + offsets[i] * C, sides[i],
+                 useInt16, scratch);
+    }
+    relu(x.data(), x.size());
+
+    for (int b = 0; b < m_blocks; ++b) {
+        const ConvLayer& first = m_convs[1 + 2 * b];
+        const ConvLayer& second = m_convs[2 + 2 * b];
+        for (int i = 0; i < count; ++i) {
+            convolve(first, x.data() + offsets[i] * C, y.data() + offsets[i] * C, sides[i], useInt16, scratch);
+        }
+        relu(y.data(), y.size());
+        for (int i = 0; i < count; ++i) {
+            convolve(second, y.data() + offsets[i] * C, z.data() + offsets[i] * C, sides[i], useInt16, scratch);
+        }
+        for (size_t k = 0; k < x.size(); ++k) {
+            x[k] = std::max(x[k] + z[k], 0.0f);
+        }
+    }
+
+    std::vector<float> pooled(C), hidden(m_valueHidden);
+    for (int i = 0; i < count; ++i) {
+        const GoBoard& board = *inputs[i].board;
+        Output& out = outputs[i];
+        const int side = sides[i];
+        const int grid = side + 2;
+        const float* act = x.data() + offsets[i] * C;
+
+        std::fill(pooled.begin(), pooled.end(), 0.0f);
+        for (int r = 1; r <= side; ++r) {
+            for (int c = 1; c <= side; ++c) {
+                const float* a = act + static_cast<size_t>(r * grid + c) * C;
+                for (int k = 0; k < C; ++k) {
+                    pooled[k] += a[k];
+                }
+            }
+        }
+        for (int k = 0; k < C; ++k) {
+            pooled[k] /= static_cast<float>(side * side);
+        }
+
+        // 策略：只在合法点上做softmax
+        std::fill(out.policy, out.policy + GoBoard::MAX_POINTS, 0.0f);
+        PieceColor toPlay = board.toPlay();
+        bool legal[GoBoard::MAX_POINTS] = {false};
+        float passLogit = dot(m_passWeights, pooled.data(), C) + m_passBias[0];
+        float maxLogit = passLogit;
+        for (int row = 0; row < side; ++row) {
+            for (int col = 0; col < side; ++col) {
+                int p = board.point(row, col);
+                legal[p] = board.isLegal(p, toPlay);
+                if (!legal[p]) continue;
+                float logit = dot(m_policyWeights, act + static_cast<size_t>((row + 1) * grid + col + 1) * C, C)
+                              + m_policyBias[0];
+                out.policy[p] = logit;
+                maxLogit = std::max(maxLogit, logit);
+            }
+        }
+        out.pass = std::exp(passLogit - maxLogit);
+        float total = out.pass;
+        for (int row = 0; row < side; ++row) {
+            for (int col = 0; col < side; ++col) {
+                int p = board.point(row, col);
+                if (!legal[p]) continue;
+                out.policy[p] = std::exp(out.policy[p] - maxLogit);
+                total += out.policy[p];
+            }
+        }
+        for (int row = 0; row < side; ++row) {
+            for (int col = 0; col < side; ++col) {
+                out.policy[board.point(row, col)] /= total;
+            }
+        }
+        out.pass /= total;
+
+        for (int h = 0; h < m_valueHidden; ++h) {
+            hidden[h] = std::max(dot(m_valueWeights1 + static_cast<size_t>(h) * C, pooled.data(), C) + m_valueBias1[h],
+                                 0.0f);
+        }
+        out.value = std::tanh(dot(m_valueWeights2, hidden.data(), m_valueHidden) + m_valueBias2[0]);
+    }
+}
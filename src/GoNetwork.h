@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GoBoard.h"
+
+// 只用CPU的围棋策略/价值网络推理
+// 残差卷积网络：3x3输入卷积 + blocks个残差块（两层3x3卷积），策略头1x1卷积+虚着线性层，价值头全局平均池化+两层全连接
+// 激活按NHWC排列（每个点的所有通道连续），带一圈零边框，3x3卷积不用判断越界
+// 两条计算路径：
+//   Int16  权重按输出通道、激活按局面动态量化到[-127,127]，用int16乘加（AVX2的madd，没有AVX2时为标量）
+//   Float32 直接使用文件中的float权重
+//
+// 权重文件（小端）：32字节头 "GONN", version=1, inputPlanes, channels, blocks, valueHidden, 0, 0
+// 之后依次为float32数组（批归一化已折叠进卷积）：
+//   输入卷积 w[C][3][3][F] b[C]；每个残差块两层 w[C][3][3][C] b[C]
+//   策略 w[C] b[1]；虚着 w[C] b[1]；价值 w1[H][C] b1[H] w2[H] b2[1]
+// 文件通过mmap映射，Float32路径直接读映射内存
+class GoNetwork {
+public:
+    static const int FEATURE_PLANES = 16;
+    static const int HISTORY_MOVES = 4;
+
+    enum class Precision { Auto, Int16, Float32 };
+
+    struct Input {
+        const GoBoard* board = nullptr;
+        int history[HISTORY_MOVES] = {GoBoard::NO_POINT, GoBoard::NO_POINT, GoBoard::NO_POINT, GoBoard::NO_POINT};
+    };
+
+    // 均以轮到下的一方为视角
+    struct Output {
+        float policy[GoBoard::MAX_POINTS]; // 按棋盘点号，非法点为0
+        float pass;
+        float value;                       // [-1, 1]
+    };
+
+    GoNetwork();
+    ~GoNetwork();
+    GoNetwork(const GoNetwork&) = delete;
+    GoNetwork& operator=(const GoNetwork&) = delete;
+
+    bool load(const std::string& path, std::string* error = nullptr);
+    bool isLoaded() const { return m_data != nullptr; }
+    int channels() const { return m_channels; }
+    int blocks() const { return m_blocks; }
+
+    void setPrecision(Precision precision) { m_precision = precision; }
+    Precision precision() const; // Auto解析后的实际路径
+    static bool hasAvx2();
+
+    // 一批局面逐层计算，同一层的权重在整批中复用；可多线程并发调用
+    void evaluate(const Input* inputs, Output* outputs, int count) const;
+    void evaluate(const Input& input, Output& output) const { evaluate(&input, &output, 1); }
+
+    // history只含上一手，更早的着法需调用方填写
+    static Input inputFromBoard(const GoBoard& board);
+    // 输入平面：(side + 2)^2个点、每点FEATURE_PLANES个值，按NHWC排列并带一圈零边框，planes须已清零
+    // 导出训练数据也用它，保证训练和推理看到的输入一致
+    static void buildFeatures(const Input& input, float* planes, int side);
+
+private:
+    struct ConvLayer {
+        const float* weights;  // [out][9][in]
+        const float* bias;
+        int inChannels;
+        int paddedIn;          // 量化权重按16通道对齐
+        std::vector<int16_t> quantised; // [out][9][paddedIn]
+        std::vector<float> scales;      // 每个输出通道的量化比例
+    };
+
+    // 映射的权重文件
+    void* m_data;
+    size_t m_size;
+    bool m_mapped;
+    std::vector<char> m_buffer; // 不支持mmap时的后备
+
+    int m_channels;
+    int m_blocks;
+    int m_valueHidden;
+    std::vector<ConvLayer> m_convs; // 输入卷积 + 每块两层
+    const float* m_policyWeights;
+    const float* m_policyBias;
+    const float* m_passWeights;
+    const float* m_passBias;
+    const float* m_valueWeights1;
+    const float* m_valueBias1;
+    const float* m_valueWeights2;
+    const float* m_valueBias2;
+    Precision m_precision;
+
+    void unload();
+    void quantise(ConvLayer& layer);
+    void convolve(const ConvLayer& layer, const float* input, float* output, int side, bool useInt16,
+                  std::vector<int16_t>& scratch) const;
+};
@@ -0,0 +1,273 @@
+// GoPatterns.cpp
+#include "GoPatterns.h"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// 3x3邻点的(行,列)偏移，顺序与GoBoard::pattern3的字段一致
+const int NEIGHBOUR_OFFSETS[8][2] = {
+    {-1, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, 1}, {1, 1}, {1, -1}, {-1, -1}
+};
+
+// 菱形图案的12个点
+const int DIAMOND_OFFSETS[12][2] = {
+    {-1, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, 1}, {1, 1}, {1, -1}, {-1, -1},
+    {-2, 0}, {0, 2}, {2, 0}, {0, -2}
+};
+
+void transform(int symmetry, int dr, int dc, int& outRow, int& outCol)
+{
+    // 前4种为旋转，后4种先转置再旋转
+    if (symmetry >= 4) {
+        int tmp = dr;
+        dr = dc;
+        dc = tmp;
+    }
+    for (int i = 0; i < (symmetry & 3); ++i) {
+        int tmp = dr;
+        dr = dc;
+        dc = -tmp;
+    }
+    outRow = dr;
+    outCol = dc;
+}
+
+int indexOf(const int offsets[][2], int count, int dr, int dc)
+{
+    for (int i = 0; i < count; ++i) {
+        if (offsets[i][0] == dr && offsets[i][1] == dc) return i;
+    }
+    return -1;
+}
+
+uint64_t diamondKey(int index, int cell)
+{
+    uint64_t z = 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(index * 4 + cell + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// 一个图案位置允许的(颜色, 是否被打吃)组合
+struct Option {
+    int cell;
+    int atari;
+};
+
+bool optionsFor(char ch, bool orthogonal, std::vector<Option>& options)
+{
+    options.clear();
+    switch (ch) {
+    case '.': options.push_back({GoBoard::Empty, 0}); break;
+    case '#': options.push_back({GoBoard::Border, 0}); break;
+    case 'X':
+        options.push_back({GoBoard::Black, 0});
+        if (orthogonal) options.push_back({GoBoard::Black, 1});
+        break;
+    case 'O':
+        options.push_back({GoBoard::White, 0});
+        if (orthogonal) options.push_back({GoBoard::White, 1});
+        break;
+    case 'x':
+        if (!orthogonal) return false;
+        options.push_back({GoBoard::Black, 1});
+        break;
+    case 'o':
+        if (!orthogonal) return false;
+        options.push_back({GoBoard::White, 1});
+        break;
+    case '?':
+        options.push_back({GoBoard::Empty, 0});
+        options.push_back({GoBoard::Border, 0});
+        options.push_back({GoBoard::Black, 0});
+        options.push_back({GoBoard::White, 0});
+        if (orthogonal) {
+            options.push_back({GoBoard::Black, 1});
+            options.push_back({GoBoard::White, 1});
+        }
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+GoPatterns::GoPatterns()
+    : m_weights(size_t(1) << CODE_BITS, WEIGHT_ONE)
+    , m_patternCount(0)
+{
+}
+
+void GoPatterns::clear()
+{
+    std::fill(m_weights.begin(), m_weights.end(), static_cast<uint16_t>(WEIGHT_ONE));
+    m_diamond.clear();
+    m_patternCount = 0;
+}
+
+int GoPatterns::swapColors(int code)
+{
+    // 每个2位字段中01与10互换，00和11不变
+    int colors = code & 0xFFFF;
+    int lo = colors & 0x5555;
+    int hi = (colors >> 1) & 0x5555;
+    int single = lo ^ hi;
+    return code ^ (single | (single << 1));
+}
+
+int GoPatterns::code3x3(const GoBoard& board, int p, PieceColor toPlay)
+{
+    int code = board.pattern3(p);
+    for (int i = 0; i < 4; ++i) {
+        int n = p + board.neighbour8(i);
+        int cell = board.cell(n);
+        if ((cell == GoBoard::Black || cell == GoBoard::White) && board.isInAtari(n)) {
+            code |= 1 << (16 + i);
+        }
+    }
+    return toPlay == PieceColor::White ? swapColors(code) : code;
+}
+
+uint64_t GoPatterns::diamondHash(const GoBoard& board, int p, PieceColor toPlay)
+{
+    uint64_t hash = 0;
+    int stride = board.stride();
+    for (int i = 0; i < 12; ++i) {
+        int cell = board.cell(p + DIAMOND_OFFSETS[i][0] * stride + DIAMOND_OFFSETS[i][1]);
+        if (toPlay == PieceColor::White && (cell == GoBoard::Black || cell == GoBoard::White)) {
+            cell = GoBoard::opponent(cell);
+        }
+        hash ^= diamondKey(i, cell);
+    }
+    return hash;
+}
+
+int GoPatterns::weight(const GoBoard& board, int p, PieceColor toPlay) const
+{
+    if (!m_diamond.empty()) {
+        auto it = m_diamond.find(diamondHash(board, p, toPlay));
+        if (it != m_diamond.end()) return it->second;
+    }
+    return m_weights[code3x3(board, p, toPlay)];
+}
+
+bool GoPatterns::addPattern(const std::string& pattern, double weight)
+{
+    if (weight < 0) return false;
+    double scaled = std::round(weight * WEIGHT_ONE);
+    uint16_t fixed = static_cast<uint16_t>(scaled > 65535.0 ? 65535.0 : scaled);
+
+    bool ok = false;
+    if (pattern.size() == 9) {
+        ok = add3x3(pattern, fixed);
+    } else if (pattern.size() == 25) {
+        ok = addDiamond(pattern, fixed);
+    }
+    if (ok) m_patternCount++;
+    return ok;
+}
+
+bool GoPatterns::add3x3(const std::string& pattern, uint16_t weight)
+{
+    if (pattern[4] != '.') return false;
+
+    // 文件中按行排列的字符换成邻点字段顺序
+    std::vector<std::vector<Option>> options(8);
+    for (int i = 0; i < 8; ++i) {
+        char ch = pattern[(NEIGHBOUR_OFFSETS[i][0] + 1) * 3 + NEIGHBOUR_OFFSETS[i][1] + 1];
+        if (!optionsFor(ch, i < 4, options[i])) return false;
+    }
+
+    for (int symmetry = 0; symmetry < 8; ++symmetry) {
+        // 变换后第i个字段来自原图案的第source[i]个字段
+        int source[8];
+        for (int i = 0; i < 8; ++i) {
+            int dr, dc;
+            transform(symmetry, NEIGHBOUR_OFFSETS[i][0], NEIGHBOUR_OFFSETS[i][1], dr, dc);
+            source[indexOf(NEIGHBOUR_OFFSETS, 8, dr, dc)] = i;
+        }
+
+        // 枚举通配符的所有组合
+        int choice[8] = {0};
+        while (true) {
+            int code = 0;
+            for (int i = 0; i < 8; ++i) {
+                const Option& option = options[source[i]][choice[source[i]]];
+                code |= option.cell << (2 * i);
+                if (option.atari) code |= 1 << (16 + i);
+            }
+            m_weights[code] = weight;
+
+            int k = 0;
+            while (k < 8 && ++choice[k] == static_cast<int>(options[k].size())) {
+                choice[k++] = 0;
+            }
+            if (k == 8) break;
+        }
+    }
+    return true;
+}
+
+bool GoPatterns::addDiamond(const std::string& pattern, uint16_t weight)
+{
+    if (pattern[12] != '.') return false;
+
+    int cells[12];
+    for (int i = 0; i < 12; ++i) {
+        char ch = pattern[(DIAMOND_OFFSETS[i][0] + 2) * 5 + DIAMOND_OFFSETS[i][1] + 2];
+        switch (ch) {
+        case '.': cells[i] = GoBoard::Empty; break;
+        case 'X': cells[i] = GoBoard::Black; break;
+        case 'O': cells[i] = GoBoard::White; break;
+        case '#': cells[i] = GoBoard::Border; break;
+        default: return false;
+        }
+    }
+
+    for (int symmetry = 0; symmetry < 8; ++symmetry) {
+        uint64_t hash = 0;
+        for (int i = 0; i < 12; ++i) {
+            int dr, dc;
+            transform(symmetry, DIAMOND_OFFSETS[i][0], DIAMOND_OFFSETS[i][1], dr, dc);
+            hash ^= diamondKey(indexOf(DIAMOND_OFFSETS, 12, dr, dc), cells[i]);
+        }
+        m_diamond[hash] = weight;
+    }
+    return true;
+}
+
+bool GoPatterns::loadFromString(const std::string& text, std::string* error)
+{
+    std::istringstream input(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == ';') continue;
+
+        std::istringstream fields(line);
+        std::string pattern;
+        double weight = 0.0;
+        if (!(fields >> pattern >> weight) || !addPattern(pattern, weight)) {
+            if (error) *error = "invalid pattern at line " + std::to_string(lineNumber);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GoPatterns::loadFile(const std::string& path, std::string* error)
+{
+    std::ifstream file(path);
+    if (!file) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return loadFromString(buffer.str(), error);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GoBoard.h"
+
+// 走子策略用的局部图案表
+// 3x3图案：GoBoard增量维护的16位邻点颜色码 + 4位上下左右棋块是否被打吃，共20位，直接查表
+// 菱形图案（曼哈顿距离2以内的12个点）：按需计算Zobrist哈希，在散列表中查找，命中时优先于3x3
+//
+// 图案文件每行一个图案和权重，;开头为注释，同一图案码以后出现的行为准：
+//   3x3:  9个字符按行排列，如 "XOX...??? 3.0"
+//   菱形: 25个字符的5x5方阵，只看距离2以内的点（不可用?和x/o），其余位置写?
+// 字符含义（以轮到下的一方为X）：. 空  X 己方  O 对方  # 棋盘外  ? 任意
+//   x/o 己方/对方且被打吃（只用于上下左右四点，仅3x3）
+// 中心点必须是 . ；加载时自动展开8种对称
+class GoPatterns {
+public:
+    static const int CODE_BITS = 20;
+    static const int WEIGHT_ONE = 256; // 权重按8.8定点数存储
+
+    GoPatterns();
+
+    bool loadFile(const std::string& path, std::string* error = nullptr);
+    bool loadFromString(const std::string& text, std::string* error = nullptr);
+    bool addPattern(const std::string& pattern, double weight);
+    void clear();
+
+    // 落子点的3x3图案码（已换成轮到下的一方为黑的视角）
+    static int code3x3(const GoBoard& board, int p, PieceColor toPlay);
+    static uint64_t diamondHash(const GoBoard& board, int p, PieceColor toPlay);
+
+    int weight(const GoBoard& board, int p, PieceColor toPlay) const;
+    int weightOfCode(int code) const { return m_weights[code]; }
+    bool hasDiamondPatterns() const { return !m_diamond.empty(); }
+    int patternCount() const { return m_patternCount; }
+
+    static int swapColors(int code);
+
+private:
+    std::vector<uint16_t> m_weights;
+    std::unordered_map<uint64_t, uint16_t> m_diamond;
+    int m_patternCount;
+
+    bool add3x3(const std::string& pattern, uint16_t weight);
+    bool addDiamond(const std::string& pattern, uint16_t weight);
+};
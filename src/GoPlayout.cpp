@@ -0,0 +1,265 @@
+// GoPlayout.cpp
+#include "GoPlayout.h"
+#include <algorithm>
+
+GoPlayout::GoPlayout(PlayoutPolicy policy, const GoPatterns* patterns)
+    : m_policy(policy)
+    , m_patterns(patterns)
+    , m_komi(6.5)
+    , m_maxMoves(3 * GoBoard::MAX_SIZE * GoBoard::MAX_SIZE)
+    , m_passAliveInterval(-1)
+    , m_stampValue(0)
+{
+    m_weights[0].resize(GoBoard::MAX_POINTS);
+    m_weights[1].resize(GoBoard::MAX_POINTS);
+    for (int& stamp : m_stamp) {
+        stamp = 0;
+    }
+}
+
+void GoPlayout::setPolicy(PlayoutPolicy policy, const GoPatterns* patterns)
+{
+    m_policy = policy;
+    m_patterns = patterns;
+}
+
+PlayoutResult GoPlayout::run(GoBoard& board, FastRng& rng)
+{
+    PlayoutResult result;
+    board.setRecording(false);
+    if (m_policy == PlayoutPolicy::Pattern) initWeights(board);
+
+    int points = board.size() * board.size();
+    // 一次Benson检查约相当于上百手随机着，默认间隔随棋盘大小增长
+    int interval = m_passAliveInterval >= 0 ? m_passAliveInterval : std::max(16, points / 3);
+    int passes = board.lastMove() == GoBoard::PASS_MOVE ? 1 : 0;
+    while (passes < 2 && result.moves < m_maxMoves) {
+        int previousKo = board.koPoint();
+        int move = selectMove(board, rng);
+        board.play(move, board.toPlay());
+        result.moves++;
+        passes = move == GoBoard::PASS_MOVE ? passes + 1 : 0;
+
+        if (m_policy == PlayoutPolicy::Pattern) updateWeights(board, previousKo);
+
+        // 棋盘基本填满后才可能有大片无条件活棋，定期检查能否提前结束
+        if (interval > 0 && result.moves % interval == 0 && board.emptyCount() * 4 < points &&
+            decidedByPassAlive(board, result)) {
+            return result;
+        }
+    }
+
+    int black = 0, white = 0;
+    board.areaScore(black, white);
+    result.score = black - white - m_komi;
+    return result;
+}
+
+int GoPlayout::selectMove(const GoBoard& board, FastRng& rng)
+{
+    switch (m_policy) {
+    case PlayoutPolicy::Tactical: return selectTactical(board, rng);
+    case PlayoutPolicy::Pattern: return selectPattern(board, rng);
+    default: return selectUniform(board, rng);
+    }
+}
+
+int GoPlayout::selectUniform(const GoBoard& board, FastRng& rng) const
+{
+    // 随机起点后顺序扫描空点列表，第一个合法且不是己方眼的点即为所选
+    PieceColor color = board.toPlay();
+    int count = board.emptyCount();
+    if (count == 0) return GoBoard::PASS_MOVE;
+    int start = static_cast<int>(rng.below(static_cast<uint32_t>(count)));
+    for (int i = 0; i < count; ++i) {
+        int index = start + i;
+        int p = board.emptyPoint(index < count ? index : index - count);
+        if (!board.isSimpleEye(p, color) && board.isLegal(p, color)) return p;
+    }
+    return GoBoard::PASS_MOVE;
+}
+
+int GoPlayout::selectTactical(const GoBoard& board, FastRng& rng) const
+{
+    int last = board.lastMove();
+    if (last == GoBoard::PASS_MOVE || last == GoBoard::NO_POINT) return selectUniform(board, rng);
+
+    PieceColor color = board.toPlay();
+    int c = static_cast<int>(color);
+    int candidates[16];
+    int count = 0;
+
+    // 提掉上一手所在的被打吃棋块
+    if (board.isInAtari(last)) {
+        int lib = board.atariLiberty(last);
+        if (board.isLegal(lib, color)) candidates[count++] = lib;
+    }
+
+    // 上一手打吃了己方棋块：提掉与之相邻的被打吃对方棋块，或者长出后至少有两口气
+    for (int i = 0; i < 4; ++i) {
+        int n = last + board.neighbour8(i);
+        if (board.cell(n) != c || !board.isInAtari(n)) continue;
+
+        int s = n;
+        do {
+            for (int j = 0; j < 4 && count < 15; ++j) {
+                int m = s + board.neighbour8(j);
+                if (board.cell(m) == GoBoard::opponent(c) && board.isInAtari(m)) {
+                    int lib = board.atariLiberty(m);
+                    if (board.isLegal(lib, color)) candidates[count++] = lib;
+                }
+            }
+            s = board.nextStone(s);
+        } while (s != n && count < 15);
+
+        int lib = board.atariLiberty(n);
+        int freeNeighbours = 0;
+        for (int j = 0; j < 4; ++j) {
+            if (board.cell(lib + board.neighbour8(j)) == GoBoard::Empty) freeNeighbours++;
+        }
+        if (freeNeighbours >= 2 && count < 16 && board.isLegal(lib, color)) candidates[count++] = lib;
+    }
+
+    if (count > 0) return candidates[rng.below(static_cast<uint32_t>(count))];
+    return selectUniform(board, rng);
+}
+
+int GoPlayout::selectPattern(const GoBoard& board, FastRng& rng)
+{
+    PieceColor color = board.toPlay();
+    FenwickTree& tree = m_weights[static_cast<int>(color) - 1];
+    while (tree.total() > 0) {
+        int p = tree.find(rng.below(static_cast<uint32_t>(tree.total())));
+        if (board.isLegal(p, color)) return p;
+        tree.set(p, 0); // 增量维护漏掉时的保护，正常不会走到这里
+    }
+    return GoBoard::PASS_MOVE;
+}
+
+void GoPlayout::initWeights(const GoBoard& board)
+{
+    m_weights[0].clear();
+    m_weights[1].clear();
+    m_atariPoints.clear();
+    for (int i = 0; i < board.emptyCount(); ++i) {
+        computeWeight(board, board.emptyPoint(i));
+    }
+}
+
+void GoPlayout::markDirty(int p)
+{
+    if (p == GoBoard::NO_POINT || m_stamp[p] == m_stampValue) return;
+    m_stamp[p] = m_stampValue;
+    m_dirty.push_back(p);
+}
+
+void GoPlayout::updateWeights(const GoBoard& board, int previousKo)
+{
+    // 权重只取决于3x3（或菱形）图案、相邻棋块是否被打吃、合法性和眼位，
+    // 只需重算这些信息可能变化的点
+    if (++m_stampValue == 0) {
+        for (int& stamp : m_stamp) {
+            stamp = 0;
+        }
+        m_stampValue = 1;
+    }
+    m_dirty.clear();
+
+    // 之前与被打吃棋块相邻的点（棋块可能已长出气），以及新旧劫点
+    for (int p : m_atariPoints) {
+        markDirty(p);
+    }
+    m_atariPoints.clear();
+    markDirty(previousKo);
+    markDirty(board.koPoint());
+
+    int move = board.lastMove();
+    if (move != GoBoard::PASS_MOVE) {
+        bool diamond = m_patterns && m_patterns->hasDiamondPatterns();
+        int changed[GoBoard::MAX_POINTS];
+        int changedCount = 0;
+        changed[changedCount++] = move;
+        for (int i = 0; i < board.lastCaptureCount(); ++i) {
+            changed[changedCount++] = board.lastCapturedPoint(i);
+        }
+        for (int k = 0; k < changedCount; ++k) {
+            int p = changed[k];
+            markDirty(p);
+            for (int i = 0; i < 8; ++i) {
+                markDirty(p + board.neighbour8(i));
+            }
+            if (diamond) {
+                for (int i = 0; i < 4; ++i) {
+                    markDirty(p + 2 * board.neighbour8(i));
+                }
+            }
+        }
+
+        // 落子点周围刚被打吃的棋块（含落子所在棋块）的最后一口气
+        for (int i = -1; i < 4; ++i) {
+            int n = i < 0 ? move : move + board.neighbour8(i);
+            int cell = board.cell(n);
+            if ((cell == GoBoard::Black || cell == GoBoard::White) && board.isInAtari(n)) {
+                markDirty(board.atariLiberty(n));
+            }
+        }
+    }
+
+    for (int p : m_dirty) {
+        computeWeight(board, p);
+    }
+}
+
+void GoPlayout::computeWeight(const GoBoard& board, int p)
+{
+    if (board.cell(p) == GoBoard::Border) return;
+    if (board.cell(p) != GoBoard::Empty) {
+        m_weights[0].set(p, 0);
+        m_weights[1].set(p, 0);
+        return;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        int n = p + board.neighbour8(i);
+        int cell = board.cell(n);
+        if ((cell == GoBoard::Black || cell == GoBoard::White) && board.isInAtari(n)) {
+            m_atariPoints.push_back(p);
+            break;
+        }
+    }
+
+    for (int c = GoBoard::Black; c <= GoBoard::White; ++c) {
+        PieceColor color = static_cast<PieceColor>(c);
+        int weight = 0;
+        if (!board.isSimpleEye(p, color) && board.isLegal(p, color)) {
+            weight = m_patterns ? m_patterns->weight(board, p, color) : GoPatterns::WEIGHT_ONE;
+        }
+        m_weights[c - 1].set(p, weight);
+    }
+}
+
+bool GoPlayout::decidedByPassAlive(const GoBoard& board, PlayoutResult& result) const
+{
+    // 无条件活棋及其眼位不会再变，若一方这部分已超过半数（计贴目），胜负已定
+    int owner[GoBoard::MAX_POINTS];
+    board.passAliveArea(owner);
+    int black = 0, white = 0;
+    for (int row = 0; row < board.size(); ++row) {
+        for (int col = 0; col < board.size(); ++col) {
+            int o = owner[board.point(row, col)];
+            if (o == GoBoard::Black) black++;
+            else if (o == GoBoard::White) white++;
+        }
+    }
+
+    int points = board.size() * board.size();
+    if (2 * black > points + m_komi) {
+        result.score = 2 * black - points - m_komi;
+    } else if (2 * white >= points - m_komi) {
+        result.score = points - 2 * white - m_komi;
+    } else {
+        return false;
+    }
+    result.passAlive = true;
+    return true;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include "FastRng.h"
+#include "FenwickTree.h"
+#include "GoBoard.h"
+#include "GoPatterns.h"
+
+// 走子策略
+enum class PlayoutPolicy {
+    Uniform,  // 在合法且不填己方眼的点中均匀随机
+    Tactical, // 优先提掉上一手被打吃的棋块、逃出己方被打吃的棋块，否则均匀随机
+    Pattern   // 按图案权重抽样，权重用树状数组增量维护
+};
+
+struct PlayoutResult {
+    double score = 0.0;      // 黑减白（数子法，已扣贴目）
+    int moves = 0;
+    bool passAlive = false;  // 因无条件活棋已决定胜负而提前结束，此时score按无条件活棋部分估算
+
+    PieceColor winner() const { return score > 0 ? PieceColor::Black : PieceColor::White; }
+};
+
+// 从任意局面把棋下完的走子引擎
+// 每个线程各用一个实例和一个FastRng；run会关闭棋盘的撤销记录并改动棋盘，调用方需先拷贝
+class GoPlayout {
+public:
+    explicit GoPlayout(PlayoutPolicy policy = PlayoutPolicy::Tactical, const GoPatterns* patterns = nullptr);
+
+    void setPolicy(PlayoutPolicy policy, const GoPatterns* patterns = nullptr);
+    PlayoutPolicy policy() const { return m_policy; }
+    void setKomi(double komi) { m_komi = komi; }
+    void setMaxMoves(int maxMoves) { m_maxMoves = maxMoves; }
+    // 每隔interval手检查一次无条件活棋，0表示不检查，负数表示按棋盘大小自动选取
+    void setPassAliveInterval(int interval) { m_passAliveInterval = interval; }
+
+    PlayoutResult run(GoBoard& board, FastRng& rng);
+
+private:
+    PlayoutPolicy m_policy;
+    const GoPatterns* m_patterns;
+    double m_komi;
+    int m_maxMoves;
+    int m_passAliveInterval;
+
+    // 图案策略的增量状态：每种颜色一棵树状数组，按点索引
+    FenwickTree m_weights[2];
+    std::vector<int> m_dirty;
+    std::vector<int> m_atariPoints; // 上次计算时与被打吃棋块相邻的空点
+    int m_stamp[GoBoard::MAX_POINTS];
+    int m_stampValue;
+
+    // 按当前策略为轮到的一方选一手，无点可下时返回PASS_MOVE
+    int selectMove(const GoBoard& board, FastRng& rng);
+    int selectUniform(const GoBoard& board, FastRng& rng) const;
+    int selectTactical(const GoBoard& board, FastRng& rng) const;
+    int selectPattern(const GoBoard& board, FastRng& rng);
+
+    void initWeights(const GoBoard& board);
+    void updateWeights(const GoBoard& board, int previousKo);
+    void markDirty(int p);
+    void computeWeight(const GoBoard& board, int p);
+
+    bool decidedByPassAlive(const GoBoard& board, PlayoutResult& result) const;
+};
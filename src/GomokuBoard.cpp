@@ -0,0 +1,77 @@
+// GomokuBoard.cpp
+#include "GomokuBoard.h"
+
+GomokuBoard::GomokuBoard(int size)
+    : m_size(size < 5 ? 5 : (size > MAX_SIZE ? MAX_SIZE : size))
+    , m_stride(m_size + MARGIN)
+{
+    m_dirs[0] = 1;
+    m_dirs[1] = m_stride;
+    m_dirs[2] = m_stride + 1;
+    m_dirs[3] = m_stride - 1;
+    reset();
+}
+
+const uint64_t* GomokuBoard::zobrist()
+{
+    // 固定种子的splitmix64，与GoBoard的表错开种子
+    static const std::vector<uint64_t> table = [] {
+        std::vector<uint64_t> keys(MAX_POINTS * 2);
+        uint64_t state = 0x2545F4914F6CDD1DULL;
+        for (auto& key : keys) {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key = z ^ (z >> 31);
+        }
+        return keys;
+    }();
+    return table.data();
+}
+
+void GomokuBoard::reset()
+{
+    for (int p = 0; p < MAX_POINTS; ++p) {
+        m_cells[p] = Border;
+    }
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            m_cells[point(row, col)] = Empty;
+        }
+    }
+    m_history.clear();
+    m_hash = 0;
+}
+
+bool GomokuBoard::play(int p, PieceColor color)
+{
+    if (!isOnBoard(p) || m_cells[p] != Empty) return false;
+    m_cells[p] = static_cast<int>(color);
+    m_history.push_back(p);
+    m_hash ^= zobrist()[p * 2 + m_cells[p] - 1];
+    return true;
+}
+
+void GomokuBoard::undo()
+{
+    if (m_history.empty()) return;
+    int p = m_history.back();
+    m_hash ^= zobrist()[p * 2 + m_cells[p] - 1];
+    m_cells[p] = Empty;
+    m_history.pop_back();
+}
+
+int GomokuBoard::lineCode(int p, int d, int color) const
+{
+    int dir = m_dirs[d];
+    int code = 0;
+    for (int i = 1; i <= MARGIN; ++i) {
+        int before = m_cells[p - i * dir];
+        int after = m_cells[p + i * dir];
+        int beforeState = before == Empty ? 0 : (before == color ? 1 : 2);
+        int afterState = after == Empty ? 0 : (after == color ? 1 : 2);
+        code |= beforeState << (2 * (MARGIN - i));
+        code |= afterState << (2 * (MARGIN - 1 + i));
+    }
+    return code;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "ChessPiece.h"
+
+// 不依赖Qt的五子棋棋盘
+// 一维带边框棋盘，四周各留5格边框，落子点两侧各5格的行型窗口不会越界
+class GomokuBoard {
+public:
+    static const int MAX_SIZE = 19;
+    static const int MARGIN = 5;
+    static const int MAX_STRIDE = MAX_SIZE + MARGIN; // 右边框与下一行的左边框共用
+    static const int MAX_POINTS = (MAX_SIZE + 2 * MARGIN) * MAX_STRIDE + MARGIN;
+
+    enum Cell { Empty = 0, Black = 1, White = 2, Border = 3 };
+
+    explicit GomokuBoard(int size = 15);
+
+    void reset();
+    int size() const { return m_size; }
+    int stride() const { return m_stride; }
+
+    // 坐标换算
+    int point(int row, int col) const { return (row + MARGIN) * m_stride + col + MARGIN; }
+    int rowOf(int p) const { return p / m_stride - MARGIN; }
+    int colOf(int p) const { return p % m_stride - MARGIN; }
+    bool isOnBoard(int p) const { return p >= 0 && p < MAX_POINTS && m_cells[p] != Border; }
+
+    int cell(int p) const { return m_cells[p]; }
+    PieceColor at(int p) const { return m_cells[p] == Border ? PieceColor::Empty : static_cast<PieceColor>(m_cells[p]); }
+    // 四个方向（横、竖、右下斜、左下斜）的一维步长
+    int direction(int d) const { return m_dirs[d]; }
+
+    // 落子与撤销，落子点不空时返回false
+    bool play(int p, PieceColor color);
+    void undo();
+    int moveCount() const { return static_cast<int>(m_history.size()); }
+    int lastMove() const { return m_history.empty() ? 0 : m_history.back(); }
+    // 棋子的Zobrist哈希，随落子/撤销增量更新（不含轮到谁下）
+    uint64_t hash() const { return m_hash; }
+
+    // p点沿方向d两侧各5个点的行型码，每点2位：0空 1与color同色 2对方或边框
+    // 按-5..-1、+1..+5的顺序从低位排到高位，p点本身不在码里
+    int lineCode(int p, int d, int color) const;
+
+    static int opponent(int color) { return 3 - color; }
+
+private:
+    int m_size;
+    int m_stride;
+    int m_dirs[4];
+    int m_cells[MAX_POINTS];
+    std::vector<int> m_history;
+    uint64_t m_hash;
+
+    static const uint64_t* zobrist();
+};
@@ -0,0 +1,263 @@
+// GomokuEval.cpp
+#include "GomokuEval.h"
+#include <vector>
+
+namespace {
+
+// 行型窗口：中心点两侧各4格
+const int WINDOW = 9;
+const int CENTER = 4;
+const int LINE_CODES = 6561;  // 3^8，每格空/己方/挡住
+const int RAW_CODES = 65536;  // 4^8，每格直接存棋盘格子的值
+enum { EMPTY = 0, OWN = 1, BLOCKED = 2 };
+
+int runThrough(const int line[WINDOW], int at, int& mask)
+{
+    mask = 0;
+    int length = 0;
+    for (int i = at; i >= 0 && line[i] == OWN; --i) {
+        mask |= 1 << i;
+        length++;
+    }
+    for (int i = at + 1; i < WINDOW && line[i] == OWN; ++i) {
+        mask |= 1 << i;
+        length++;
+    }
+    return length;
+}
+
+// 中心点已有己方棋子时，这条线上是五、活四（含同线双四）、冲四还是都不是
+int fourLevel(int line[WINDOW])
+{
+    int mask;
+    if (runThrough(line, CENTER, mask) >= 5) return GomokuEval::Five;
+
+    int masks[WINDOW];
+    int count = 0;
+    for (int k = 0; k < WINDOW; ++k) {
+        if (line[k] != EMPTY) continue;
+        line[k] = OWN;
+        if (runThrough(line, CENTER, mask) >= 5) masks[count++] = mask & ~(1 << k);
+        line[k] = EMPTY;
+    }
+    if (count == 0) return GomokuEval::None;
+
+    int distinct = 0;
+    for (int i = 0; i < count; ++i) {
+        bool seen = false;
+        for (int j = 0; j < i; ++j) {
+            seen = seen || masks[j] == masks[i];
+        }
+        if (!seen) distinct++;
+    }
+    // 两个成五点补同一个四是活四，补不同的四是同线双四，都挡不住
+    return distinct >= 2 || distinct < count ? GomokuEval::OpenFour : GomokuEval::Four;
+}
+
+// 还没有四时，再下一手能走成活四（活三）还是冲四（眠三）
+int threeLevel(int line[WINDOW])
+{
+    int best = GomokuEval::None;
+    for (int k = 0; k < WINDOW; ++k) {
+        if (line[k] != EMPTY) continue;
+        line[k] = OWN;
+        int four = fourLevel(line);
+        line[k] = EMPTY;
+        if (four >= GomokuEval::OpenFour) return GomokuEval::OpenThree;
+        if (four == GomokuEval::Four) best = GomokuEval::Three;
+    }
+    return best;
+}
+
+int classify(int line[WINDOW])
+{
+    int four = fourLevel(line);
+    if (four != GomokuEval::None) return four;
+    int three = threeLevel(line);
+    if (three != GomokuEval::None) return three;
+
+    for (int k = 0; k < WINDOW; ++k) {
+        if (line[k] != EMPTY) continue;
+        line[k] = OWN;
+        bool openThree = threeLevel(line) == GomokuEval::OpenThree;
+        line[k] = EMPTY;
+        if (openThree) return GomokuEval::OpenTwo;
+    }
+    return GomokuEval::None;
+}
+
+} // namespace
+
+const uint8_t* GomokuEval::table(int s)
+{
+    // 先对3^8种线型分类，再展开成黑白两张以原始格子码为下标的表
+    static const std::vector<uint8_t> tables = [] {
+        std::vector<uint8_t> byLine(LINE_CODES);
+        int line[WINDOW];
+        for (int n = 0; n < LINE_CODES; ++n) {
+            int rest = n;
+            for (int j = 0; j < WINDOW - 1; ++j) {
+                line[j < CENTER ? j : j + 1] = rest % 3;
+                rest /= 3;
+            }
+            line[CENTER] = OWN;
+            byLine[n] = static_cast<uint8_t>(classify(line));
+        }
+
+        std::vector<uint8_t> result(2 * RAW_CODES);
+        for (int side = 0; side < 2; ++side) {
+            int own = side == 0 ? GomokuBoard::Black : GomokuBoard::White;
+            for (int raw = 0; raw < RAW_CODES; ++raw) {
+                int n = 0;
+                for (int j = WINDOW - 2; j >= 0; --j) {
+                    int value = (raw >> (2 * j)) & 3;
+                    n = n * 3 + (value == GomokuBoard::Empty ? EMPTY : (value == own ? OWN : BLOCKED));
+                }
+                result[side * RAW_CODES + raw] = byLine[n];
+            }
+        }
+        return result;
+    }();
+    return tables.data() + s * RAW_CODES;
+}
+
+GomokuEval::GomokuEval(int size)
+    : m_board(size)
+{
+    rebuild();
+}
+
+void GomokuEval::reset()
+{
+    m_board.reset();
+    rebuild();
+}
+
+void GomokuEval::rebuild()
+{
+    for (int s = 0; s < 2; ++s) {
+        for (int shape = 0; shape < SHAPE_COUNT; ++shape) {
+            m_counts[s][shape] = 0;
+        }
+    }
+    for (int p = 0; p < GomokuBoard::MAX_POINTS; ++p) {
+        for (int d = 0; d < 4; ++d) {
+            m_code[d][p] = 0;
+            m_shape[0][d][p] = None;
+            m_shape[1][d][p] = None;
+        }
+    }
+
+    // 码的第0-3组为偏移-4..-1，第4-7组为+1..+4
+    for (int row = 0; row < m_board.size(); ++row) {
+        for (int col = 0; col < m_board.size(); ++col) {
+            int p = m_board.point(row, col);
+            for (int d = 0; d < 4; ++d) {
+                int dir = m_board.direction(d);
+                int code = 0;
+                for (int i = 1; i <= 4; ++i) {
+                    code |= m_board.cell(p - i * dir) << (2 * (4 - i));
+                    code |= m_board.cell(p + i * dir) << (2 * (3 + i));
+                }
+                m_code[d][p] = static_cast<uint16_t>(code);
+                int empty = m_board.cell(p) == GomokuBoard::Empty;
+                for (int s = 0; s < 2; ++s) {
+                    int shape = empty ? table(s)[code] : static_cast<int>(None);
+                    m_shape[s][d][p] = static_cast<uint8_t>(shape);
+                    m_counts[s][shape]++;
+                }
+            }
+        }
+    }
+}
+
+bool GomokuEval::play(int p, PieceColor color)
+{
+    if (!m_board.play(p, color)) return false;
+    for (int d = 0; d < 4; ++d) {
+        setShape(0, d, p, None);
+        setShape(1, d, p, None);
+    }
+    toggle(p, static_cast<int>(color));
+    return true;
+}
+
+void GomokuEval::undo()
+{
+    if (m_board.moveCount() == 0) return;
+    int p = m_board.lastMove();
+    int value = m_board.cell(p);
+    m_board.undo();
+    toggle(p, value);
+    for (int d = 0; d < 4; ++d) {
+        refresh(p, d);
+    }
+}
+
+void GomokuEval::toggle(int q, int value)
+{
+    // q在a的+i处、在b的-i处；空点与棋子的格子值互相异或即可来回切换
+    for (int d = 0; d < 4; ++d) {
+        int dir = m_board.direction(d);
+        for (int i = 1; i <= 4; ++i) {
+            int a = q - i * dir;
+            int b = q + i * dir;
+            if (m_board.isOnBoard(a)) {
+                m_code[d][a] ^= static_cast<uint16_t>(value << (2 * (3 + i)));
+                refresh(a, d);
+            }
+            if (m_board.isOnBoard(b)) {
+                m_code[d][b] ^= static_cast<uint16_t>(value << (2 * (4 - i)));
+                refresh(b, d);
+            }
+        }
+    }
+}
+
+void GomokuEval::refresh(int p, int d)
+{
+    bool empty = m_board.cell(p) == GomokuBoard::Empty;
+    setShape(0, d, p, empty ? table(0)[m_code[d][p]] : static_cast<int>(None));
+    setShape(1, d, p, empty ? table(1)[m_code[d][p]] : static_cast<int>(None));
+}
+
+void GomokuEval::setShape(int s, int d, int p, int shape)
+{
+    m_counts[s][m_shape[s][d][p]]--;
+    m_counts[s][shape]++;
+    m_shape[s][d][p] = static_cast<uint8_t>(shape);
+}
+
+int GomokuEval::shapeWeight(Shape shape)
+{
+    static const int WEIGHTS[SHAPE_COUNT] = {0, 10, 30, 100, 120, 1000, 10000};
+    return WEIGHTS[shape];
+}
+
+int GomokuEval::pointScore(int p, PieceColor color) const
+{
+    int s = side(color);
+    int score = 0;
+    int threats = 0;
+    for (int d = 0; d < 4; ++d) {
+        Shape shape = static_cast<Shape>(m_shape[s][d][p]);
+        score += shapeWeight(shape);
+        if (shape >= OpenThree) threats++;
+    }
+    // 双三、四三、双四：两个方向同时成势，与活四相当
+    if (threats >= 2) score += shapeWeight(OpenFour);
+    return score;
+}
+
+int GomokuEval::evaluate(PieceColor toPlay) const
+{
+    int us = side(toPlay);
+    int them = 1 - us;
+    if (m_counts[us][Five] > 0) return WIN_SCORE;
+
+    int score = 0;
+    for (int shape = OpenTwo; shape < SHAPE_COUNT; ++shape) {
+        score += shapeWeight(static_cast<Shape>(shape)) * (m_counts[us][shape] - m_counts[them][shape]);
+    }
+    return score;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include "ChessPiece.h"
+#include "GomokuBoard.h"
+
+// 五子棋增量评估
+// 每个点每个方向维护两侧各4格的16位行型码（每格2位，直接存棋盘格子的值），落子/撤销时
+// 只更新四条线上前后各4个点的码，再查表得到该空点对双方的棋形，同时增减双方各棋形的计数
+// 搜索和走法排序读计数和单点棋形，不再扫描棋盘
+// 棋形按五连及以上计，不区分规则；规则相关的胜负和禁手仍由GomokuRules判断
+class GomokuEval {
+public:
+    // 在空点落子后这条线上形成的棋形，数值越大越强
+    enum Shape {
+        None,
+        OpenTwo,   // 再下一手能成活三
+        Three,     // 再下一手能成冲四
+        OpenThree, // 再下一手能成活四
+        Four,      // 冲四：再下一手成五
+        OpenFour,  // 活四或同一条线上的双四
+        Five,
+        SHAPE_COUNT
+    };
+
+    static const int WIN_SCORE = 1000000; // 轮到的一方有成五点
+
+    explicit GomokuEval(int size = 15);
+
+    void reset();
+    // 按当前棋盘从头重算所有行型码和计数（一致性检查与基准对比用）
+    void rebuild();
+    const GomokuBoard& board() const { return m_board; }
+
+    bool play(int p, PieceColor color);
+    void undo();
+
+    // 空点p在方向d上对color的棋形，非空点为None
+    Shape shape(int p, int d, PieceColor color) const { return static_cast<Shape>(m_shape[side(color)][d][p]); }
+    // color在所有空点、所有方向上某种棋形的个数
+    int count(PieceColor color, Shape shape) const { return m_counts[side(color)][shape]; }
+    // 空点p对color的价值（四个方向棋形的权重和，两个方向都有三以上时另加组合分）
+    int pointScore(int p, PieceColor color) const;
+    // 走法排序用：己方进攻价值加上堵对方的价值
+    int moveScore(int p, PieceColor toPlay) const { return pointScore(p, toPlay) * 2 + pointScore(p, opponentOf(toPlay)); }
+    // 以轮到的一方为正的静态评估
+    int evaluate(PieceColor toPlay) const;
+
+    static int shapeWeight(Shape shape);
+
+private:
+    GomokuBoard m_board;
+    uint16_t m_code[4][GomokuBoard::MAX_POINTS];
+    uint8_t m_shape[2][4][GomokuBoard::MAX_POINTS];
+    int m_counts[2][SHAPE_COUNT];
+
+    static int side(PieceColor color) { return color == PieceColor::White ? 1 : 0; }
+    static PieceColor opponentOf(PieceColor color)
+    {
+        return color == PieceColor::Black ? PieceColor::White : PieceColor::Black;
+    }
+
+    void toggle(int p, int value);
+    void refresh(int p, int d);
+    void setShape(int s, int d, int p, int shape);
+
+    static const uint8_t* table(int s);
+};
@@ -0,0 +1,177 @@
+// GomokuRules.cpp
+#include "GomokuRules.h"
+#include "RulesStats.h"
+
+namespace {
+
+// 行型窗口：中心点两侧各5格
+const int WINDOW = 11;
+const int CENTER = 5;
+const int VALID_CODES = 59049; // 3^10
+enum { EMPTY = 0, OWN = 1, BLOCKED = 2 };
+
+// 过at的己方连子长度，mask记下所占的格子
+int runThrough(const int line[WINDOW], int at, int& mask)
+{
+    mask = 0;
+    int length = 0;
+    for (int i = at; i >= 0 && line[i] == OWN; --i) {
+        mask |= 1 << i;
+        length++;
+    }
+    for (int i = at + 1; i < WINDOW && line[i] == OWN; ++i) {
+        mask |= 1 << i;
+        length++;
+    }
+    return length;
+}
+
+// 再下一手就恰好成五（且五连过中心点）的点，masks记下每个五连里原有的四个子
+int fiveCompletions(int line[WINDOW], int masks[WINDOW])
+{
+    int count = 0;
+    for (int k = CENTER - 4; k <= CENTER + 4; ++k) {
+        if (line[k] != EMPTY) continue;
+        line[k] = OWN;
+        int mask;
+        if (runThrough(line, CENTER, mask) == 5) {
+            masks[count++] = mask & ~(1 << k);
+        }
+        line[k] = EMPTY;
+    }
+    return count;
+}
+
+// 两个成五点补的是同一个四时只算一个四（活四），补的不是同一个四时算两个（如X.XXX.X）
+int distinctFours(const int masks[], int count)
+{
+    int fours = 0;
+    for (int i = 0; i < count; ++i) {
+        bool seen = false;
+        for (int j = 0; j < i; ++j) {
+            seen = seen || masks[j] == masks[i];
+        }
+        if (!seen) fours++;
+    }
+    return fours < 3 ? fours : 3;
+}
+
+bool hasStraightFour(int line[WINDOW])
+{
+    int masks[WINDOW];
+    int count = fiveCompletions(line, masks);
+    return distinctFours(masks, count) < count;
+}
+
+int classify(int line[WINDOW])
+{
+    int mask;
+    int run = runThrough(line, CENTER, mask);
+    if (run == 5) return GomokuRules::FIVE;
+    if (run > 5) return GomokuRules::OVERLINE;
+
+    int masks[WINDOW];
+    int fours = distinctFours(masks, fiveCompletions(line, masks));
+    if (fours > 0) return fours << GomokuRules::FOURS_SHIFT;
+
+    // 三：下一手能走成活四
+    int keys = 0;
+    for (int k = CENTER - 4; k <= CENTER + 4; ++k) {
+        if (line[k] != EMPTY) continue;
+        line[k] = OWN;
+        if (hasStraightFour(line)) keys |= 1 << (k - (CENTER - 4));
+        line[k] = EMPTY;
+    }
+    return keys << GomokuRules::KEYS_SHIFT;
+}
+
+} // namespace
+
+const std::vector<uint16_t>& GomokuRules::table()
+{
+    static const std::vector<uint16_t> entries = [] {
+        std::vector<uint16_t> result(1 << 20, 0);
+        int line[WINDOW];
+        for (int n = 0; n < VALID_CODES; ++n) {
+            int code = 0;
+            int rest = n;
+            for (int j = 0; j < 10; ++j) {
+                int state = rest % 3;
+                rest /= 3;
+                code |= state << (2 * j);
+                line[j < CENTER ? j : j + 1] = state;
+            }
+            line[CENTER] = OWN;
+            result[code] = static_cast<uint16_t>(classify(line));
+        }
+        return result;
+    }();
+    return entries;
+}
+
+bool GomokuRules::isWin(const GomokuBoard& board, int p, GomokuRule rule)
+{
+    RULES_STATS_SCOPE(GomokuEngine, WinCheck);
+    int color = board.cell(p);
+    if (color != GomokuBoard::Black && color != GomokuBoard::White) return false;
+    bool overlineWins = rule == GomokuRule::Freestyle || (rule == GomokuRule::Renju && color == GomokuBoard::White);
+    for (int d = 0; d < 4; ++d) {
+        int info = lineInfo(board.lineCode(p, d, color));
+        if ((info & FIVE) || ((info & OVERLINE) && overlineWins)) return true;
+    }
+    return false;
+}
+
+bool GomokuRules::isForbidden(GomokuBoard& board, int p)
+{
+    RULES_STATS_SCOPE(GomokuEngine, Legality);
+    return isForbidden(board, p, 0);
+}
+
+bool GomokuRules::isForbidden(GomokuBoard& board, int p, int depth)
+{
+    if (depth > MAX_DEPTH || board.cell(p) != GomokuBoard::Empty) return false;
+
+    board.play(p, PieceColor::Black);
+    int info[4];
+    bool five = false, overline = false;
+    int fourCount = 0, threeCount = 0;
+    for (int d = 0; d < 4; ++d) {
+        info[d] = lineInfo(board.lineCode(p, d, GomokuBoard::Black));
+        five = five || (info[d] & FIVE);
+        overline = overline || (info[d] & OVERLINE);
+        fourCount += fours(info[d]);
+        if (threeKeys(info[d])) threeCount++;
+    }
+
+    bool forbidden = false;
+    if (!five) {
+        if (overline || fourCount >= 2) {
+            forbidden = true;
+        } else if (threeCount >= 2) {
+            // 至少有一个关键点本身不是禁手，才是真三
+            int realThrees = 0;
+            for (int d = 0; d < 4; ++d) {
+                int keys = threeKeys(info[d]);
+                for (int k = 0; k < 9 && keys; ++k) {
+                    if (!(keys & (1 << k))) continue;
+                    int q = p + (k - 4) * board.direction(d);
+                    if (!isForbidden(board, q, depth + 1)) {
+                        realThrees++;
+                        break;
+                    }
+                }
+            }
+            forbidden = realThrees >= 2;
+        }
+    }
+    board.undo();
+    return forbidden;
+}
+
+bool GomokuRules::isLegal(GomokuBoard& board, int p, PieceColor color, GomokuRule rule)
+{
+    if (!board.isOnBoard(p) || board.cell(p) != GomokuBoard::Empty) return false;
+    if (rule == GomokuRule::Renju && color == PieceColor::Black) return !isForbidden(board, p);
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "ChessPiece.h"
+#include "GomokuBoard.h"
+
+// 五子棋胜负与连珠禁手判断
+// 行型表以GomokuBoard::lineCode为下标（4^10项，只有3^10项有效），一次查表得到
+// 过中心点的这条线上是否成五/长连、有几个四、哪些点能把它走成活四（三的关键点）
+// 禁手判断只需每个方向查一次表；双三时才对关键点递归检查是否禁手
+class GomokuRules {
+public:
+    // 行型表项各位的含义
+    static const int FIVE = 1;         // 恰好五连
+    static const int OVERLINE = 2;     // 六连及以上
+    static const int FOURS_SHIFT = 2;  // 第2-3位：再下一手恰好成五的不同的四的个数（0-2）
+    static const int KEYS_SHIFT = 4;   // 第4-12位：下在偏移-4..+4处能成活四的点（已有四时为0）
+
+    static int lineInfo(int code) { return table()[code]; }
+    static int fours(int info) { return (info >> FOURS_SHIFT) & 3; }
+    static int threeKeys(int info) { return info >> KEYS_SHIFT; }
+
+    // p上刚落的子是否获胜
+    static bool isWin(const GomokuBoard& board, int p, GomokuRule rule);
+    // 黑棋下在空点p是否为禁手（三三、四四、长连；同时成五则不算）
+    static bool isForbidden(GomokuBoard& board, int p);
+    // 空点且（连珠规则下的黑棋）不是禁手
+    static bool isLegal(GomokuBoard& board, int p, PieceColor color, GomokuRule rule);
+
+private:
+    static const int MAX_DEPTH = 6; // 递归检查关键点的最大层数，更深的按非禁手处理
+
+    static const std::vector<uint16_t>& table();
+    static bool isForbidden(GomokuBoard& board, int p, int depth);
+};
@@ -0,0 +1,195 @@
+// InfluenceMap.cpp
+#include "InfluenceMap.h"
+#include <algorithm>
+
+namespace {
+
+int popcount(uint32_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcount(x);
+#else
+    int count = 0;
+    for (; x; x &= x - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+} // namespace
+
+InfluenceMap::InfluenceMap(int size)
+    : m_size(std::max(1, std::min(size, static_cast<int>(GoBoard::MAX_SIZE))))
+    , m_rowMask((1u << m_size) - 1)
+    , m_rowsComputed(0)
+{
+    reset();
+}
+
+void InfluenceMap::reset()
+{
+    for (int c = 0; c < 2; ++c) {
+        for (int row = 0; row < GoBoard::MAX_SIZE; ++row) {
+            m_stones[c][row] = 0;
+            m_region[c][row] = 0;
+        }
+        m_area[c] = 0;
+    }
+    m_hash = 0;
+}
+
+PieceColor InfluenceMap::owner(int row, int col) const
+{
+    uint32_t bit = 1u << col;
+    if (m_region[0][row] & bit) return PieceColor::Black;
+    if (m_region[1][row] & bit) return PieceColor::White;
+    return PieceColor::Empty;
+}
+
+bool InfluenceMap::update(const GoBoard& board)
+{
+    if (board.size() != m_size) {
+        m_size = board.size();
+        m_rowMask = (1u << m_size) - 1;
+        rebuild(board);
+        return true;
+    }
+
+    if (board.hash() == m_hash) return false;
+
+    int first = m_size;
+    int last = -1;
+    if (!applyLastMove(board, first, last)) {
+        // 不是正好多一手（悔棋、跳转、摆子）时，逐行比对找出棋子变化的行
+        for (int row = 0; row < m_size; ++row) {
+            uint32_t black = 0, white = 0;
+            for (int col = 0; col < m_size; ++col) {
+                int cell = board.cell(board.point(row, col));
+                black |= uint32_t(cell == GoBoard::Black) << col;
+                white |= uint32_t(cell == GoBoard::White) << col;
+            }
+            if (black != m_stones[0][row] || white != m_stones[1][row]) {
+                m_stones[0][row] = black;
+                m_stones[1][row] = white;
+                first = std::min(first, row);
+                last = row;
+            }
+        }
+    }
+    m_hash = board.hash();
+    if (last < 0) return false;
+
+    recompute(std::max(first - REACH, 0), std::min(last + REACH, m_size - 1));
+    countArea();
+    return true;
+}
+
+bool InfluenceMap::applyLastMove(const GoBoard& board, int& first, int& last)
+{
+    int move = board.lastMove();
+    if (board.previousHash() != m_hash || !board.canUndo() || !board.isOnBoard(move)) return false;
+    int color = board.cell(move);
+    if (color != GoBoard::Black && color != GoBoard::White) return false;
+    int mine = color == GoBoard::Black ? 0 : 1;
+    // 悔棋后提子表可能还是被撤销那一手的：提掉的点必须现在是空的、原来是对方的子
+    int captures = board.lastCaptureCount();
+    for (int i = 0; i < captures; ++i) {
+        int p = board.lastCapturedPoint(i);
+        if (board.cell(p) != GoBoard::Empty || !(m_stones[1 - mine][board.rowOf(p)] & (1u << board.colOf(p)))) {
+            return false;
+        }
+    }
+
+    first = last = board.rowOf(move);
+    m_stones[mine][first] |= 1u << board.colOf(move);
+    for (int i = 0; i < captures; ++i) {
+        int p = board.lastCapturedPoint(i);
+        int row = board.rowOf(p);
+        m_stones[1 - mine][row] &= ~(1u << board.colOf(p));
+        first = std::min(first, row);
+        last = std::max(last, row);
+    }
+    return true;
+}
+
+void InfluenceMap::rebuild(const GoBoard& board)
+{
+    reset();
+    for (int row = 0; row < m_size; ++row) {
+        for (int col = 0; col < m_size; ++col) {
+            int cell = board.cell(board.point(row, col));
+            if (cell == GoBoard::Black) m_stones[0][row] |= 1u << col;
+            if (cell == GoBoard::White) m_stones[1][row] |= 1u << col;
+        }
+    }
+    m_hash = board.hash();
+    recompute(0, m_size - 1);
+    countArea();
+}
+
+void InfluenceMap::recompute(int outFirst, int outLast)
+{
+    // 每做一步，工作区两端不在棋盘边上的那一行就不可信了，所以工作区要向外多留REACH行
+    int first = std::max(outFirst - REACH, 0);
+    int last = std::min(outLast + REACH, m_size - 1);
+    uint32_t region[2][GoBoard::MAX_SIZE + 2] = {}; // 下标加一，上下各留一行空
+    uint32_t next[2][GoBoard::MAX_SIZE + 2] = {};
+    for (int row = first; row <= last; ++row) {
+        region[0][row + 1] = m_stones[0][row];
+        region[1][row + 1] = m_stones[1][row];
+    }
+    m_rowsComputed += last - first + 1;
+
+    auto neighbours = [this](const uint32_t* plane, int i) {
+        return ((plane[i] << 1) | (plane[i] >> 1) | plane[i - 1] | plane[i + 1]) & m_rowMask;
+    };
+
+    // 膨胀：挨着己方、不挨着对方、也不属于对方的点并入
+    for (int step = 0; step < DILATIONS; ++step) {
+        for (int i = first + 1; i <= last + 1; ++i) {
+            uint32_t nearBlack = neighbours(region[0], i);
+            uint32_t nearWhite = neighbours(region[1], i);
+            next[0][i] = region[0][i] | (nearBlack & ~nearWhite & ~region[1][i]);
+            next[1][i] = region[1][i] | (nearWhite & ~nearBlack & ~region[0][i]);
+        }
+        for (int i = first + 1; i <= last + 1; ++i) {
+            region[0][i] = next[0][i];
+            region[1][i] = next[1][i];
+        }
+    }
+
+    // 腐蚀：挨着对方势力的点退出，棋子本身不退
+    // 二值图上若把中立点也算进去，稀疏的布局阶段几乎所有的地都会被蚀掉，所以只看对方
+    for (int step = 0; step < EROSIONS; ++step) {
+        uint32_t outside[2][GoBoard::MAX_SIZE + 2] = {};
+        for (int i = first + 1; i <= last + 1; ++i) {
+            outside[0][i] = region[1][i];
+            outside[1][i] = region[0][i];
+        }
+        // 工作区外的行在棋盘上时按对方势力处理；它们只会影响本来就不可信的边缘行
+        for (int c = 0; c < 2; ++c) {
+            if (first > 0) outside[c][first] = m_rowMask;
+            if (last < m_size - 1) outside[c][last + 2] = m_rowMask;
+        }
+        for (int i = first + 1; i <= last + 1; ++i) {
+            region[0][i] = (region[0][i] & ~neighbours(outside[0], i)) | m_stones[0][i - 1];
+            region[1][i] = (region[1][i] & ~neighbours(outside[1], i)) | m_stones[1][i - 1];
+        }
+    }
+
+    for (int row = outFirst; row <= outLast; ++row) {
+        m_region[0][row] = region[0][row + 1];
+        m_region[1][row] = region[1][row + 1];
+    }
+}
+
+void InfluenceMap::countArea()
+{
+    m_area[0] = 0;
+    m_area[1] = 0;
+    for (int row = 0; row < m_size; ++row) {
+        m_area[0] += popcount(m_region[0][row]);
+        m_area[1] += popcount(m_region[1][row]);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include "ChessPiece.h"
+#include "GoBoard.h"
+
+// 对局中的实时形势估计：Bouzy式膨胀/腐蚀的位棋盘版本
+// 每行一个uint32，邻点用移位求；从双方棋子出发膨胀DILATIONS次（只长进不挨着对方势力的点），
+// 再腐蚀EROSIONS次（去掉挨着对方势力的点），双方势力之间留出中立带
+// 一个点的归属只取决于距离DILATIONS + EROSIONS以内的棋子，所以落子/提子后只重算变化行附近的行带
+// 棋盘正好比上次同步多一手时，变化的行直接由这一手和它提掉的子得出；否则逐行比对找出变化的行
+// 不判死子，死子仍按活子计；结果只用于显示，不影响计分
+class InfluenceMap {
+public:
+    static const int DILATIONS = 4;
+    static const int EROSIONS = 1;
+
+    explicit InfluenceMap(int size = GoBoard::MAX_SIZE);
+
+    void reset();
+    int size() const { return m_size; }
+
+    // 与棋盘同步，只重算受影响的行；棋盘没变时返回false
+    bool update(const GoBoard& board);
+    // 不看缓存，整盘重算（对照用）
+    void rebuild(const GoBoard& board);
+
+    PieceColor owner(int row, int col) const;
+    // 棋子加势力范围内的空点
+    int blackArea() const { return m_area[0]; }
+    int whiteArea() const { return m_area[1]; }
+    // 黑减白，已扣贴目
+    double estimate(double komi) const { return m_area[0] - m_area[1] - komi; }
+
+    // 累计重算的行数（含为保证边界正确而多算的行）
+    long long rowsComputed() const { return m_rowsComputed; }
+
+private:
+    static const int REACH = DILATIONS + EROSIONS;
+
+    int m_size;
+    uint32_t m_rowMask;
+    uint32_t m_stones[2][GoBoard::MAX_SIZE];  // 黑、白
+    uint32_t m_region[2][GoBoard::MAX_SIZE];
+    uint64_t m_hash; // 上次同步时棋盘的棋子哈希
+    int m_area[2];
+    long long m_rowsComputed;
+
+    // 棋盘比上次同步多一手时按这一手改棋子并给出变化的行，不是时返回false且不改动
+    bool applyLastMove(const GoBoard& board, int& first, int& last);
+    // 从棋子重算[outFirst, outLast]行的归属
+    void recompute(int outFirst, int outLast);
+    void countArea();
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "ChessPiece.h"
+
+// 通用k子连珠引擎：连子数K、棋盘ROWS x COLS、每回合落子数STONES_PER_TURN都是模板参数
+// 四个方向的步长和每个方向最多走几步都是编译期常量，判胜的扫描在编译期展开，
+// 每种变体都和手写的专用版本一样快
+// EXACT为true时恰好K连才算胜（多于K的长连不算）
+// 先手第一回合只下一颗子，之后每回合STONES_PER_TURN颗（六子棋的规则；每回合一颗时就是普通轮流）
+template <int K, int ROWS, int COLS, int STONES_PER_TURN = 1, bool EXACT = false>
+class KInARow {
+    static_assert(K >= 2 && K <= ROWS && K <= COLS, "line length must fit on the board");
+    static_assert(STONES_PER_TURN >= 1, "at least one stone per turn");
+
+public:
+    static constexpr int STRIDE = COLS + 1; // 右边框与下一行的左边框共用
+    static constexpr int POINTS = (ROWS + 2) * STRIDE + 1;
+    enum Cell : int8_t { Empty = 0, Black = 1, White = 2, Border = 3 };
+
+    KInARow() { reset(); }
+
+    void reset()
+    {
+        for (int p = 0; p < POINTS; ++p) {
+            m_cells[p] = Border;
+        }
+        for (int row = 0; row < ROWS; ++row) {
+            for (int col = 0; col < COLS; ++col) {
+                m_cells[point(row, col)] = Empty;
+            }
+        }
+        m_history.clear();
+    }
+
+    static constexpr int rows() { return ROWS; }
+    static constexpr int cols() { return COLS; }
+    static constexpr int point(int row, int col) { return (row + 1) * STRIDE + col + 1; }
+    static constexpr bool inRange(int row, int col) { return row >= 0 && row < ROWS && col >= 0 && col < COLS; }
+
+    PieceColor at(int row, int col) const { return static_cast<PieceColor>(m_cells[point(row, col)]); }
+
+    // 落子与撤销，越界或不空时返回false
+    bool play(int row, int col, PieceColor color)
+    {
+        if (!inRange(row, col) || m_cells[point(row, col)] != Empty) return false;
+        m_cells[point(row, col)] = static_cast<int8_t>(color);
+        m_history.push_back(point(row, col));
+        return true;
+    }
+
+    void undo()
+    {
+        if (m_history.empty()) return;
+        m_cells[m_history.back()] = Empty;
+        m_history.pop_back();
+    }
+
+    int stoneCount() const { return static_cast<int>(m_history.size()); }
+
+    // 第n颗子（从0数）该由哪一方下
+    static constexpr PieceColor colorOfStone(int n)
+    {
+        return n == 0 || ((n - 1) / STONES_PER_TURN) % 2 == 1 ? PieceColor::Black : PieceColor::White;
+    }
+    // 下一颗子该由哪一方下
+    PieceColor toPlay() const { return colorOfStone(stoneCount()); }
+
+    // (row, col)上的子是否连成K子
+    bool isWin(int row, int col) const
+    {
+        int p = point(row, col);
+        int8_t color = m_cells[p];
+        if (color != Black && color != White) return false;
+        return wins<1>(p, color) || wins<STRIDE>(p, color) ||
+               wins<STRIDE + 1>(p, color) || wins<STRIDE - 1>(p, color);
+    }
+
+private:
+    // 恰好K连时要多看一格，才能分出长连
+    static constexpr int REACH = EXACT ? K : K - 1;
+
+    int8_t m_cells[POINTS];
+    std::vector<int> m_history;
+
+    template <int DIR>
+    bool wins(int p, int8_t color) const
+    {
+        int run = 1 + count<DIR, 1>(p, color) + count<-DIR, 1>(p, color);
+        return EXACT ? run == K : run >= K;
+    }
+
+    // 从p沿DIR走第I步起还有几颗同色子，最多走REACH步；边框与空点、对方子一样会中断
+    template <int DIR, int I>
+    int count(int p, int8_t color) const
+    {
+        if constexpr (I > REACH) {
+            return 0;
+        } else {
+            return m_cells[p + I * DIR] == color ? 1 + count<DIR, I + 1>(p, color) : 0;
+        }
+    }
+};
+
+// 常用变体
+using FreestyleGomoku = KInARow<5, 15, 15>;
+using StandardGomoku = KInARow<5, 15, 15, 1, true>;
+using Connect6 = KInARow<6, 19, 19, 2>;
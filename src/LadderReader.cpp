@@ -0,0 +1,234 @@
+// LadderReader.cpp
+#include "LadderReader.h"
+#include <algorithm>
+
+namespace {
+
+const int MAX_DEFENCES = 16;
+
+// 撤销要靠记录，快速走子时棋盘可能关了记录，读秒期间临时打开
+class RecordingScope {
+public:
+    explicit RecordingScope(GoBoard& board)
+        : m_board(board)
+        , m_wasRecording(board.isRecording())
+    {
+        if (!m_wasRecording) m_board.setRecording(true);
+    }
+    ~RecordingScope()
+    {
+        if (!m_wasRecording) m_board.setRecording(false);
+    }
+
+private:
+    GoBoard& m_board;
+    bool m_wasRecording;
+};
+
+} // namespace
+
+LadderReader::LadderReader(int tableBits)
+    : m_tableBits(tableBits)
+    , m_tableBoardSize(0)
+    , m_depthLimit(160)
+    , m_nodeLimit(20000)
+    , m_board(nullptr)
+    , m_target(GoBoard::NO_POINT)
+    , m_defender(PieceColor::Empty)
+    , m_attacker(PieceColor::Empty)
+    , m_nodes(0)
+    , m_aborted(false)
+    , m_cut(false)
+    , m_hits(0)
+{
+}
+
+void LadderReader::clear()
+{
+    std::fill(m_table.begin(), m_table.end(), Entry{0, GoBoard::PASS_MOVE, false});
+}
+
+void LadderReader::begin(GoBoard& board, int target)
+{
+    if (m_table.empty()) {
+        m_table.assign(size_t(1) << m_tableBits, Entry{0, GoBoard::PASS_MOVE, false});
+    }
+    // 不同大小的棋盘点编号的几何意义不同，同一个哈希不代表同一个局面
+    if (board.size() != m_tableBoardSize) {
+        clear();
+        m_tableBoardSize = board.size();
+    }
+    m_board = &board;
+    m_target = target;
+    m_defender = board.at(target);
+    m_attacker = static_cast<PieceColor>(GoBoard::opponent(static_cast<int>(m_defender)));
+    m_nodes = 0;
+    m_aborted = false;
+    m_cut = false;
+}
+
+bool LadderReader::attack(GoBoard& board, int target, int* move)
+{
+    if (move) *move = GoBoard::PASS_MOVE;
+    if (board.cell(target) != GoBoard::Black && board.cell(target) != GoBoard::White) return false;
+
+    RecordingScope recording(board);
+    begin(board, target);
+    int best = GoBoard::PASS_MOVE;
+    bool captured = attackNode(0, best);
+    if (move) *move = best;
+    return captured;
+}
+
+bool LadderReader::defend(GoBoard& board, int target, int* move)
+{
+    if (move) *move = GoBoard::PASS_MOVE;
+    if (board.cell(target) != GoBoard::Black && board.cell(target) != GoBoard::White) return true;
+
+    RecordingScope recording(board);
+    begin(board, target);
+    int libs[3];
+    int count = board.liberties(target, 3, libs);
+    if (count >= 3) return true;
+
+    // 两口气时先看不应行不行
+    int reply = GoBoard::PASS_MOVE;
+    if (count == 2 && !attackNode(0, reply)) return true;
+
+    int best = GoBoard::PASS_MOVE;
+    bool safe = defendNode(0, best);
+    if (move) *move = best;
+    return safe;
+}
+
+bool LadderReader::isLadderCaptured(GoBoard& board, int target)
+{
+    if (board.cell(target) != GoBoard::Black && board.cell(target) != GoBoard::White) return false;
+    return board.isInAtari(target) && !defend(board, target);
+}
+
+bool LadderReader::overLimit(int depth)
+{
+    if (++m_nodes > m_nodeLimit || depth >= m_depthLimit) {
+        m_aborted = true;
+        m_cut = true;
+        return true;
+    }
+    return false;
+}
+
+bool LadderReader::attackNode(int depth, int& move)
+{
+    int libs[3];
+    int count = m_board->liberties(m_target, 3, libs);
+    if (count >= 3) return false;
+    if (count == 1) {
+        // 打劫时提不了
+        if (!m_board->isLegal(libs[0], m_attacker)) return false;
+        move = libs[0];
+        return true;
+    }
+    if (overLimit(depth)) return false;
+
+    uint64_t k = key(true);
+    if (const Entry* entry = lookup(k)) {
+        move = entry->move;
+        return entry->win;
+    }
+
+    bool outerCut = m_cut;
+    m_cut = false;
+    bool captured = false;
+    int best = GoBoard::PASS_MOVE;
+    for (int i = 0; i < count && !captured; ++i) {
+        if (!m_board->play(libs[i], m_attacker)) continue;
+        int after[2];
+        int reply = GoBoard::PASS_MOVE;
+        // 叫吃时提了守方别的子，目标可能反而多出气来
+        captured = m_board->liberties(m_target, 2, after) == 1 && !defendNode(depth + 1, reply);
+        m_board->undo();
+        if (captured) best = libs[i];
+    }
+    if (!m_cut) store(k, best, captured);
+    m_cut = m_cut || outerCut;
+    move = best;
+    return captured;
+}
+
+bool LadderReader::defendNode(int depth, int& move)
+{
+    if (overLimit(depth)) return true;
+
+    uint64_t k = key(false);
+    if (const Entry* entry = lookup(k)) {
+        move = entry->move;
+        return entry->win;
+    }
+
+    int libs[2];
+    int count = m_board->liberties(m_target, 2, libs);
+    int moves[MAX_DEFENCES];
+    int moveCount = defenceMoves(libs, count, moves);
+
+    bool outerCut = m_cut;
+    m_cut = false;
+    bool safe = false;
+    int best = GoBoard::PASS_MOVE;
+    for (int i = 0; i < moveCount && !safe; ++i) {
+        if (!m_board->play(moves[i], m_defender)) continue;
+        int after[3];
+        int libsAfter = m_board->liberties(m_target, 3, after);
+        int reply = GoBoard::PASS_MOVE;
+        safe = libsAfter >= 3 || (libsAfter == 2 && !attackNode(depth + 1, reply));
+        m_board->undo();
+        if (safe) best = moves[i];
+    }
+    if (!m_cut) store(k, best, safe);
+    m_cut = m_cut || outerCut;
+    move = best;
+    return safe;
+}
+
+int LadderReader::defenceMoves(const int libs[], int libCount, int out[]) const
+{
+    int count = 0;
+    // 提掉挨着目标、只剩一口气的攻方棋子；多半能一举长出气来，先试
+    int s = m_board->groupOf(m_target);
+    int root = s;
+    do {
+        for (int d = 0; d < 4; ++d) {
+            int n = s + m_board->neighbour8(d);
+            if (m_board->at(n) != m_attacker || !m_board->isInAtari(n)) continue;
+            int capture = m_board->atariLiberty(n);
+            if (std::find(out, out + count, capture) != out + count) continue;
+            out[count++] = capture;
+            if (count >= MAX_DEFENCES - 2) break;
+        }
+        s = m_board->nextStone(s);
+    } while (s != root && count < MAX_DEFENCES - 2);
+
+    for (int i = 0; i < libCount; ++i) {
+        if (std::find(out, out + count, libs[i]) == out + count) out[count++] = libs[i];
+    }
+    return count;
+}
+
+uint64_t LadderReader::key(bool attackerToMove) const
+{
+    // 同一局面下不同目标、不同先手各占一项；局面键里已含劫点
+    uint64_t k = m_board->positionKey() ^ (static_cast<uint64_t>(m_target) * 0x9E3779B97F4A7C15ULL);
+    return attackerToMove ? k ^ 0xA24BAED4963EE407ULL : k;
+}
+
+const LadderReader::Entry* LadderReader::lookup(uint64_t key)
+{
+    const Entry& entry = m_table[key & ((uint64_t(1) << m_tableBits) - 1)];
+    if (entry.key != key) return nullptr;
+    m_hits++;
+    return &entry;
+}
+
+void LadderReader::store(uint64_t key, int move, bool win)
+{
+    m_table[key & ((uint64_t(1) << m_tableBits) - 1)] = Entry{key, move, win};
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "GoBoard.h"
+
+// 征子与简单吃/逃的战术读秒，给走子策略、着法排序和分析图层用
+// 只读气数不超过两口的棋块：攻方只在目标的气上叫吃，守方只长气或提掉叫吃它的子；
+// 长出三口气即算逃出。直接在调用方的GoBoard上落子/撤销，不拷贝棋盘，返回前棋盘复原
+// 结果按（局面键、目标、轮到哪方）记在直接映射表里，换盘面大小时清空
+class LadderReader {
+public:
+    // 置换表2^tableBits项，第一次读秒时才分配
+    explicit LadderReader(int tableBits = 14);
+
+    // 深度（手数）或节点数超限时按逃出处理，aborted()为true
+    void setDepthLimit(int plies) { m_depthLimit = plies; }
+    void setNodeLimit(int nodes) { m_nodeLimit = nodes; }
+
+    // 轮到攻方：能否吃掉target所在的棋块，能时move为第一手
+    bool attack(GoBoard& board, int target, int* move = nullptr);
+    // 轮到守方：target所在的棋块能否不被吃，能时move为第一手（不用应时为PASS_MOVE）
+    bool defend(GoBoard& board, int target, int* move = nullptr);
+    // 征子：只剩一口气且守方先走也逃不掉
+    bool isLadderCaptured(GoBoard& board, int target);
+
+    void clear();
+    int nodes() const { return m_nodes; }    // 上一次查询的节点数
+    bool aborted() const { return m_aborted; }
+    long long tableHits() const { return m_hits; }
+
+private:
+    struct Entry {
+        uint64_t key;
+        int move;
+        bool win; // 轮到的一方达到目的
+    };
+
+    std::vector<Entry> m_table;
+    int m_tableBits;
+    int m_tableBoardSize;
+    int m_depthLimit;
+    int m_nodeLimit;
+
+    GoBoard* m_board;
+    int m_target;
+    PieceColor m_defender;
+    PieceColor m_attacker;
+    int m_nodes;
+    bool m_aborted;
+    bool m_cut; // 当前子树碰到了深度/节点上限，结果不进表
+    long long m_hits;
+
+    void begin(GoBoard& board, int target);
+    bool attackNode(int depth, int& move);
+    bool defendNode(int depth, int& move);
+    // 守方可选的应手：提掉叫吃目标的子，再是长气
+    int defenceMoves(const int libs[], int libCount, int out[]) const;
+    bool overLimit(int depth);
+    uint64_t key(bool attackerToMove) const;
+    const Entry* lookup(uint64_t key);
+    void store(uint64_t key, int move, bool win);
+};
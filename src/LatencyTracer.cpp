@@ -0,0 +1,115 @@
+// LatencyTracer.cpp
+#include "LatencyTracer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+int currentThreadId()
+{
+    static std::atomic<int> nextId{1};
+    thread_local int id = nextId++;
+    return id;
+}
+
+int64_t steadyUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+LatencyTracer& LatencyTracer::instance()
+{
+    static LatencyTracer tracer;
+    return tracer;
+}
+
+LatencyTracer::LatencyTracer()
+    : m_recording(false)
+    , m_overlay(false)
+    , m_origin(steadyUs())
+    , m_pendingInput(-1)
+    , m_lastFrameMs(0.0)
+    , m_lastInputLatencyMs(0.0)
+    , m_maxInputLatencyMs(0.0)
+{
+    const char* path = std::getenv("CHESS_TRACE");
+    if (path && *path) {
+        m_path = path;
+        m_recording = true;
+        m_events.reserve(4096);
+    }
+    const char* overlay = std::getenv("CHESS_TRACE_OVERLAY");
+    m_overlay = overlay && *overlay && std::strcmp(overlay, "0") != 0;
+}
+
+LatencyTracer::~LatencyTracer()
+{
+    flush();
+}
+
+int64_t LatencyTracer::nowUs() const
+{
+    return steadyUs() - m_origin;
+}
+
+void LatencyTracer::complete(const char* name, const char* category, int64_t startUs, int64_t endUs)
+{
+    if (!m_recording) return;
+    int tid = currentThreadId();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_events.size() < MAX_EVENTS) {
+        m_events.push_back({name, category, startUs, endUs - startUs, tid});
+    }
+}
+
+void LatencyTracer::markInput()
+{
+    if (!isActive()) return;
+    m_pendingInput = nowUs();
+}
+
+void LatencyTracer::framePainted(int64_t startUs, int64_t endUs)
+{
+    if (!isActive()) return;
+    m_lastFrameMs = (endUs - startUs) / 1000.0;
+    if (m_pendingInput >= 0) {
+        m_lastInputLatencyMs = (endUs - m_pendingInput) / 1000.0;
+        if (m_lastInputLatencyMs > m_maxInputLatencyMs) {
+            m_maxInputLatencyMs = m_lastInputLatencyMs;
+        }
+        if (m_recording) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_events.size() < MAX_EVENTS) {
+                m_events.push_back({"input to pixel", "latency", m_pendingInput, endUs - m_pendingInput, LATENCY_TID});
+            }
+        }
+        m_pendingInput = -1;
+    }
+}
+
+void LatencyTracer::flush()
+{
+    if (!m_recording) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FILE* file = std::fopen(m_path.c_str(), "w");
+    if (!file) return;
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                       "\"args\":{\"name\":\"input latency\"}}", LATENCY_TID);
+    for (const Event& event : m_events) {
+        std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,"
+                           "\"pid\":1,\"tid\":%d}",
+                     event.name, event.category, static_cast<long long>(event.start),
+                     static_cast<long long>(event.duration), event.tid);
+    }
+    std::fprintf(file, "\n]}\n");
+    std::fclose(file);
+}
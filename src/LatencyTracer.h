@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 点击到上屏的延迟追踪
+// 设置环境变量 CHESS_TRACE=<文件> 时把事件写成 Chrome trace-event JSON（chrome://tracing、Perfetto可打开），
+// 设置 CHESS_TRACE_OVERLAY=1 时在棋盘上显示帧时间和输入延迟（棋盘上按F3也可切换）
+class LatencyTracer {
+public:
+    static LatencyTracer& instance();
+
+    bool isActive() const { return m_recording || m_overlay; }
+    bool isRecording() const { return m_recording; }
+    bool isOverlayEnabled() const { return m_overlay; }
+    void setOverlayEnabled(bool enabled) { m_overlay = enabled; }
+
+    int64_t nowUs() const;
+    void complete(const char* name, const char* category, int64_t startUs, int64_t endUs);
+
+    // 输入到绘制完成的延迟：按下鼠标时markInput，随后第一帧绘制结束时计算
+    void markInput();
+    void framePainted(int64_t startUs, int64_t endUs);
+    double lastFrameMs() const { return m_lastFrameMs; }
+    double lastInputLatencyMs() const { return m_lastInputLatencyMs; }
+    double maxInputLatencyMs() const { return m_maxInputLatencyMs; }
+
+    void flush();
+
+    class Scope {
+    public:
+        Scope(const char* name, const char* category)
+            : m_name(name), m_category(category)
+            , m_start(LatencyTracer::instance().isRecording() ? LatencyTracer::instance().nowUs() : -1) {}
+        ~Scope()
+        {
+            if (m_start >= 0) {
+                LatencyTracer& tracer = LatencyTracer::instance();
+                tracer.complete(m_name, m_category, m_start, tracer.nowUs());
+            }
+        }
+
+    private:
+        const char* m_name;
+        const char* m_category;
+        int64_t m_start;
+    };
+
+private:
+    LatencyTracer();
+    ~LatencyTracer();
+
+    struct Event {
+        const char* name;
+        const char* category;
+        int64_t start;
+        int64_t duration;
+        int tid;
+    };
+
+    static const size_t MAX_EVENTS = 1000000;
+    static const int LATENCY_TID = 0; // 输入延迟单独成一条轨道
+
+    std::string m_path;
+    bool m_recording;
+    bool m_overlay;
+    int64_t m_origin;
+    std::mutex m_mutex;
+    std::vector<Event> m_events;
+
+    int64_t m_pendingInput;
+    double m_lastFrameMs;
+    double m_lastInputLatencyMs;
+    double m_maxInputLatencyMs;
+};
+
+#define LATENCY_TRACE_CONCAT_(a, b) a##b
+#define LATENCY_TRACE_CONCAT(a, b) LATENCY_TRACE_CONCAT_(a, b)
+#define LATENCY_TRACE(name, category) \
+    LatencyTracer::Scope LATENCY_TRACE_CONCAT(latencyTraceScope_, __LINE__)(name, category)
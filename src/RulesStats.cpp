@@ -0,0 +1,230 @@
+// RulesStats.cpp
+#include "RulesStats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+const char* const ENGINE_NAMES[RulesStats::EngineCount] = {"chesslogic", "goboard", "gomoku"};
+const char* const OP_NAMES[RulesStats::OpCount] = {"place", "capture", "legality", "ko", "scoring", "undo", "win_check"};
+const char* const HISTOGRAM_NAMES[RulesStats::HistogramCount] = {"group_size", "flood_fill"};
+
+// 每个线程一份计数，只有所属线程写入，导出线程用relaxed读取
+struct Counters {
+    std::atomic<uint64_t> calls[RulesStats::EngineCount][RulesStats::OpCount];
+    std::atomic<uint64_t> cycles[RulesStats::EngineCount][RulesStats::OpCount];
+    std::atomic<uint64_t> buckets[RulesStats::EngineCount][RulesStats::HistogramCount][RulesStats::BUCKETS];
+    std::atomic<uint64_t> sums[RulesStats::EngineCount][RulesStats::HistogramCount];
+
+    Counters() { clear(); }
+
+    void clear()
+    {
+        for (auto& engine : calls) for (auto& value : engine) value.store(0, std::memory_order_relaxed);
+        for (auto& engine : cycles) for (auto& value : engine) value.store(0, std::memory_order_relaxed);
+        for (auto& engine : buckets) for (auto& hist : engine) for (auto& value : hist) value.store(0, std::memory_order_relaxed);
+        for (auto& engine : sums) for (auto& value : engine) value.store(0, std::memory_order_relaxed);
+    }
+
+    void addTo(RulesStats::Snapshot& snapshot) const
+    {
+        for (int e = 0; e < RulesStats::EngineCount; ++e) {
+            for (int op = 0; op < RulesStats::OpCount; ++op) {
+                snapshot.calls[e][op] += calls[e][op].load(std::memory_order_relaxed);
+                snapshot.cycles[e][op] += cycles[e][op].load(std::memory_order_relaxed);
+            }
+            for (int h = 0; h < RulesStats::HistogramCount; ++h) {
+                for (int b = 0; b < RulesStats::BUCKETS; ++b) {
+                    snapshot.buckets[e][h][b] += buckets[e][h][b].load(std::memory_order_relaxed);
+                }
+                snapshot.sums[e][h] += sums[e][h].load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+inline void bump(std::atomic<uint64_t>& counter, uint64_t value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<Counters*> live;
+    RulesStats::Snapshot retired; // 已退出线程的计数
+};
+
+Registry& registry()
+{
+    static Registry* instance = [] {
+        auto* r = new Registry();
+        std::memset(&r->retired, 0, sizeof(r->retired));
+        return r;
+    }();
+    return *instance;
+}
+
+struct ThreadSlot {
+    Counters counters;
+
+    ThreadSlot()
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.push_back(&counters);
+    }
+
+    ~ThreadSlot()
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        counters.addTo(r.retired);
+        r.live.erase(std::remove(r.live.begin(), r.live.end(), &counters), r.live.end());
+    }
+};
+
+Counters& localCounters()
+{
+    thread_local ThreadSlot slot;
+    return slot.counters;
+}
+
+int bucketOf(uint64_t value)
+{
+    int bucket = 0;
+    while (bucket < RulesStats::BUCKETS - 1 && (uint64_t(1) << bucket) < value) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+} // namespace
+
+uint64_t RulesStats::cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+void RulesStats::record(Engine engine, Op op, uint64_t elapsed)
+{
+    Counters& counters = localCounters();
+    bump(counters.calls[engine][op], 1);
+    bump(counters.cycles[engine][op], elapsed);
+}
+
+void RulesStats::sample(Engine engine, Histogram histogram, uint64_t value)
+{
+    Counters& counters = localCounters();
+    bump(counters.buckets[engine][histogram][bucketOf(value)], 1);
+    bump(counters.sums[engine][histogram], value);
+}
+
+RulesStats::Snapshot RulesStats::snapshot()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    Snapshot result = r.retired;
+    for (const Counters* counters : r.live) {
+        counters->addTo(result);
+    }
+    return result;
+}
+
+void RulesStats::reset()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::memset(&r.retired, 0, sizeof(r.retired));
+    for (Counters* counters : r.live) {
+        counters->clear();
+    }
+}
+
+std::string RulesStats::toJson()
+{
+    Snapshot s = snapshot();
+    std::string json = "{\"enabled\":";
+    json += enabled() ? "true" : "false";
+    json += ",\"engines\":{";
+    for (int e = 0; e < EngineCount; ++e) {
+        if (e > 0) json += ',';
+        json += '"';
+        json += ENGINE_NAMES[e];
+        json += "\":{\"ops\":{";
+        for (int op = 0; op < OpCount; ++op) {
+            if (op > 0) json += ',';
+            json += '"';
+            json += OP_NAMES[op];
+            json += "\":{\"calls\":" + std::to_string(s.calls[e][op]) +
+                    ",\"cycles\":" + std::to_string(s.cycles[e][op]) + '}';
+        }
+        json += "},\"histograms\":{";
+        for (int h = 0; h < HistogramCount; ++h) {
+            if (h > 0) json += ',';
+            json += '"';
+            json += HISTOGRAM_NAMES[h];
+            json += "\":{\"sum\":" + std::to_string(s.sums[e][h]) + ",\"buckets\":[";
+            for (int b = 0; b < BUCKETS; ++b) {
+                if (b > 0) json += ',';
+                json += std::to_string(s.buckets[e][h][b]);
+            }
+            json += "]}";
+        }
+        json += "}}";
+    }
+    json += "}}";
+    return json;
+}
+
+std::string RulesStats::toPrometheus()
+{
+    Snapshot s = snapshot();
+    std::string text;
+
+    text += "# HELP chess_rules_calls_total Rules engine operation calls.\n";
+    text += "# TYPE chess_rules_calls_total counter\n";
+    for (int e = 0; e < EngineCount; ++e) {
+        for (int op = 0; op < OpCount; ++op) {
+            text += std::string("chess_rules_calls_total{engine=\"") + ENGINE_NAMES[e] +
+                    "\",op=\"" + OP_NAMES[op] + "\"} " + std::to_string(s.calls[e][op]) + '\n';
+        }
+    }
+
+    text += "# HELP chess_rules_cycles_total Rules engine operation time in CPU cycles.\n";
+    text += "# TYPE chess_rules_cycles_total counter\n";
+    for (int e = 0; e < EngineCount; ++e) {
+        for (int op = 0; op < OpCount; ++op) {
+            text += std::string("chess_rules_cycles_total{engine=\"") + ENGINE_NAMES[e] +
+                    "\",op=\"" + OP_NAMES[op] + "\"} " + std::to_string(s.cycles[e][op]) + '\n';
+        }
+    }
+
+    for (int h = 0; h < HistogramCount; ++h) {
+        std::string name = std::string("chess_rules_") + HISTOGRAM_NAMES[h];
+        text += "# TYPE " + name + " histogram\n";
+        for (int e = 0; e < EngineCount; ++e) {
+            std::string labels = std::string("engine=\"") + ENGINE_NAMES[e] + '"';
+            uint64_t cumulative = 0;
+            for (int b = 0; b < BUCKETS; ++b) {
+                cumulative += s.buckets[e][h][b];
+                std::string le = (b == BUCKETS - 1) ? "+Inf" : std::to_string(uint64_t(1) << b);
+                text += name + "_bucket{" + labels + ",le=\"" + le + "\"} " + std::to_string(cumulative) + '\n';
+            }
+            text += name + "_sum{" + labels + "} " + std::to_string(s.sums[e][h]) + '\n';
+            text += name + "_count{" + labels + "} " + std::to_string(cumulative) + '\n';
+        }
+    }
+    return text;
+}
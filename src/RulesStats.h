@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// 规则层热点统计：各操作的调用次数和耗时（周期数），以及棋块大小、洪水填充长度直方图
+// 计数按线程累加，导出时汇总；未定义CHESS_RULES_STATS时热点路径上的宏全部展开为空
+class RulesStats {
+public:
+    enum Engine { ChessLogicEngine, GoBoardEngine, GomokuEngine, EngineCount };
+    enum Op { Place, Capture, Legality, Ko, Scoring, Undo, WinCheck, OpCount };
+    enum Histogram { GroupSize, FloodFill, HistogramCount };
+    static const int BUCKETS = 16; // 第b个桶统计 (2^(b-1), 2^b]
+
+    struct Snapshot {
+        uint64_t calls[EngineCount][OpCount];
+        uint64_t cycles[EngineCount][OpCount];
+        uint64_t buckets[EngineCount][HistogramCount][BUCKETS];
+        uint64_t sums[EngineCount][HistogramCount];
+    };
+
+    static constexpr bool enabled()
+    {
+#ifdef CHESS_RULES_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static uint64_t cycles();
+    static void record(Engine engine, Op op, uint64_t elapsed);
+    static void sample(Engine engine, Histogram histogram, uint64_t value);
+
+    static Snapshot snapshot();
+    static void reset();
+    static std::string toJson();
+    static std::string toPrometheus();
+
+    // 作用域计时
+    class Scope {
+    public:
+        Scope(Engine engine, Op op) : m_engine(engine), m_op(op), m_start(cycles()) {}
+        ~Scope() { record(m_engine, m_op, cycles() - m_start); }
+
+    private:
+        Engine m_engine;
+        Op m_op;
+        uint64_t m_start;
+    };
+};
+
+#ifdef CHESS_RULES_STATS
+#define RULES_STATS_CONCAT_(a, b) a##b
+#define RULES_STATS_CONCAT(a, b) RULES_STATS_CONCAT_(a, b)
+#define RULES_STATS_SCOPE(engine, op) \
+    RulesStats::Scope RULES_STATS_CONCAT(rulesStatsScope_, __LINE__)(RulesStats::engine, RulesStats::op)
+#define RULES_STATS_SAMPLE(engine, histogram, value) \
+    RulesStats::sample(RulesStats::engine, RulesStats::histogram, static_cast<uint64_t>(value))
+#else
+#define RULES_STATS_SCOPE(engine, op) ((void)0)
+#define RULES_STATS_SAMPLE(engine, histogram, value) ((void)0)
+#endif
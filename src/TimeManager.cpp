@@ -0,0 +1,149 @@
+// TimeManager.cpp
+#include "TimeManager.h"
+#include <algorithm>
+
+namespace {
+
+const int NO_MOVE = -1000000;
+const double EXPECTED_PLIES = 0.75;    // 一盘大约下棋盘点数这么多倍的手数
+const double MAX_RATIO = 4.0;          // 最大时间不超过目标的倍数
+const double SUDDEN_DEATH_SHARE = 0.25; // 没有读秒时一手最多用剩余主时间的比例
+const double BYO_YOMI_TARGET = 0.8;    // 读秒阶段平常用掉读秒时间的比例
+const double LAST_PERIOD_MARGIN = 0.2; // 只剩最后一次读秒时再多留的比例，偶尔的卡顿不至于超时
+const double NO_CLOCK_SECONDS = 1.0;   // 不限时时每手的时间
+const double MIN_SECONDS = 0.001;
+const double EARLY_STOP_FRACTION = 0.1; // 用满目标的这个比例后才估计速度、考虑提前停
+const double CLEAR_FRACTION = 0.5;     // 用满目标的一半后最佳着明显领先就停
+const double CLEAR_RATIO = 5.0;        // 明显领先：访问数是第二名的这么多倍
+const double CLOSE_RATIO = 1.5;        // 访问数不到第二名的这么多倍算不稳
+const double DEPTH_GROWTH = 3.0;       // 迭代加深每多一层大约慢的倍数
+
+} // namespace
+
+TimeManager::TimeManager(const GameSettings& settings, int boardSize, double timeScale)
+    : m_mainTime(std::max(0, settings.mainTime) * timeScale)
+    , m_byoYomiTime(settings.byoYomiPeriods > 0 ? std::max(0, settings.byoYomiTime) * timeScale : 0.0)
+    , m_byoYomiPeriods(settings.byoYomiTime > 0 ? std::max(0, settings.byoYomiPeriods) : 0)
+    , m_boardSize(boardSize)
+    , m_overhead(0.0)
+    , m_target(NO_CLOCK_SECONDS)
+    , m_maximum(NO_CLOCK_SECONDS)
+    , m_limit(NO_CLOCK_SECONDS)
+    , m_bestMove(NO_MOVE)
+    , m_lastChange(0.0)
+    , m_changes(0)
+    , m_lastCheck(0.0)
+{
+    reset();
+}
+
+void TimeManager::reset()
+{
+    m_mainLeft = m_mainTime;
+    m_periodsLeft = m_byoYomiPeriods;
+}
+
+void TimeManager::startMove(int moveNumber)
+{
+    m_bestMove = NO_MOVE;
+    m_lastChange = 0.0;
+    m_changes = 0;
+    m_lastCheck = 0.0;
+    if (!hasClock()) {
+        m_target = m_maximum = m_limit = NO_CLOCK_SECONDS;
+        return;
+    }
+
+    bool byoYomi = m_periodsLeft > 0;
+    if (inByoYomi()) {
+        // 读秒里省下的时间不会留到下一手，平常就用掉大半
+        double margin = m_overhead + (m_periodsLeft <= 1 ? m_byoYomiTime * LAST_PERIOD_MARGIN : 0.0);
+        m_maximum = m_byoYomiTime - margin;
+        m_target = m_byoYomiTime * BYO_YOMI_TARGET - m_overhead;
+    } else {
+        // 主时间平摊到自己还要下的手数上；有读秒时每手另有一份读秒时间可用
+        int area = m_boardSize * m_boardSize;
+        double movesLeft = std::max({8.0, area / 16.0, (area * EXPECTED_PLIES - moveNumber) / 2.0});
+        m_target = m_mainLeft / movesLeft + (byoYomi ? m_byoYomiTime : 0.0) - m_overhead;
+        // 有读秒时最多用到主时间用完再加一次读秒，不会扣掉读秒次数；没有读秒时只敢用一小部分
+        double cap = byoYomi ? m_mainLeft + m_byoYomiTime : m_mainLeft * SUDDEN_DEATH_SHARE;
+        m_maximum = std::min(m_target * MAX_RATIO, cap - m_overhead);
+    }
+    m_maximum = std::max(m_maximum, MIN_SECONDS);
+    m_target = std::min(std::max(m_target, MIN_SECONDS), m_maximum);
+    m_limit = m_target;
+}
+
+void TimeManager::trackBest(double elapsed, int bestMove)
+{
+    if (bestMove == m_bestMove) return;
+    if (m_bestMove != NO_MOVE) m_changes++;
+    m_bestMove = bestMove;
+    m_lastChange = elapsed;
+}
+
+bool TimeManager::shouldStop(double elapsed, int bestMove, int bestVisits, int secondVisits, int iterations)
+{
+    trackBest(elapsed, bestMove);
+    if (nextStepTooLong(elapsed)) return true;
+    bool recentChange = m_changes > 0 && m_lastChange >= elapsed / 2;
+    bool unstable = recentChange || bestVisits < CLOSE_RATIO * secondVisits;
+
+    if (elapsed >= m_target * EARLY_STOP_FRACTION && iterations > 0) {
+        // 按目前的速度，剩下的迭代全给第二名也追不上；不稳时还可能加时，按最大时间算
+        double remaining = ((unstable ? m_maximum : m_limit) - elapsed) * iterations / elapsed;
+        if (bestVisits - secondVisits > remaining) return true;
+        // 后一半时间里最佳着没变过，且远远领先
+        if (elapsed >= m_target * CLEAR_FRACTION && !recentChange && bestVisits > CLEAR_RATIO * secondVisits) {
+            return true;
+        }
+    }
+    if (elapsed < m_limit) return false;
+
+    // 到时间了：最佳着刚换过或与第二名咬得很紧时再加一份目标时间，直到最大时间
+    if (m_limit < m_maximum && unstable) {
+        m_limit = std::min(m_maximum, m_limit + m_target);
+        return false;
+    }
+    return true;
+}
+
+bool TimeManager::reachedTarget(double elapsed)
+{
+    return nextStepTooLong(elapsed) || elapsed >= m_target;
+}
+
+bool TimeManager::nextStepTooLong(double elapsed)
+{
+    // 按上一段的耗时，再搜一段就会超过最大时间时现在就停
+    double step = elapsed - m_lastCheck;
+    m_lastCheck = elapsed;
+    return elapsed + step >= m_maximum;
+}
+
+bool TimeManager::startNextDepth(double elapsed, int bestMove)
+{
+    trackBest(elapsed, bestMove);
+    // 最佳着在这一层变了时，下一层可以用到最大时间
+    double limit = m_changes > 0 && m_lastChange >= elapsed ? m_maximum : m_target;
+    return elapsed * DEPTH_GROWTH < limit;
+}
+
+bool TimeManager::finishMove(double seconds)
+{
+    if (!hasClock()) return true;
+    if (m_mainLeft > 0.0) {
+        m_mainLeft -= seconds;
+        if (m_mainLeft >= 0.0) return true;
+        // 超出主时间的部分计入读秒
+        seconds = -m_mainLeft;
+        m_mainLeft = 0.0;
+    }
+    if (m_periodsLeft <= 0) return seconds <= 0.0;
+    // 每用满一次读秒时间扣一次，最后一次也用完即超时
+    while (seconds > m_byoYomiTime) {
+        if (--m_periodsLeft <= 0) return false;
+        seconds -= m_byoYomiTime;
+    }
+    return true;
+}
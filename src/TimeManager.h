@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ChessPiece.h"
+
+// 引擎用时管理：按GameSettings的主时间和读秒（日本式，每次读秒内下完不扣次数）记一方的钟，给每一手分预算
+// 预算分两档：目标时间是平常该用的，最大时间是局面不稳时最多能用的（不会因此超时或多用掉一次读秒）
+// 搜索中定期问shouldStop：最佳着领先到剩余时间内追不上就提前停；到目标时间时最佳着刚换过或领先太小则加时
+class TimeManager {
+public:
+    // timeScale把设置里的时间按比例缩放（对战测试用很短的钟）
+    TimeManager(const GameSettings& settings, int boardSize, double timeScale = 1.0);
+
+    // 钟回到开局
+    void reset();
+    // 每手留给通讯、界面等的余量（秒），预算都扣掉它
+    void setMoveOverhead(double seconds) { m_overhead = seconds; }
+
+    // 开始思考第moveNumber手（整盘的手数，从0数）：按当前的钟算目标和最大时间
+    void startMove(int moveNumber);
+    double target() const { return m_target; }
+    double maximum() const { return m_maximum; }
+
+    // MCTS：elapsed为本手已用秒数，iterations为本手做了的迭代数，bestVisits、secondVisits为根上前两名的访问数
+    bool shouldStop(double elapsed, int bestMove, int bestVisits, int secondVisits, int iterations);
+    // 不看搜索结果、只按目标时间停（同样不会让下一段搜过最大时间）
+    bool reachedTarget(double elapsed);
+    // 迭代加深：每搜完一层调用，返回是否还值得开始下一层（下一层大约比这一层慢几倍）
+    bool startNextDepth(double elapsed, int bestMove);
+
+    // 这一手实际用了seconds，扣钟；超时（主时间和读秒都用完）返回false
+    bool finishMove(double seconds);
+
+    bool hasClock() const { return m_mainTime > 0 || m_byoYomiTime > 0; }
+    double mainTimeLeft() const { return m_mainLeft; }
+    int periodsLeft() const { return m_periodsLeft; }
+    bool inByoYomi() const { return m_mainLeft <= 0.0; }
+
+private:
+    double m_mainTime;
+    double m_byoYomiTime;
+    int m_byoYomiPeriods;
+    int m_boardSize;
+    double m_overhead;
+
+    double m_mainLeft;
+    int m_periodsLeft;
+
+    // 本手的状态
+    double m_target;
+    double m_maximum;
+    double m_limit;       // 当前的停止时间，加时后变长
+    int m_bestMove;
+    double m_lastChange;  // 最佳着最后一次变化时的elapsed
+    int m_changes;
+    double m_lastCheck;   // 上一次shouldStop时的elapsed
+
+    void trackBest(double elapsed, int bestMove);
+    bool nextStepTooLong(double elapsed);
+};
@@ -0,0 +1,394 @@
+// TrainingExporter.cpp
+#include "TrainingExporter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "FastRng.h"
+#include "GoBoard.h"
+
+namespace {
+
+const uint32_t SHARD_VERSION = 1;
+
+// 有界队列：满了push阻塞、空了pop阻塞；close之后push立即返回false，pop取完剩下的再返回false
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)), m_closed(false) {}
+
+    bool push(T&& item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [&] { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed) return false;
+        m_items.push_back(std::move(item));
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [&] { return m_closed || !m_items.empty(); });
+        if (m_items.empty()) return false;
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+
+private:
+    size_t m_capacity;
+    bool m_closed;
+    std::deque<T> m_items;
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+};
+
+struct QueuedGame {
+    uint32_t index = 0;
+    GameRecord record;
+};
+
+// 一盘的样本；跳过的棋局也交一个空批，写出线程才能按序号往下走
+struct QueuedBatch {
+    uint32_t index = 0;
+    std::vector<TrainingRecord> records;
+};
+
+// 按记录数切分片，关闭分片时回填记录数
+class ShardWriter {
+public:
+    ShardWriter(const std::string& prefix, long long recordsPerShard)
+        : m_prefix(prefix), m_recordsPerShard(std::max(recordsPerShard, 1LL)), m_file(nullptr), m_count(0), m_shards(0) {}
+    ~ShardWriter() { close(); }
+
+    bool write(const TrainingRecord* records, size_t count, std::string* error)
+    {
+        while (count > 0) {
+            if (!m_file && !open(error)) return false;
+            size_t room = static_cast<size_t>(m_recordsPerShard - m_count);
+            size_t n = std::min(room, count);
+            if (std::fwrite(records, sizeof(TrainingRecord), n, m_file) != n) {
+                if (error) *error = "write failed: " + m_path;
+                return false;
+            }
+            m_count += static_cast<long long>(n);
+            records += n;
+            count -= n;
+            if (m_count == m_recordsPerShard && !close(error)) return false;
+        }
+        return true;
+    }
+
+    bool close(std::string* error = nullptr)
+    {
+        if (!m_file) return true;
+        TrainingShardHeader header = makeHeader(static_cast<uint64_t>(m_count));
+        bool ok = std::fseek(m_file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, m_file) == 1;
+        ok = std::fclose(m_file) == 0 && ok;
+        m_file = nullptr;
+        if (!ok && error) *error = "failed to finish " + m_path;
+        return ok;
+    }
+
+    int shards() const { return m_shards; }
+
+private:
+    std::string m_prefix;
+    long long m_recordsPerShard;
+    std::string m_path;
+    FILE* m_file;
+    long long m_count;
+    int m_shards;
+
+    static TrainingShardHeader makeHeader(uint64_t count)
+    {
+        TrainingShardHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "GOTD", 4);
+        header.version = SHARD_VERSION;
+        header.recordSize = sizeof(TrainingRecord);
+        header.planes = GoNetwork::FEATURE_PLANES;
+        header.count = count;
+        return header;
+    }
+
+    bool open(std::string* error)
+    {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "-%05d.gotd", m_shards);
+        m_path = m_prefix + suffix;
+        m_file = std::fopen(m_path.c_str(), "wb");
+        if (!m_file) {
+            if (error) *error = "cannot create " + m_path;
+            return false;
+        }
+        std::setvbuf(m_file, nullptr, _IOFBF, 1 << 22);
+        // 先占住头的位置，关闭时回填
+        TrainingShardHeader header = makeHeader(0);
+        if (std::fwrite(&header, sizeof(header), 1, m_file) != 1) {
+            if (error) *error = "write failed: " + m_path;
+            return false;
+        }
+        m_count = 0;
+        m_shards++;
+        return true;
+    }
+};
+
+} // namespace
+
+TrainingExporter::TrainingExporter(const Options& options)
+    : m_options(options)
+{
+    if (m_options.threads <= 0) m_options.threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+void TrainingExporter::transform(int symmetry, int size, int& row, int& col)
+{
+    if (symmetry & 4) std::swap(row, col);
+    if (symmetry & 1) row = size - 1 - row;
+    if (symmetry & 2) col = size - 1 - col;
+}
+
+bool TrainingExporter::replay(const GameRecord& game, uint32_t gameIndex, Symmetry symmetry, uint64_t seed,
+                              std::vector<TrainingRecord>& out)
+{
+    const int size = game.size;
+    if (size < 5 || size > GoBoard::MAX_SIZE) return false;
+
+    GoBoard board(size);
+    // 没有PL时按第一手判断谁先下（让子棋白先）
+    PieceColor first = game.moves.empty() ? game.toPlay : game.moves.front().color;
+    if (!game.setup.empty() || first != PieceColor::Black) {
+        std::vector<int> black;
+        std::vector<int> white;
+        for (const ChessPiece& stone : game.setup) {
+            (stone.color == PieceColor::Black ? black : white).push_back(board.point(stone.row, stone.col));
+        }
+        if (!board.setup(black, white, first)) return false;
+    }
+    board.setRecording(false);
+
+    const int grid = size + 2;
+    std::vector<float> features(static_cast<size_t>(grid) * grid * GoNetwork::FEATURE_PLANES);
+    GoNetwork::Input input;
+    input.board = &board;
+    FastRng rng(seed ^ (static_cast<uint64_t>(gameIndex) + 1) * 0x9E3779B97F4A7C15ULL);
+    const size_t start = out.size();
+
+    for (size_t ply = 0; ply < game.moves.size(); ++ply) {
+        const ChessPiece& move = game.moves[ply];
+        // 颜色不交替或着法非法：这盘的样本整盘丢掉
+        int p = move.row < 0 ? GoBoard::PASS_MOVE : board.point(move.row, move.col);
+        if (move.color != board.toPlay() || !board.isLegal(p, move.color)) {
+            out.resize(start);
+            return false;
+        }
+
+        // 按推理时的输入取特征，再打包成位平面
+        std::fill(features.begin(), features.end(), 0.0f);
+        GoNetwork::buildFeatures(input, features.data(), size);
+        TrainingRecord base;
+        std::memset(&base, 0, sizeof(base));
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                const float* f = features.data() + static_cast<size_t>((row + 1) * grid + col + 1) * GoNetwork::FEATURE_PLANES;
+                int index = row * size + col;
+                for (int plane = 0; plane < GoNetwork::FEATURE_PLANES; ++plane) {
+                    if (f[plane] != 0.0f) base.planes[plane][index >> 6] |= uint64_t(1) << (index & 63);
+                }
+            }
+        }
+        base.move = static_cast<uint16_t>(move.row < 0 ? size * size : move.row * size + move.col);
+        base.value = game.winner == PieceColor::Empty ? 0 : (game.winner == move.color ? 1 : -1);
+        base.size = static_cast<uint8_t>(size);
+        base.score = static_cast<float>(move.color == PieceColor::Black ? game.score : -game.score);
+        base.komi = static_cast<float>(game.komi);
+        base.game = gameIndex;
+        base.ply = static_cast<uint32_t>(ply);
+
+        int firstSymmetry = 0;
+        int lastSymmetry = 0;
+        if (symmetry == Symmetry::Random) {
+            firstSymmetry = lastSymmetry = static_cast<int>(rng.below(8));
+        } else if (symmetry == Symmetry::All) {
+            lastSymmetry = 7;
+        }
+        for (int s = firstSymmetry; s <= lastSymmetry; ++s) {
+            if (s == 0) {
+                out.push_back(base);
+                continue;
+            }
+            TrainingRecord record = base;
+            record.symmetry = static_cast<uint8_t>(s);
+            std::memset(record.planes, 0, sizeof(record.planes));
+            for (int plane = 0; plane < GoNetwork::FEATURE_PLANES; ++plane) {
+                for (int w = 0; w < BoardBitset::WORDS; ++w) {
+                    for (uint64_t word = base.planes[plane][w]; word; word &= word - 1) {
+                        int index = w * 64 + __builtin_ctzll(word);
+                        int row = index / size;
+                        int col = index % size;
+                        transform(s, size, row, col);
+                        int mapped = row * size + col;
+                        record.planes[plane][mapped >> 6] |= uint64_t(1) << (mapped & 63);
+                    }
+                }
+            }
+            if (move.row >= 0) {
+                int row = move.row;
+                int col = move.col;
+                transform(s, size, row, col);
+                record.move = static_cast<uint16_t>(row * size + col);
+            }
+            out.push_back(record);
+        }
+
+        board.play(p, move.color);
+        for (int h = GoNetwork::HISTORY_MOVES - 1; h > 0; --h) {
+            input.history[h] = input.history[h - 1];
+        }
+        input.history[0] = p;
+    }
+    return true;
+}
+
+bool TrainingExporter::run(const std::vector<std::string>& inputs, std::string* error)
+{
+    m_stats = Stats();
+    auto begin = std::chrono::steady_clock::now();
+
+    BoundedQueue<QueuedGame> games(static_cast<size_t>(m_options.queuedGames));
+    BoundedQueue<QueuedBatch> batches(static_cast<size_t>(m_options.queuedBatches));
+    std::atomic<long long> skipped(0);
+    std::atomic<long long> positions(0);
+    std::atomic<int> activeWorkers(m_options.threads);
+
+    // 读取：二进制棋谱逐盘读，SGF整个文件读进来再解析
+    std::thread reader([&] {
+        uint32_t index = 0;
+        bool open = true;
+        for (size_t i = 0; i < inputs.size() && open; ++i) {
+            const std::string& path = inputs[i];
+            m_stats.files++;
+            if (GameArchive::isBinary(path)) {
+                FILE* file = std::fopen(path.c_str(), "rb");
+                bool ok = file && GameArchive::readHeader(file);
+                QueuedGame item;
+                std::string readError;
+                while (ok && open && GameArchive::readGame(file, item.record, &readError)) {
+                    item.index = index++;
+                    m_stats.games++;
+                    open = games.push(std::move(item));
+                    item = QueuedGame();
+                }
+                if (!ok || !readError.empty()) m_stats.badFiles++;
+                if (file) std::fclose(file);
+                continue;
+            }
+            std::ifstream file(path, std::ios::binary);
+            std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            std::vector<GameRecord> records;
+            if (!file.is_open() || !GameArchive::parseSgf(text, records)) m_stats.badFiles++;
+            for (GameRecord& record : records) {
+                QueuedGame item;
+                item.index = index++;
+                item.record = std::move(record);
+                m_stats.games++;
+                if (!(open = games.push(std::move(item)))) break;
+            }
+        }
+        games.close();
+    });
+
+    // 重排窗口：序号不小于nextIndex + window的批要等前面的写出后才能交，写出线程里待排的批因此不超过window个
+    // 读取线程按序号入队，正在重放的最小序号总在窗口内，不会互相等死
+    const uint32_t window = static_cast<uint32_t>(std::max(m_options.queuedBatches, m_options.threads));
+    std::mutex orderMutex;
+    std::condition_variable orderChanged;
+    uint32_t nextIndex = 0;
+    bool stopped = false;
+
+    // 重放：每盘的样本作为一批交给写出线程，最后一个退出的线程关闭样本队列
+    std::vector<std::thread> workers;
+    for (int t = 0; t < m_options.threads; ++t) {
+        workers.emplace_back([&] {
+            QueuedGame item;
+            while (games.pop(item)) {
+                QueuedBatch batch;
+                batch.index = item.index;
+                batch.records.reserve(item.record.moves.size() * (m_options.symmetry == Symmetry::All ? 8 : 1));
+                if (replay(item.record, item.index, m_options.symmetry, m_options.seed, batch.records)) {
+                    positions += static_cast<long long>(item.record.moves.size());
+                } else {
+                    skipped++;
+                }
+                {
+                    std::unique_lock<std::mutex> lock(orderMutex);
+                    orderChanged.wait(lock, [&] { return stopped || batch.index - nextIndex < window; });
+                }
+                if (!batches.push(std::move(batch))) break;
+            }
+            if (--activeWorkers == 0) batches.close();
+        });
+    }
+
+    // 写出在本线程，按序号排回输入顺序；写失败时关闭两个队列，上游阻塞的线程随即退出
+    ShardWriter writer(m_options.outputPrefix, m_options.recordsPerShard);
+    bool ok = true;
+    std::map<uint32_t, std::vector<TrainingRecord>> pending;
+    QueuedBatch batch;
+    while (ok && batches.pop(batch)) {
+        pending[batch.index] = std::move(batch.records);
+        for (auto it = pending.begin(); ok && it != pending.end() && it->first == nextIndex; it = pending.erase(it)) {
+            const std::vector<TrainingRecord>& records = it->second;
+            if (!writer.write(records.data(), records.size(), error)) {
+                ok = false;
+                break;
+            }
+            m_stats.records += static_cast<long long>(records.size());
+            std::lock_guard<std::mutex> lock(orderMutex);
+            nextIndex++;
+            orderChanged.notify_all();
+        }
+    }
+    if (!ok) {
+        {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            stopped = true;
+            orderChanged.notify_all();
+        }
+        games.close();
+        batches.close();
+    }
+    reader.join();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    if (ok) ok = writer.close(error);
+
+    m_stats.skippedGames = skipped.load();
+    m_stats.positions = positions.load();
+    m_stats.shards = writer.shards();
+    m_stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return ok;
+}
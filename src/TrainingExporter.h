@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardBitset.h"
+#include "GameArchive.h"
+#include "GoNetwork.h"
+
+// 训练样本：定长记录，分片文件去掉64字节头后可以直接mmap成TrainingRecord数组
+// 以轮到下的一方为视角，输入平面与GoNetwork::buildFeatures相同，每个平面按BoardBitset的位序打包
+struct TrainingRecord {
+    uint64_t planes[GoNetwork::FEATURE_PLANES][BoardBitset::WORDS]; // 第row * size + col位
+    uint16_t move;     // 策略目标：row * size + col，size * size为虚着
+    int8_t value;      // 价值目标：终局胜+1、负-1，和棋或不明0
+    uint8_t size;
+    uint8_t symmetry;  // 0-7，见TrainingExporter::transform
+    uint8_t reserved[3];
+    float score;       // 终局领先的目数（已扣贴目），不明时为0
+    float komi;        // 按黑方的贴目
+    uint32_t game;     // 在全部输入中的棋局序号
+    uint32_t ply;      // 这是第几手（从0数）
+};
+static_assert(sizeof(TrainingRecord) == 792, "record layout is part of the file format");
+
+// 分片文件头（小端），count在关闭分片时回填
+struct TrainingShardHeader {
+    char magic[4];     // "GOTD"
+    uint32_t version;  // 1
+    uint32_t recordSize;
+    uint32_t planes;
+    uint64_t count;
+    uint8_t reserved[40];
+};
+static_assert(sizeof(TrainingShardHeader) == 64, "header keeps records 64-byte aligned");
+
+// 训练数据导出流水线：读取线程 -> 重放线程池 -> 写出线程，之间用有界队列反压，内存占用与输入总量无关
+// 读取线程解析SGF/二进制棋谱，重放线程用GoBoard逐手重放并生成样本，写出线程按记录数切分片
+// 写出线程按棋局序号把各盘的样本排回输入顺序（重排窗口有界），随机对称按种子和棋局序号决定，
+// 所以同样的输入和选项不论线程数多少，写出的分片逐字节相同
+class TrainingExporter {
+public:
+    enum class Symmetry { None, Random, All }; // 不变换、每个局面随机取一种、八种全出
+
+    struct Options {
+        std::string outputPrefix = "train"; // 分片文件为 <prefix>-00000.gotd
+        int threads = 0;                    // 重放线程数，0为硬件线程数
+        long long recordsPerShard = 1 << 20;
+        int queuedGames = 256;              // 读取到重放之间最多排队的棋局
+        int queuedBatches = 32;             // 重放到写出之间最多排队的棋局样本批，也是重排窗口的大小（不小于线程数）
+        Symmetry symmetry = Symmetry::All;
+        uint64_t seed = 1;
+    };
+
+    struct Stats {
+        long long files = 0;
+        long long badFiles = 0;      // 打不开或解析出错的文件
+        long long games = 0;
+        long long skippedGames = 0;  // 棋盘大小不支持、摆子无效、着法非法或颜色不交替
+        long long positions = 0;
+        long long records = 0;
+        int shards = 0;
+        double seconds = 0.0;
+    };
+
+    explicit TrainingExporter(const Options& options);
+
+    // inputs为SGF或二进制棋谱文件；只有写出失败才返回false，单个输入文件的错误计入stats
+    bool run(const std::vector<std::string>& inputs, std::string* error = nullptr);
+    const Stats& stats() const { return m_stats; }
+
+    // 第s种对称（0为不变）：bit2转置，bit0上下翻，bit1左右翻
+    static void transform(int symmetry, int size, int& row, int& col);
+    // 一盘棋的全部样本追加到out；棋谱无效时返回false，out不变
+    static bool replay(const GameRecord& game, uint32_t gameIndex, Symmetry symmetry, uint64_t seed,
+                       std::vector<TrainingRecord>& out);
+
+private:
+    Options m_options;
+    Stats m_stats;
+};
@@ -0,0 +1,217 @@
+// TranspositionTable.cpp
+#include "TranspositionTable.h"
+#include <cstdlib>
+#include <new>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+int bitLength(int value)
+{
+    int bits = 0;
+    while (value > 0) {
+        bits++;
+        value >>= 1;
+    }
+    return bits;
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+    : m_buckets(nullptr)
+    , m_bucketCount(0)
+    , m_allocatedBytes(0)
+    , m_hugePages(false)
+    , m_mapped(false)
+    , m_generation(0)
+{
+    resize(megabytes);
+}
+
+TranspositionTable::~TranspositionTable()
+{
+    release();
+}
+
+size_t TranspositionTable::sizeFromEnvironment(size_t configuredMb)
+{
+    const char* value = std::getenv("CHESS_HASH_MB");
+    if (!value || !*value) return configuredMb;
+    long long megabytes = std::atoll(value);
+    return megabytes > 0 ? static_cast<size_t>(megabytes) : configuredMb;
+}
+
+void TranspositionTable::release()
+{
+    if (!m_buckets) return;
+#if defined(__linux__)
+    if (m_mapped) {
+        munmap(m_buckets, m_allocatedBytes);
+    } else
+#endif
+    {
+        ::operator delete(m_buckets, std::align_val_t(alignof(Bucket)));
+    }
+    m_buckets = nullptr;
+    m_bucketCount = 0;
+    m_allocatedBytes = 0;
+    m_hugePages = false;
+    m_mapped = false;
+}
+
+bool TranspositionTable::resize(size_t megabytes)
+{
+    release();
+
+    // 桶数取不超过给定大小的2的幂，下标直接取哈希低位
+    size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) {
+        count *= 2;
+    }
+    size_t bytes = count * sizeof(Bucket);
+
+    void* memory = nullptr;
+#if defined(__linux__)
+    // 先尝试预留的大页，没有再用普通页并建议内核使用透明大页
+    size_t hugeBytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    memory = mmap(nullptr, hugeBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memory != MAP_FAILED) {
+        m_hugePages = true;
+        m_allocatedBytes = hugeBytes;
+    } else {
+        memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return false;
+        if (bytes >= HUGE_PAGE_SIZE) madvise(memory, bytes, MADV_HUGEPAGE);
+        m_allocatedBytes = bytes;
+    }
+    m_mapped = true;
+#else
+    memory = ::operator new(bytes, std::align_val_t(alignof(Bucket)), std::nothrow);
+    if (!memory) return false;
+    m_allocatedBytes = bytes;
+#endif
+
+    m_buckets = static_cast<Bucket*>(memory);
+    m_bucketCount = count;
+    for (size_t i = 0; i < count; ++i) {
+        new (&m_buckets[i]) Bucket;
+    }
+    clear();
+    return true;
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < m_bucketCount; ++i) {
+        for (Slot& slot : m_buckets[i].slots) {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    m_generation.store(0, std::memory_order_relaxed);
+}
+
+uint64_t TranspositionTable::pack(const Entry& entry, uint64_t generation)
+{
+    // 位布局：着法16 | 分值16 | 深度8 | 边界2 | 代数5 | 占用1 | 访问次数16
+    uint64_t depth = static_cast<uint64_t>(entry.depth < 0 ? 0 : (entry.depth > 255 ? 255 : entry.depth));
+    uint64_t visits = static_cast<uint64_t>(entry.visits < 0 ? 0 : (entry.visits > 65535 ? 65535 : entry.visits));
+    return static_cast<uint64_t>(static_cast<uint16_t>(entry.move))
+           | static_cast<uint64_t>(static_cast<uint16_t>(entry.value)) << 16
+           | depth << 32
+           | static_cast<uint64_t>(entry.bound) << 40
+           | generation << 42
+           | uint64_t(1) << 47
+           | visits << 48;
+}
+
+void TranspositionTable::unpack(uint64_t data, Entry& entry)
+{
+    entry.move = static_cast<int16_t>(data & 0xFFFF);
+    entry.value = static_cast<int16_t>((data >> 16) & 0xFFFF);
+    entry.depth = static_cast<int>((data >> 32) & 0xFF);
+    entry.bound = static_cast<Bound>((data >> 40) & 3);
+    entry.visits = static_cast<int>(data >> 48);
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& entry) const
+{
+    if (!m_buckets) return false;
+    const Bucket& bucket = m_buckets[key & (m_bucketCount - 1)];
+    for (const Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+        if (occupied(data) && (check ^ data) == key) {
+            unpack(data, entry);
+            return true;
+        }
+    }
+    return false;
+}
+
+int TranspositionTable::replaceScore(uint64_t data) const
+{
+    // 越小越先被替换：空槽最先，其次旧代和浅层/少访问的条目
+    if (!occupied(data)) return -1000;
+    int age = static_cast<int>((generation() - generationOf(data)) & GENERATION_MASK);
+    int depth = static_cast<int>((data >> 32) & 0xFF);
+    int visits = static_cast<int>(data >> 48);
+    return depth + bitLength(visits) - 8 * age;
+}
+
+void TranspositionTable::store(uint64_t key, const Entry& entry)
+{
+    if (!m_buckets) return;
+    Bucket& bucket = m_buckets[key & (m_bucketCount - 1)];
+
+    Slot* target = nullptr;
+    uint64_t targetData = 0;
+    int worstScore = 0;
+    for (Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.keyXorData.load(std::memory_order_relaxed);
+        if (occupied(data) && (check ^ data) == key) {
+            target = &slot;
+            targetData = data;
+            break;
+        }
+        int score = replaceScore(data);
+        if (!target || score < worstScore) {
+            target = &slot;
+            targetData = data;
+            worstScore = score;
+        }
+    }
+
+    Entry merged = entry;
+    if (occupied(targetData) && (target->keyXorData.load(std::memory_order_relaxed) ^ targetData) == key) {
+        Entry old;
+        unpack(targetData, old);
+        // 同一局面：没有新着法时保留旧着法；较浅的非精确结果不覆盖较深的结果
+        if (merged.move == 0) merged.move = old.move;
+        if (merged.bound != BoundExact && merged.depth + 2 < old.depth && merged.visits <= old.visits) return;
+    }
+
+    uint64_t data = pack(merged, generation());
+    target->data.store(data, std::memory_order_relaxed);
+    target->keyXorData.store(key ^ data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const
+{
+    size_t buckets = m_bucketCount < 250 ? m_bucketCount : 250;
+    if (buckets == 0) return 0;
+    int used = 0;
+    for (size_t i = 0; i < buckets; ++i) {
+        for (const Slot& slot : m_buckets[i].slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if (occupied(data) && generationOf(data) == static_cast<int>(generation())) used++;
+        }
+    }
+    return static_cast<int>(used * 1000 / (buckets * SLOTS));
+}
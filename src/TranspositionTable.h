@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 固定大小、无锁、所有搜索线程共享的置换表
+// 每个槽两个64位字：key^data 和 data，读到撕裂写入时校验失败，当作未命中（Hyatt的异或校验）
+// 每桶4个槽，正好一个缓存行；按深度/访问次数和代数（每次newSearch加一）决定替换谁
+// 围棋和五子棋的搜索共用：alpha-beta用value/depth/bound，树搜索用value/visits
+class TranspositionTable {
+public:
+    enum Bound { BoundNone = 0, BoundUpper = 1, BoundLower = 2, BoundExact = 3 };
+
+    struct Entry {
+        int move = 0;      // 最佳着法（棋盘点号，0表示无）
+        int value = 0;     // 分数或胜率，范围为int16
+        int depth = 0;     // 搜索深度，0..255
+        Bound bound = BoundNone;
+        int visits = 0;    // 访问次数，超过65535时饱和
+    };
+
+    static const int DEFAULT_SIZE_MB = 64;
+
+    explicit TranspositionTable(size_t megabytes = DEFAULT_SIZE_MB);
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // 重新分配并清空，不能与搜索线程并发调用；分配失败返回false，表保持为空
+    bool resize(size_t megabytes);
+    void clear();
+    // 新一轮搜索开始，旧代的条目优先被替换；可以和其它线程的搜索同时调用（多盘棋共用一张表）
+    void newSearch() { m_generation.fetch_add(1, std::memory_order_relaxed); }
+
+    bool probe(uint64_t key, Entry& entry) const;
+    void store(uint64_t key, const Entry& entry);
+
+    // 当前代条目占比（千分比，抽样前1000个槽）
+    int hashfull() const;
+    size_t sizeInBytes() const { return m_bucketCount * sizeof(Bucket); }
+    bool usesHugePages() const { return m_hugePages; }
+
+    // 环境变量 CHESS_HASH_MB 可覆盖配置中的大小
+    static size_t sizeFromEnvironment(size_t configuredMb);
+
+private:
+    static const int SLOTS = 4;
+    static const uint64_t GENERATION_MASK = 31;
+
+    struct Slot {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[SLOTS];
+    };
+
+    Bucket* m_buckets;
+    size_t m_bucketCount; // 2的幂
+    size_t m_allocatedBytes;
+    bool m_hugePages;
+    bool m_mapped;
+    std::atomic<uint64_t> m_generation; // 用时取低5位
+
+    void release();
+    uint64_t generation() const { return m_generation.load(std::memory_order_relaxed) & GENERATION_MASK; }
+
+    static uint64_t pack(const Entry& entry, uint64_t generation);
+    static void unpack(uint64_t data, Entry& entry);
+    static int generationOf(uint64_t data) { return static_cast<int>((data >> 42) & GENERATION_MASK); }
+    static bool occupied(uint64_t data) { return (data >> 47) & 1; }
+    int replaceScore(uint64_t data) const;
+};
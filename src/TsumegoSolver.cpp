@@ -0,0 +1,335 @@
+// TsumegoSolver.cpp
+#include "TsumegoSolver.h"
+#include "LatencyTracer.h"
+#include <algorithm>
+
+TsumegoSolver::TsumegoSolver(int tableBits)
+    : m_tableBits(tableBits)
+    , m_inRegion()
+    , m_target(GoBoard::NO_POINT)
+    , m_defender(GoBoard::Empty)
+    , m_attacker(GoBoard::Empty)
+    , m_threatSide(GoBoard::Empty)
+    , m_nodes(0)
+    , m_nodeLimit(1000000)
+    , m_aborted(false)
+{
+}
+
+bool TsumegoSolver::enclosedRegion(const GoBoard& board, int target, int maxPoints, std::vector<int>& region)
+{
+    region.clear();
+    int defender = board.cell(target);
+    if (defender != GoBoard::Black && defender != GoBoard::White) return false;
+    int attacker = GoBoard::opponent(defender);
+
+    bool seen[GoBoard::MAX_POINTS] = {false};
+    bool seenGroup[GoBoard::MAX_POINTS] = {false};
+    std::vector<int> attackerGroups;
+    region.push_back(target);
+    seen[target] = true;
+    for (size_t i = 0; i < region.size(); ++i) {
+        for (int d = 0; d < 4; ++d) {
+            int n = region[i] + board.neighbour8(d);
+            int cell = board.cell(n);
+            if (seen[n] || cell == GoBoard::Border) continue;
+            if (cell == attacker) {
+                if (!seenGroup[board.groupOf(n)]) {
+                    seenGroup[board.groupOf(n)] = true;
+                    attackerGroups.push_back(board.groupOf(n));
+                }
+                continue;
+            }
+            seen[n] = true;
+            region.push_back(n);
+            if (static_cast<int>(region.size()) > maxPoints) return false;
+        }
+    }
+
+    // 气全在区域内的攻方棋块（扑进来的子、被围住的外壁）也要算进来，提掉后那些点可以再下
+    for (int g : attackerGroups) {
+        bool inside = true;
+        int s = g;
+        do {
+            for (int d = 0; d < 4 && inside; ++d) {
+                int n = s + board.neighbour8(d);
+                inside = board.cell(n) != GoBoard::Empty || seen[n];
+            }
+            s = board.nextStone(s);
+        } while (s != g && inside);
+        if (!inside) continue;
+        do {
+            region.push_back(s);
+            s = board.nextStone(s);
+        } while (s != g);
+    }
+    return static_cast<int>(region.size()) <= maxPoints;
+}
+
+TsumegoSolver::Result TsumegoSolver::solve(const GoBoard& board, int target, const std::vector<int>& region,
+                                           PieceColor toPlay)
+{
+    LATENCY_TRACE("TsumegoSolver::solve", "search");
+    Result result;
+    m_defender = board.cell(target);
+    if (m_defender != GoBoard::Black && m_defender != GoBoard::White) return result;
+    m_attacker = GoBoard::opponent(m_defender);
+    m_target = target;
+    m_board = board;
+    m_board.setRecording(true);
+    if (m_board.toPlay() != toPlay) m_board.pass(m_board.toPlay());
+
+    std::fill(m_inRegion, m_inRegion + GoBoard::MAX_POINTS, false);
+    m_region.clear();
+    for (int p : region) {
+        if (m_board.isOnBoard(p) && !m_inRegion[p]) {
+            m_inRegion[p] = true;
+            m_region.push_back(p);
+        }
+    }
+    if (m_table.empty()) m_table.resize(size_t(1) << m_tableBits);
+    m_nodes = 0;
+
+    // 守方有无限劫材仍被杀是净死，攻方有无限劫材仍杀不掉是净活，其余是劫
+    std::vector<int> defenderThreats;
+    bool killed = attackerWins(m_defender, defenderThreats);
+    if (!m_aborted) {
+        if (killed) {
+            result.status = Status::Dead;
+            result.variation = defenderThreats;
+        } else {
+            std::vector<int> attackerThreats;
+            killed = attackerWins(m_attacker, attackerThreats);
+            if (!m_aborted) {
+                result.status = killed ? Status::Ko : Status::Alive;
+                bool attackerFirst = static_cast<int>(toPlay) == m_attacker;
+                result.variation = killed && !attackerFirst ? defenderThreats : attackerThreats;
+            }
+        }
+    }
+    result.nodes = m_nodes;
+    return result;
+}
+
+bool TsumegoSolver::attackerWins(int threatSide, std::vector<int>& variation)
+{
+    m_threatSide = threatSide;
+    m_aborted = false;
+    std::fill(m_table.begin(), m_table.end(), Entry{0, 0, 0, GoBoard::NO_POINT});
+    m_path.clear();
+
+    mid(INF, INF);
+    if (m_aborted) return false;
+
+    const Entry* root = lookup(m_board.positionKey());
+    bool moverWins = root && root->phi == 0;
+    principalVariation(variation);
+    return moverWins == (static_cast<int>(m_board.toPlay()) == m_attacker);
+}
+
+void TsumegoSolver::mid(uint32_t thPhi, uint32_t thDelta)
+{
+    if (++m_nodes > m_nodeLimit) {
+        m_aborted = true;
+        return;
+    }
+    uint64_t key = m_board.positionKey();
+    int mover = static_cast<int>(m_board.toPlay());
+    // 终局都以证明过的结果存表，表里已有未证明的项说明不是终局，省掉Benson
+    if (!lookup(key)) {
+        int winner = outcome();
+        if (winner != GoBoard::Empty) {
+            store(key, winner == mover ? 0 : INF, winner == mover ? INF : 0, GoBoard::NO_POINT);
+            return;
+        }
+    }
+
+    std::vector<int> moves;
+    generateMoves(moves);
+    if (moves.empty()) {
+        store(key, INF, 0, GoBoard::NO_POINT);
+        return;
+    }
+    std::vector<uint64_t> keys(moves.size());
+    for (size_t i = 0; i < moves.size(); ++i) {
+        playMove(moves[i]);
+        keys[i] = m_board.positionKey();
+        undoMove(moves[i]);
+    }
+
+    // 同形重复或太深：攻方没能在循环内提掉目标，按守方胜计
+    // 这样的结果与到达路径有关，仍会写进置换表，局部死活里可以接受
+    bool defenderMovesNext = GoBoard::opponent(mover) == m_defender;
+    uint32_t cutoffPhi = defenderMovesNext ? 0 : INF;
+    uint32_t cutoffDelta = defenderMovesNext ? INF : 0;
+    bool tooDeep = static_cast<int>(m_path.size()) >= MAX_DEPTH;
+    m_path.push_back(key);
+
+    while (true) {
+        // 本结点的phi为子结点delta的最小值，delta为子结点phi之和
+        uint32_t phi = INF, delta = 0, bestPhi = INF, secondDelta = INF;
+        size_t best = 0;
+        for (size_t i = 0; i < moves.size(); ++i) {
+            uint32_t childPhi = 1, childDelta = 1;
+            if (tooDeep || onPath(keys[i])) {
+                childPhi = cutoffPhi;
+                childDelta = cutoffDelta;
+            } else if (const Entry* entry = lookup(keys[i])) {
+                childPhi = entry->phi;
+                childDelta = entry->delta;
+            }
+            delta = std::min(INF, delta + childPhi);
+            if (childDelta < phi) {
+                secondDelta = phi;
+                phi = childDelta;
+                bestPhi = childPhi;
+                best = i;
+            } else if (childDelta < secondDelta) {
+                secondDelta = childDelta;
+            }
+        }
+        if (phi >= thPhi || delta >= thDelta || m_aborted) {
+            store(key, phi, delta, moves[best]);
+            break;
+        }
+
+        // 1+ε技巧：第二好的子结点差出四分之一以上才切换，减少来回跳
+        uint32_t childThPhi = thDelta >= INF ? INF : thDelta + bestPhi - delta;
+        uint32_t childThDelta = std::min(thPhi, secondDelta + secondDelta / 4 + 1);
+        playMove(moves[best]);
+        mid(childThPhi, childThDelta);
+        undoMove(moves[best]);
+    }
+    m_path.pop_back();
+}
+
+int TsumegoSolver::outcome() const
+{
+    if (m_board.cell(m_target) != m_defender) return m_attacker;
+    if (!mayBePassAlive()) return GoBoard::Empty;
+    return m_board.isPassAlive(m_target) ? m_defender : GoBoard::Empty;
+}
+
+bool TsumegoSolver::mayBePassAlive() const
+{
+    // Benson的必要条件：至少两口气的空邻点也全是本块的气（属于只由本块围成的眼位）
+    bool liberty[GoBoard::MAX_POINTS] = {false};
+    int liberties[GoBoard::MAX_POINTS];
+    int count = 0;
+    int s = m_target;
+    do {
+        for (int d = 0; d < 4; ++d) {
+            int n = s + m_board.neighbour8(d);
+            if (m_board.cell(n) == GoBoard::Empty && !liberty[n]) {
+                liberty[n] = true;
+                liberties[count++] = n;
+            }
+        }
+        s = m_board.nextStone(s);
+    } while (s != m_target);
+    if (count < 2) return false;
+
+    int enclosed = 0;
+    for (int i = 0; i < count && enclosed < 2; ++i) {
+        bool inside = true;
+        for (int d = 0; d < 4 && inside; ++d) {
+            int n = liberties[i] + m_board.neighbour8(d);
+            inside = m_board.cell(n) != GoBoard::Empty || liberty[n];
+        }
+        if (inside) enclosed++;
+    }
+    return enclosed >= 2;
+}
+
+void TsumegoSolver::generateMoves(std::vector<int>& moves) const
+{
+    // 区域内的合法点；自己的眼只在相邻棋块被打吃时才填（粘劫）；守方可以虚着，攻方不能
+    PieceColor color = m_board.toPlay();
+    for (int p : m_region) {
+        if (m_board.cell(p) != GoBoard::Empty || !m_board.isLegal(p, color)) continue;
+        if (m_board.isSimpleEye(p, color)) {
+            bool atari = false;
+            for (int d = 0; d < 4; ++d) {
+                int n = p + m_board.neighbour8(d);
+                atari = atari || (m_board.cell(n) == static_cast<int>(color) && m_board.isInAtari(n));
+            }
+            if (!atari) continue;
+        }
+        moves.push_back(p);
+    }
+    int ko = m_board.koPoint();
+    if (static_cast<int>(color) == m_threatSide && ko != GoBoard::NO_POINT && m_inRegion[ko] &&
+        m_board.koColor() == color) {
+        moves.push_back(KO_THREAT);
+    }
+    if (static_cast<int>(color) == m_defender) moves.push_back(static_cast<int>(GoBoard::PASS_MOVE));
+}
+
+void TsumegoSolver::playMove(int move)
+{
+    PieceColor color = m_board.toPlay();
+    if (move == KO_THREAT) {
+        // 劫材抽象成：本方虚着、对方应一手（也是虚着），然后提回劫
+        int ko = m_board.koPoint();
+        m_board.pass(color);
+        m_board.pass(static_cast<PieceColor>(GoBoard::opponent(static_cast<int>(color))));
+        m_board.play(ko, color);
+    } else if (move == GoBoard::PASS_MOVE) {
+        m_board.pass(color);
+    } else {
+        m_board.play(move, color);
+    }
+}
+
+void TsumegoSolver::undoMove(int move)
+{
+    int count = move == KO_THREAT ? 3 : 1;
+    for (int i = 0; i < count; ++i) {
+        m_board.undo();
+    }
+}
+
+bool TsumegoSolver::onPath(uint64_t key) const
+{
+    return std::find(m_path.begin(), m_path.end(), key) != m_path.end();
+}
+
+const TsumegoSolver::Entry* TsumegoSolver::lookup(uint64_t key) const
+{
+    const Entry& entry = m_table[key & (m_table.size() - 1)];
+    return entry.key == key ? &entry : nullptr;
+}
+
+void TsumegoSolver::store(uint64_t key, uint32_t phi, uint32_t delta, int move)
+{
+    m_table[key & (m_table.size() - 1)] = {key, phi, delta, move};
+}
+
+void TsumegoSolver::principalVariation(std::vector<int>& variation)
+{
+    // 沿置换表记下的着法走到终局；缺表项、重复或着法不合法（键冲突）时停下
+    variation.clear();
+    std::vector<int> played;
+    m_path.clear();
+    while (static_cast<int>(variation.size()) < MAX_VARIATION && outcome() == GoBoard::Empty) {
+        uint64_t key = m_board.positionKey();
+        const Entry* entry = lookup(key);
+        if (!entry || entry->move == GoBoard::NO_POINT || onPath(key)) break;
+        int move = entry->move;
+        PieceColor color = m_board.toPlay();
+        if (move == KO_THREAT) {
+            if (m_board.koPoint() == GoBoard::NO_POINT || m_board.koColor() != color) break;
+            variation.push_back(m_board.koPoint());
+        } else {
+            if (!m_board.isLegal(move, color)) break;
+            variation.push_back(move);
+        }
+        m_path.push_back(key);
+        playMove(move);
+        played.push_back(move);
+    }
+    for (auto it = played.rbegin(); it != played.rend(); ++it) {
+        undoMove(*it);
+    }
+    m_path.clear();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "GoBoard.h"
+
+// 局部死活求解：深度优先证明数搜索（df-pn，含1+ε阈值），落子/撤销直接用GoBoard的增量棋块和气
+// 攻方提掉目标棋块即胜；目标成为无条件活棋（Benson）或攻方在区域内无棋可下则守方胜
+// 劫：分别让守方、攻方拥有无限劫材各解一次，两次结果不同即为劫
+class TsumegoSolver {
+public:
+    enum class Status { Alive, Dead, Ko, Unknown };
+
+    struct Result {
+        Status status = Status::Unknown;
+        std::vector<int> variation; // 主变化，PASS_MOVE表示虚着，找劫材提劫只记提劫的点
+        int nodes = 0;
+    };
+
+    // 置换表2^tableBits项，第一次求解时才分配
+    explicit TsumegoSolver(int tableBits = 16);
+
+    // 超过节点数上限时放弃，结果为Unknown
+    void setNodeLimit(int nodes) { m_nodeLimit = nodes; }
+
+    // target为目标棋块上任一点，region为双方可以落子的点；toPlay先走
+    Result solve(const GoBoard& board, int target, const std::vector<int>& region, PieceColor toPlay);
+
+    // 从目标出发经空点和守方棋子扩展的封闭区域，外加被包在里面的攻方棋子
+    // 区域超过maxPoints（没有被围住）时返回false
+    static bool enclosedRegion(const GoBoard& board, int target, int maxPoints, std::vector<int>& region);
+
+private:
+    static constexpr uint32_t INF = 0x3fffffff; // 两个INF相加也不会溢出
+    static constexpr int KO_THREAT = -2;       // 找劫材后提劫
+    static constexpr int MAX_DEPTH = 120;
+    static constexpr int MAX_VARIATION = 60;
+
+    struct Entry {
+        uint64_t key;
+        uint32_t phi;   // 轮到的一方获胜的证明数
+        uint32_t delta; // 轮到的一方获胜的反证数
+        int move;
+    };
+
+    GoBoard m_board;
+    std::vector<Entry> m_table;
+    int m_tableBits;
+    std::vector<int> m_region;
+    bool m_inRegion[GoBoard::MAX_POINTS];
+    std::vector<uint64_t> m_path;
+    int m_target;
+    int m_defender;
+    int m_attacker;
+    int m_threatSide;
+    int m_nodes;
+    int m_nodeLimit;
+    bool m_aborted;
+
+    bool attackerWins(int threatSide, std::vector<int>& variation);
+    void mid(uint32_t thPhi, uint32_t thDelta);
+    int outcome() const;
+    bool mayBePassAlive() const;
+    void generateMoves(std::vector<int>& moves) const;
+    void playMove(int move);
+    void undoMove(int move);
+    bool onPath(uint64_t key) const;
+    const Entry* lookup(uint64_t key) const;
+    void store(uint64_t key, uint32_t phi, uint32_t delta, int move);
+    void principalVariation(std::vector<int>& variation);
+};
@@ -1,12 +1,16 @@
 // main.cpp
 #include <QApplication>
 #include "ChessGame.h"
+#include "LatencyTracer.h"
 
 int main(int argc, char *argv[])
 {
+    // 首帧计时从这里开始，QApplication和主窗口的创建都算在内
+    int64_t launchUs = LatencyTracer::instance().nowUs();
     QApplication app(argc, argv);
 
     ChessGame game;
+    game.measureFirstFrame(launchUs);
     game.show();
 
     return app.exec();
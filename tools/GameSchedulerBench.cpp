@@ -0,0 +1,309 @@
+// GameSchedulerBench.cpp
+// 对局调度器压力测试：同时挂着大量五子棋对局，机器人每手之后按思考时间挂起，
+// 一部分对局的白方是模拟的远端玩家（网络线程隔一段延迟后回着，超过读秒判负），
+// 报告每秒完成的对局数、着手数，以及定时唤醒的迟到分布
+//
+// 用法: GameSchedulerBench [--games N] [--total N] [--threads T] [--think-us U]
+//                           [--remote-percent P] [--latency-us U] [--remote-clock-us U] [--seed S]
+
+#include "FastRng.h"
+#include "GameScheduler.h"
+#include "KInARow.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int games = 20000;        // 同时在下的对局数
+    long long total = 100000; // 一共下完多少局
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    int thinkUs = 2000;
+    int remotePercent = 25;
+    int latencyUs = 5000;
+    int remoteClockUs = 20000;
+    uint64_t seed = 1;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--games") && i + 1 < argc) {
+            options.games = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--total") && i + 1 < argc) {
+            options.total = std::atoll(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--think-us") && i + 1 < argc) {
+            options.thinkUs = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--remote-percent") && i + 1 < argc) {
+            options.remotePercent = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--latency-us") && i + 1 < argc) {
+            options.latencyUs = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--remote-clock-us") && i + 1 < argc) {
+            options.remoteClockUs = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr, "usage: %s [--games N] [--total N] [--threads T] [--think-us U] "
+                                 "[--remote-percent P] [--latency-us U] [--remote-clock-us U] [--seed S]\n", argv[0]);
+            return false;
+        }
+    }
+    if (options.threads < 1) options.threads = 1;
+    if (options.games < 1 || options.total < options.games || options.thinkUs < 0 || options.latencyUs < 0) {
+        std::fprintf(stderr, "invalid game counts or timings\n");
+        return false;
+    }
+    return true;
+}
+
+// 模拟的远端：收到请求后隔一段延迟再wake对应的对局
+class RemoteLink {
+public:
+    explicit RemoteLink(GameScheduler& scheduler) : m_scheduler(scheduler), m_quit(false)
+    {
+        m_thread = std::thread(&RemoteLink::run, this);
+    }
+
+    ~RemoteLink()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+        m_wake.notify_all();
+        m_thread.join();
+    }
+
+    void send(GameTask* task, int64_t deliverAtUs)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending.push({deliverAtUs, task});
+        }
+        m_wake.notify_all();
+    }
+
+private:
+    struct Reply {
+        int64_t deliverAtUs;
+        GameTask* task;
+
+        bool operator<(const Reply& other) const { return deliverAtUs > other.deliverAtUs; }
+    };
+
+    GameScheduler& m_scheduler;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::priority_queue<Reply> m_pending;
+    bool m_quit;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_quit) {
+            if (m_pending.empty()) {
+                m_wake.wait(lock);
+                continue;
+            }
+            int64_t now = GameScheduler::nowUs();
+            if (m_pending.top().deliverAtUs > now) {
+                m_wake.wait_until(lock, std::chrono::steady_clock::time_point(
+                    std::chrono::microseconds(m_pending.top().deliverAtUs)));
+                continue;
+            }
+            GameTask* task = m_pending.top().task;
+            m_pending.pop();
+            lock.unlock();
+            m_scheduler.wake(task);
+            lock.lock();
+        }
+    }
+};
+
+const int LATENESS_BUCKETS = 24; // 第b个桶统计迟到 [2^(b-1), 2^b) 微秒
+
+struct Shared {
+    const Options* options = nullptr;
+    GameScheduler* scheduler = nullptr;
+    RemoteLink* remote = nullptr;
+    std::atomic<long long> started{0};
+    std::atomic<long long> finished{0};
+    std::atomic<long long> moves{0};
+    std::atomic<long long> timeouts{0};
+    std::unique_ptr<std::atomic<long long>[]> lateness; // 每个工作线程LATENESS_BUCKETS个桶
+
+    void recordLateness(int worker, int64_t lateUs)
+    {
+        int bucket = 0;
+        while (lateUs > 0 && bucket + 1 < LATENESS_BUCKETS) {
+            lateUs >>= 1;
+            bucket++;
+        }
+        lateness[worker * LATENESS_BUCKETS + bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// 一局五子棋：黑方总是本地机器人，白方按比例是机器人或远端
+class BotGame : public GameTask {
+public:
+    BotGame(Shared& shared, uint64_t seed, bool remoteWhite)
+        : m_shared(shared), m_rng(seed), m_remoteWhite(remoteWhite) {}
+
+    TaskStep resume(GameScheduler& scheduler, int worker, bool timedOut) override
+    {
+        int64_t now = GameScheduler::nowUs();
+        if (m_awaitingRemote) {
+            if (timedOut) {
+                // 超时判负，但回复还在路上，等它到了再结束（之后不会再有人引用这个对局）
+                m_lostOnTime = true;
+                m_shared.timeouts.fetch_add(1, std::memory_order_relaxed);
+                return TaskStep::wait();
+            }
+            m_awaitingRemote = false;
+            if (m_lostOnTime) return finish(scheduler);
+            if (playRandom()) return finish(scheduler);
+        } else if (m_wakeAtUs >= 0) {
+            m_shared.recordLateness(worker, now - m_wakeAtUs);
+        }
+
+        // 本地机器人走一手
+        if (playRandom()) return finish(scheduler);
+        if (m_remoteWhite) {
+            m_awaitingRemote = true;
+            int latency = m_shared.options->latencyUs / 2 +
+                          static_cast<int>(m_rng.below(static_cast<uint32_t>(m_shared.options->latencyUs + 1)));
+            m_shared.remote->send(this, now + latency);
+            return TaskStep::wait(now + m_shared.options->remoteClockUs);
+        }
+        m_wakeAtUs = now + m_shared.options->thinkUs;
+        return TaskStep::sleepUntil(m_wakeAtUs);
+    }
+
+private:
+    Shared& m_shared;
+    FreestyleGomoku m_board;
+    FastRng m_rng;
+    bool m_remoteWhite;
+    bool m_awaitingRemote = false;
+    bool m_lostOnTime = false;
+    int64_t m_wakeAtUs = -1;
+
+    // 随机落一子，分出胜负或下满时返回true
+    bool playRandom()
+    {
+        const int rows = FreestyleGomoku::rows();
+        const int cols = FreestyleGomoku::cols();
+        if (m_board.stoneCount() >= rows * cols) return true;
+        int row, col;
+        do {
+            int p = static_cast<int>(m_rng.below(static_cast<uint32_t>(rows * cols)));
+            row = p / cols;
+            col = p % cols;
+        } while (m_board.at(row, col) != PieceColor::Empty);
+        m_board.play(row, col, m_board.toPlay());
+        m_shared.moves.fetch_add(1, std::memory_order_relaxed);
+        return m_board.isWin(row, col) || m_board.stoneCount() >= rows * cols;
+    }
+
+    TaskStep finish(GameScheduler& scheduler);
+};
+
+void spawnGame(Shared& shared, GameScheduler& scheduler)
+{
+    long long id = shared.started.fetch_add(1);
+    if (id >= shared.options->total) return;
+    uint64_t seed = shared.options->seed * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(id);
+    bool remote = static_cast<int>(id % 100) < shared.options->remotePercent;
+    scheduler.spawn(std::make_unique<BotGame>(shared, seed, remote));
+}
+
+TaskStep BotGame::finish(GameScheduler& scheduler)
+{
+    m_shared.finished.fetch_add(1, std::memory_order_relaxed);
+    spawnGame(m_shared, scheduler);
+    return TaskStep::done();
+}
+
+// 桶数组中累计到fraction的那个桶的上界（微秒）
+long long percentile(const std::vector<long long>& buckets, double fraction)
+{
+    long long total = 0;
+    for (long long count : buckets) {
+        total += count;
+    }
+    if (total == 0) return 0;
+    long long target = static_cast<long long>(fraction * total);
+    long long seen = 0;
+    for (int b = 0; b < LATENESS_BUCKETS; ++b) {
+        seen += buckets[b];
+        if (seen > target) return 1LL << b;
+    }
+    return 1LL << (LATENESS_BUCKETS - 1);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+
+    Shared shared;
+    shared.options = &options;
+    shared.lateness.reset(new std::atomic<long long>[options.threads * LATENESS_BUCKETS]);
+    for (int i = 0; i < options.threads * LATENESS_BUCKETS; ++i) {
+        shared.lateness[i].store(0);
+    }
+
+    long long peakLive = 0;
+    double seconds = 0.0;
+    long long resumes = 0, steals = 0;
+    {
+        GameScheduler scheduler(options.threads);
+        RemoteLink remote(scheduler);
+        shared.scheduler = &scheduler;
+        shared.remote = &remote;
+
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < options.games; ++i) {
+            spawnGame(shared, scheduler);
+        }
+        while (scheduler.liveTasks() > 0) {
+            peakLive = std::max(peakLive, scheduler.liveTasks());
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        scheduler.waitIdle();
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        resumes = scheduler.resumes();
+        steals = scheduler.steals();
+    }
+
+    std::vector<long long> buckets(LATENESS_BUCKETS, 0);
+    for (int t = 0; t < options.threads; ++t) {
+        for (int b = 0; b < LATENESS_BUCKETS; ++b) {
+            buckets[b] += shared.lateness[t * LATENESS_BUCKETS + b].load();
+        }
+    }
+
+    std::printf("%lld games (%d%% vs remote) on %d thread(s), %d live at a time, %zu bytes per game\n",
+                shared.finished.load(), options.remotePercent, options.threads, options.games, sizeof(BotGame));
+    std::printf("elapsed: %.2f s  games/s: %.0f  moves/s: %.0f  resumes/s: %.0f  steals: %lld\n",
+                seconds, shared.finished.load() / seconds, shared.moves.load() / seconds, resumes / seconds, steals);
+    std::printf("peak live games: %lld  remote timeouts: %lld\n", peakLive, shared.timeouts.load());
+    std::printf("timer lateness (us): p50 <%lld  p99 <%lld  p99.9 <%lld\n",
+                percentile(buckets, 0.5), percentile(buckets, 0.99), percentile(buckets, 0.999));
+    return 0;
+}
@@ -0,0 +1,215 @@
+// GameTreeBench.cpp
+// 着法树测试：先读一段带变化的SGF检查树形，再随机长出一棵多变化的树（期间随机删变化、调主线），
+// 然后在随机节点间跳转，每次与从根重放到目标节点的局面对拍
+// 报告节点数、每节点内存、跳转的平均代价（落子与撤销手数，按GameTree的规则远跳时从根重放）与一律从根重放的手数
+//
+// 用法: GameTreeBench [--size N] [--nodes N] [--jumps N] [--seed S]
+
+#include "FastRng.h"
+#include "GameArchive.h"
+#include "GameTree.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int size = 19;
+    int nodes = 200000;
+    int jumps = 100000;
+    uint64_t seed = 1;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            options.size = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--nodes") && i + 1 < argc) {
+            options.nodes = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--jumps") && i + 1 < argc) {
+            options.jumps = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr, "usage: %s [--size N] [--nodes N] [--jumps N] [--seed S]\n", argv[0]);
+            return false;
+        }
+    }
+    if (options.size < 5 || options.size > GoBoard::MAX_SIZE || options.nodes < 1 || options.jumps < 1) {
+        std::fprintf(stderr, "invalid board size, node count or jump count\n");
+        return false;
+    }
+    return true;
+}
+
+// 主线4手，第2手有一个变化，变化里又分两支；第3手是虚着
+bool checkSgf()
+{
+    const char* sgf = "(;GM[1]SZ[9]KM[7]AB[cc]PL[W];W[ee];B[gg](;W[tt];B[ce])"
+                      "(;W[gc](;B[cg])(;B[gd];W[dg])))";
+    GameTree tree;
+    std::string error;
+    if (!GameArchive::parseSgfTree(sgf, tree, &error)) {
+        std::printf("sgf: parse failed: %s\n", error.c_str());
+        return false;
+    }
+    bool ok = tree.size() == 9 && tree.current() == GameTree::ROOT && tree.nodeCount() == 9
+              && tree.board().at(2, 2) == PieceColor::Black && tree.board().toPlay() == PieceColor::White;
+    int second = tree.firstChild(tree.firstChild(GameTree::ROOT));
+    ok = ok && tree.childCount(second) == 2 && tree.move(tree.firstChild(second)) == GoBoard::PASS_MOVE;
+    int variation = tree.nextSibling(tree.firstChild(second));
+    ok = ok && tree.childCount(variation) == 2;
+    // 走到最深的变化末端
+    int leaf = tree.firstChild(tree.nextSibling(tree.firstChild(variation)));
+    tree.navigate(leaf);
+    ok = ok && tree.depth(leaf) == 5 && tree.board().at(3, 6) == PieceColor::Black
+         && tree.board().at(6, 3) == PieceColor::White && tree.board().at(2, 6) == PieceColor::White;
+    // 中途摆子不支持，非法着法报错
+    ok = ok && !GameArchive::parseSgfTree("(;SZ[9];B[ee](;W[cc])(;AB[dd]))", tree, &error);
+    ok = ok && !GameArchive::parseSgfTree("(;SZ[9];B[ee];W[ee])", tree, &error);
+    std::printf("sgf: %s\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+// 从根重放到node，得到独立算出的局面
+uint64_t replayKey(const GameTree& tree, const GoBoard& root, int node, std::vector<int>& path)
+{
+    path.clear();
+    for (int n = node; n != GameTree::ROOT; n = tree.parent(n)) {
+        path.push_back(n);
+    }
+    GoBoard board(root);
+    for (size_t i = path.size(); i-- > 0;) {
+        board.play(tree.move(path[i]), tree.color(path[i]));
+    }
+    return board.positionKey();
+}
+
+// 按navigate的规则数出从a跳到b的落子与撤销手数
+void jumpCost(const GameTree& tree, int a, int b, long long& plays, long long& undos)
+{
+    int target = b;
+    int up = 0;
+    int down = 0;
+    while (a != b) {
+        if (tree.depth(a) >= tree.depth(b)) {
+            a = tree.parent(a);
+            up++;
+        } else {
+            b = tree.parent(b);
+            down++;
+        }
+    }
+    if ((tree.depth(a) + 2) * GameTree::UNDOS_PER_PLAY < up) {
+        plays += tree.depth(target);
+    } else {
+        plays += down;
+        undos += up;
+    }
+}
+
+// 随机挑一个活节点
+int randomNode(const GameTree& tree, FastRng& rng, int capacity)
+{
+    for (;;) {
+        int node = static_cast<int>(rng.below(capacity));
+        if (tree.isValid(node)) return node;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+    bool ok = checkSgf();
+
+    // 让子局面作为根，检查根局面作为检查点也能正确恢复
+    GameTree tree(options.size);
+    int low = options.size >= 9 ? 2 : 1;
+    int high = options.size - 1 - low;
+    std::vector<int> black = {tree.board().point(low, low), tree.board().point(high, high)};
+    tree.setup(black, {}, PieceColor::White);
+    GoBoard root(tree.board());
+
+    // 长树：跳到随机节点，往下随机走几手；偶尔删一个变化或调一条主线
+    FastRng rng(options.seed);
+    BoardBitset moves;
+    int capacity = 1;
+    int removed = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (tree.nodeCount() < options.nodes) {
+        tree.navigate(randomNode(tree, rng, capacity));
+        int length = 1 + static_cast<int>(rng.below(20));
+        for (int i = 0; i < length; ++i) {
+            PieceColor color = tree.board().toPlay();
+            tree.board().legalMoves(color, moves, true);
+            int count = moves.count();
+            int p = GoBoard::PASS_MOVE;
+            if (count > 0 && rng.below(50) != 0) {
+                int index = moves.nth(static_cast<int>(rng.below(count)));
+                p = tree.board().point(index / options.size, index % options.size);
+            }
+            if (!tree.play(p, color)) {
+                std::printf("grow: legal move rejected\n");
+                return 1;
+            }
+            capacity = std::max(capacity, tree.current() + 1);
+        }
+        int action = static_cast<int>(rng.below(100));
+        int node = randomNode(tree, rng, capacity);
+        if (action < 2 && node != GameTree::ROOT) {
+            removed += tree.removeVariation(node) ? 1 : 0;
+        } else if (action < 5) {
+            tree.promoteToMainLine(node);
+        }
+    }
+    double growSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 随机跳转并对拍
+    std::vector<int> targets(options.jumps);
+    for (int& target : targets) {
+        target = randomNode(tree, rng, capacity);
+    }
+    long long plays = 0;
+    long long undos = 0;
+    long long replayCost = 0;
+    int mismatches = 0;
+    std::vector<int> path;
+    for (int target : targets) {
+        jumpCost(tree, tree.current(), target, plays, undos);
+        replayCost += tree.depth(target);
+        tree.navigate(target);
+        if (tree.current() != target || tree.board().positionKey() != replayKey(tree, root, target, path)) {
+            mismatches++;
+        }
+    }
+
+    // 单独计时跳转，取几轮里最快的一轮
+    double jumpSeconds = 0.0;
+    for (int round = 0; round < 3; ++round) {
+        tree.navigate(GameTree::ROOT);
+        start = std::chrono::steady_clock::now();
+        for (int target : targets) {
+            tree.navigate(target);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        jumpSeconds = round == 0 ? seconds : std::min(jumpSeconds, seconds);
+    }
+
+    std::printf("tree: %d nodes (%d variations removed), %.1f bytes/node, grown in %.2f s\n", tree.nodeCount(),
+                removed, static_cast<double>(tree.memoryBytes()) / tree.nodeCount(), growSeconds);
+    std::printf("jumps: %d, %d mismatches, %.1f plays + %.1f undos per jump vs %.1f plays replaying from root, "
+                "%.2f us per jump\n",
+                options.jumps, mismatches, static_cast<double>(plays) / options.jumps,
+                static_cast<double>(undos) / options.jumps,
+                static_cast<double>(replayCost) / options.jumps, jumpSeconds * 1e6 / options.jumps);
+    ok = ok && mismatches == 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// GoBench.cpp
+// 走子（playout）吞吐量测试：多线程从空棋盘反复把棋下完，报告每秒局数和胜率
+//
+// 用法: GoBench [--size N] [--playouts N] [--threads T] [--seed S]
+//              [--policy uniform|tactical|pattern] [--patterns FILE] [--komi K]
+//              [--pass-alive N]
+// --pass-alive 每N手检查一次无条件活棋以提前结束，0为关闭，默认按棋盘大小自动选取
+
+#include "FastRng.h"
+#include "GoPlayout.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int size = 19;
+    long long playouts = 20000;
+    int threads = 1;
+    uint64_t seed = 1;
+    PlayoutPolicy policy = PlayoutPolicy::Tactical;
+    std::string patterns;
+    double komi = 7.5;
+    int passAliveInterval = -1;
+};
+
+struct ThreadTotals {
+    long long playouts = 0;
+    long long moves = 0;
+    long long blackWins = 0;
+    long long passAliveStops = 0;
+};
+
+bool parsePolicy(const char* name, PlayoutPolicy& policy)
+{
+    if (!std::strcmp(name, "uniform")) {
+        policy = PlayoutPolicy::Uniform;
+    } else if (!std::strcmp(name, "tactical")) {
+        policy = PlayoutPolicy::Tactical;
+    } else if (!std::strcmp(name, "pattern")) {
+        policy = PlayoutPolicy::Pattern;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            options.size = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--playouts") && i + 1 < argc) {
+            options.playouts = std::atoll(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--policy") && i + 1 < argc && parsePolicy(argv[i + 1], options.policy)) {
+            ++i;
+        } else if (!std::strcmp(argv[i], "--patterns") && i + 1 < argc) {
+            options.patterns = argv[++i];
+        } else if (!std::strcmp(argv[i], "--komi") && i + 1 < argc) {
+            options.komi = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--pass-alive") && i + 1 < argc) {
+            options.passAliveInterval = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--size N] [--playouts N] [--threads T] [--seed S]"
+                         " [--policy uniform|tactical|pattern] [--patterns FILE] [--komi K] [--pass-alive N]\n",
+                         argv[0]);
+            return false;
+        }
+    }
+    if (options.size < 2 || options.size > GoBoard::MAX_SIZE || options.threads < 1) {
+        std::fprintf(stderr, "invalid board size or thread count\n");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+
+    GoPatterns patterns;
+    if (!options.patterns.empty()) {
+        std::string error;
+        if (!patterns.loadFile(options.patterns, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+    }
+
+    const GoBoard start(options.size);
+    std::atomic<long long> next(0);
+    std::vector<ThreadTotals> totals(options.threads);
+    std::vector<std::thread> workers;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < options.threads; ++t) {
+        workers.emplace_back([&, t] {
+            FastRng rng(options.seed + static_cast<uint64_t>(t) * 0x9E3779B97F4A7C15ULL);
+            GoPlayout playout(options.policy, options.patterns.empty() ? nullptr : &patterns);
+            playout.setKomi(options.komi);
+            playout.setPassAliveInterval(options.passAliveInterval);
+            ThreadTotals& mine = totals[t];
+            while (next.fetch_add(1, std::memory_order_relaxed) < options.playouts) {
+                GoBoard board = start;
+                PlayoutResult result = playout.run(board, rng);
+                mine.playouts++;
+                mine.moves += result.moves;
+                if (result.winner() == PieceColor::Black) mine.blackWins++;
+                if (result.passAlive) mine.passAliveStops++;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    ThreadTotals sum;
+    for (const auto& part : totals) {
+        sum.playouts += part.playouts;
+        sum.moves += part.moves;
+        sum.blackWins += part.blackWins;
+        sum.passAliveStops += part.passAliveStops;
+    }
+    if (sum.playouts == 0) return 0;
+
+    std::printf("%lld playouts on %dx%d with %d thread(s) in %.3f s\n",
+                sum.playouts, options.size, options.size, options.threads, seconds);
+    std::printf("playouts/s: %.0f   moves/s: %.0f   avg moves: %.1f\n",
+                sum.playouts / seconds, sum.moves / seconds, static_cast<double>(sum.moves) / sum.playouts);
+    std::printf("black wins: %.1f%%   pass-alive stops: %.1f%%\n",
+                100.0 * sum.blackWins / sum.playouts, 100.0 * sum.passAliveStops / sum.playouts);
+    return 0;
+}
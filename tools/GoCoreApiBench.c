@@ -0,0 +1,223 @@
+// GoCoreApiBench.c
+// C接口测试：用纯C编译，确认头文件不依赖C++；先检查撤销、试下、克隆后局面键不变，
+// 再让同一批随机对局分别用逐盘调用和批量调用推进，确认终局完全一致，并报告两种方式的每秒落子数
+// C程序直接调用几乎没有额外开销，两者应当持平；跨语言调用的开销见GoCoreFfiBench.py
+//
+// 用法: GoCoreApiBench [--size N] [--games N] [--seed S]
+
+#include "GoCoreApi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    int size;
+    int games;
+    uint64_t seed;
+} Options;
+
+static int parseOptions(int argc, char* argv[], Options* options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            options->size = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--games") && i + 1 < argc) {
+            options->games = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options->seed = strtoull(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--size N] [--games N] [--seed S]\n", argv[0]);
+            return 0;
+        }
+    }
+    if (options->size < 5 || options->size > GOCORE_MAX_SIZE || options->games < 1) {
+        fprintf(stderr, "invalid board size or game count\n");
+        return 0;
+    }
+    return 1;
+}
+
+static double seconds(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static uint64_t nextRandom(uint64_t* state)
+{
+    // xorshift64*
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+static int popcount64(uint64_t word)
+{
+    int count = 0;
+    for (; word; word &= word - 1) {
+        count++;
+    }
+    return count;
+}
+
+// 在位集里均匀随机取一个点，没有时虚着
+static int pickMove(const uint64_t* words, int count, uint64_t* state)
+{
+    if (count == 0) return GOCORE_PASS;
+    int n = (int)(nextRandom(state) % (uint64_t)count);
+    for (int i = 0; i < GOCORE_BITSET_WORDS; ++i) {
+        int bits = popcount64(words[i]);
+        if (n < bits) {
+            uint64_t word = words[i];
+            for (; n > 0; --n) {
+                word &= word - 1;
+            }
+            return i * 64 + __builtin_ctzll(word);
+        }
+        n -= bits;
+    }
+    return GOCORE_PASS;
+}
+
+static int checkBasics(int size)
+{
+    gocore_game* game = gocore_create(size);
+    if (!game || gocore_create(4) || gocore_create(GOCORE_MAX_SIZE + 1)) {
+        fprintf(stderr, "create accepted or rejected the wrong sizes\n");
+        return 0;
+    }
+    uint64_t start = gocore_hash(game);
+    int moves[] = {0, 1, size, 2 * size, size + 1};
+    if (gocore_play_many(game, moves, 5) != 5 || gocore_play(game, 0)) {
+        fprintf(stderr, "play_many or the occupied-point check failed\n");
+        return 0;
+    }
+    uint64_t played = gocore_hash(game);
+
+    // 试下不改变局面
+    int candidates[GOCORE_MAX_SIZE * GOCORE_MAX_SIZE];
+    int captures[GOCORE_MAX_SIZE * GOCORE_MAX_SIZE];
+    for (int i = 0; i < size * size; ++i) {
+        candidates[i] = i;
+    }
+    uint64_t words[GOCORE_BITSET_WORDS];
+    int legal = gocore_legal_moves(game, 0, words);
+    if (gocore_try_moves(game, candidates, size * size, captures, NULL) != legal || gocore_hash(game) != played) {
+        fprintf(stderr, "try_moves disagrees with legal_moves or changed the position\n");
+        return 0;
+    }
+
+    gocore_game* copy = gocore_clone(game);
+    if (gocore_hash(copy) != played || gocore_undo_many(copy, 100) != 5 || gocore_hash(copy) != start ||
+        gocore_hash(game) != played) {
+        fprintf(stderr, "clone or undo_many did not restore the start position\n");
+        return 0;
+    }
+
+    // 让子：摆两颗黑子，白先
+    int handicap[] = {3 * size + 3, (size - 4) * size + size - 4};
+    if (!gocore_setup(copy, handicap, 2, NULL, 0, GOCORE_WHITE) || gocore_to_play(copy) != GOCORE_WHITE ||
+        gocore_undo(copy)) {
+        fprintf(stderr, "setup failed\n");
+        return 0;
+    }
+    gocore_destroy(copy);
+    gocore_destroy(game);
+    return 1;
+}
+
+// batch为0时逐盘调用，否则一次调用处理全部对局；返回总落子数，终局局面键写入hashes
+static long long runGames(const Options* options, int batch, uint64_t* hashes, double* elapsed)
+{
+    int count = options->games;
+    gocore_game** games = malloc(sizeof(gocore_game*) * count);
+    uint64_t* words = malloc(sizeof(uint64_t) * GOCORE_BITSET_WORDS * count);
+    int* counts = malloc(sizeof(int) * count);
+    int* moves = malloc(sizeof(int) * count);
+    int* passes = calloc(count, sizeof(int));
+    int8_t* ok = malloc(count);
+    for (int i = 0; i < count; ++i) {
+        games[i] = gocore_create(options->size);
+        gocore_set_recording(games[i], 0);
+    }
+
+    uint64_t state = options->seed * 0x9E3779B97F4A7C15ULL + 1;
+    int maxMoves = 3 * options->size * options->size;
+    long long total = 0;
+    double begin = seconds();
+    for (int ply = 0; ply < maxMoves; ++ply) {
+        if (batch) {
+            gocore_legal_moves_batch((const gocore_game* const*)games, count, GOCORE_SKIP_OWN_EYES, words, counts);
+        } else {
+            for (int i = 0; i < count; ++i) {
+                counts[i] = gocore_legal_moves(games[i], GOCORE_SKIP_OWN_EYES, words + i * GOCORE_BITSET_WORDS);
+            }
+        }
+        // 下完的盘一直虚着，两种方式取随机数的次序相同
+        int active = 0;
+        for (int i = 0; i < count; ++i) {
+            moves[i] = passes[i] >= 2 ? GOCORE_PASS : pickMove(words + i * GOCORE_BITSET_WORDS, counts[i], &state);
+            active += passes[i] < 2;
+        }
+        if (active == 0) break;
+        if (batch) {
+            gocore_play_batch(games, moves, count, ok);
+        } else {
+            for (int i = 0; i < count; ++i) {
+                ok[i] = (int8_t)gocore_play(games[i], moves[i]);
+            }
+        }
+        for (int i = 0; i < count; ++i) {
+            if (passes[i] >= 2) continue;
+            passes[i] = moves[i] == GOCORE_PASS ? passes[i] + 1 : 0;
+            total += ok[i];
+        }
+    }
+    *elapsed = seconds() - begin;
+
+    for (int i = 0; i < count; ++i) {
+        hashes[i] = gocore_hash(games[i]);
+        gocore_destroy(games[i]);
+    }
+    free(games);
+    free(words);
+    free(counts);
+    free(moves);
+    free(passes);
+    free(ok);
+    return total;
+}
+
+int main(int argc, char* argv[])
+{
+    Options options = {19, 256, 1};
+    if (!parseOptions(argc, argv, &options)) return 2;
+    if (gocore_api_version() != GOCORE_API_VERSION) {
+        fprintf(stderr, "library version %d does not match header version %d\n", gocore_api_version(),
+                GOCORE_API_VERSION);
+        return 1;
+    }
+    if (!checkBasics(options.size)) return 1;
+
+    uint64_t* single = malloc(sizeof(uint64_t) * options.games);
+    uint64_t* batched = malloc(sizeof(uint64_t) * options.games);
+    double singleSeconds = 0.0;
+    double batchSeconds = 0.0;
+    long long singleMoves = runGames(&options, 0, single, &singleSeconds);
+    long long batchMoves = runGames(&options, 1, batched, &batchSeconds);
+    if (singleMoves != batchMoves || memcmp(single, batched, sizeof(uint64_t) * options.games) != 0) {
+        fprintf(stderr, "batched calls reached different positions than single calls\n");
+        return 1;
+    }
+
+    printf("api checks passed; %d games on %dx%d, %lld moves each way\n", options.games, options.size,
+           options.size, singleMoves);
+    printf("single calls: %.0f moves/s   batch calls: %.0f moves/s\n", singleMoves / singleSeconds,
+           batchMoves / batchSeconds);
+    free(single);
+    free(batched);
+    return 0;
+}
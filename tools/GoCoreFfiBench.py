@@ -0,0 +1,226 @@
+# GoCoreFfiBench.py
+# C接口的跨语言调用开销测试：用Python ctypes调用共享库gocore，
+# 让同一批随机对局分别用逐盘调用和批量调用推进，确认终局完全一致，并报告两种方式的每秒落子数；
+# 再把这些对局的着法按逐手gocore_play、每盘一次gocore_play_many、每手一次gocore_play_batch重放，
+# 只比较落子本身的调用开销
+#
+# 用法: python3 GoCoreFfiBench.py [--lib PATH] [--size N] [--games N] [--seed S]
+
+import argparse
+import ctypes
+import os
+import sys
+import time
+
+GOCORE_API_VERSION = 1
+GOCORE_PASS = -1
+GOCORE_MAX_SIZE = 19
+GOCORE_BITSET_WORDS = 6
+GOCORE_SKIP_OWN_EYES = 1
+
+Words = ctypes.c_uint64 * GOCORE_BITSET_WORDS
+
+
+def load(path):
+    lib = ctypes.CDLL(path)
+    game = ctypes.c_void_p
+    games = ctypes.POINTER(ctypes.c_void_p)
+    ints = ctypes.POINTER(ctypes.c_int)
+    words = ctypes.POINTER(ctypes.c_uint64)
+    signatures = {
+        "gocore_api_version": (ctypes.c_int, []),
+        "gocore_create": (game, [ctypes.c_int]),
+        "gocore_destroy": (None, [game]),
+        "gocore_set_recording": (None, [game, ctypes.c_int]),
+        "gocore_hash": (ctypes.c_uint64, [game]),
+        "gocore_play": (ctypes.c_int, [game, ctypes.c_int]),
+        "gocore_legal_moves": (ctypes.c_int, [game, ctypes.c_int, words]),
+        "gocore_play_many": (ctypes.c_int, [game, ints, ctypes.c_int]),
+        "gocore_play_batch": (ctypes.c_int, [games, ints, ctypes.c_int, ctypes.POINTER(ctypes.c_int8)]),
+        "gocore_legal_moves_batch": (None, [games, ctypes.c_int, ctypes.c_int, words, ints]),
+    }
+    for name, (result, arguments) in signatures.items():
+        function = getattr(lib, name)
+        function.restype = result
+        function.argtypes = arguments
+    return lib
+
+
+class Random:
+    # xorshift64*，与GoCoreApiBench.c相同
+    MASK = (1 << 64) - 1
+
+    def __init__(self, seed):
+        self.state = (seed * 0x9E3779B97F4A7C15 + 1) & self.MASK
+
+    def next(self):
+        state = self.state
+        state ^= state >> 12
+        state ^= (state << 25) & self.MASK
+        state ^= state >> 27
+        self.state = state
+        return (state * 0x2545F4914F6CDD1D) & self.MASK
+
+
+def pick_move(words, count, random):
+    # 在位集里均匀随机取一个点，没有时虚着
+    if count == 0:
+        return GOCORE_PASS
+    n = random.next() % count
+    for i in range(GOCORE_BITSET_WORDS):
+        word = words[i]
+        bits = bin(word).count("1")
+        if n < bits:
+            for _ in range(n):
+                word &= word - 1
+            return i * 64 + (word & -word).bit_length() - 1
+        n -= bits
+    return GOCORE_PASS
+
+
+def create_games(lib, size, count):
+    games = (ctypes.c_void_p * count)()
+    for i in range(count):
+        games[i] = lib.gocore_create(size)
+        lib.gocore_set_recording(games[i], 0)
+    return games
+
+
+def finish_games(lib, games):
+    hashes = [lib.gocore_hash(game) for game in games]
+    for game in games:
+        lib.gocore_destroy(game)
+    return hashes
+
+
+def run_games(lib, options, batch):
+    # batch为False时逐盘调用，否则一次调用处理全部对局；返回落子数、用时、终局局面键和每盘的着法
+    count = options.games
+    games = create_games(lib, options.size, count)
+    words = (ctypes.c_uint64 * (GOCORE_BITSET_WORDS * count))()
+    rows = [Words.from_buffer(words, i * ctypes.sizeof(Words)) for i in range(count)]
+    counts = (ctypes.c_int * count)()
+    moves = (ctypes.c_int * count)()
+    ok = (ctypes.c_int8 * count)()
+    passes = [0] * count
+    records = [[] for _ in range(count)]
+    random = Random(options.seed)
+    total = 0
+    begin = time.perf_counter()
+    for _ in range(3 * options.size * options.size):
+        if batch:
+            lib.gocore_legal_moves_batch(games, count, GOCORE_SKIP_OWN_EYES, words, counts)
+        else:
+            for i in range(count):
+                counts[i] = lib.gocore_legal_moves(games[i], GOCORE_SKIP_OWN_EYES, rows[i])
+        # 下完的盘一直虚着，两种方式取随机数的次序相同
+        active = 0
+        for i in range(count):
+            moves[i] = GOCORE_PASS if passes[i] >= 2 else pick_move(rows[i], counts[i], random)
+            active += passes[i] < 2
+        if active == 0:
+            break
+        if batch:
+            lib.gocore_play_batch(games, moves, count, ok)
+        else:
+            for i in range(count):
+                ok[i] = lib.gocore_play(games[i], moves[i])
+        for i in range(count):
+            if passes[i] >= 2:
+                continue
+            passes[i] = passes[i] + 1 if moves[i] == GOCORE_PASS else 0
+            total += ok[i]
+            if ok[i]:
+                records[i].append(moves[i])
+    elapsed = time.perf_counter() - begin
+    return total, elapsed, finish_games(lib, games), records
+
+
+def replay(lib, options, records, mode):
+    # 重放已知的合法着法，返回用时和终局局面键
+    count = len(records)
+    games = create_games(lib, options.size, count)
+    if mode == "single":
+        begin = time.perf_counter()
+        for i in range(count):
+            game = games[i]
+            for move in records[i]:
+                lib.gocore_play(game, move)
+    elif mode == "many":
+        arrays = [(ctypes.c_int * len(record))(*record) for record in records]
+        begin = time.perf_counter()
+        for i in range(count):
+            lib.gocore_play_many(games[i], arrays[i], len(records[i]))
+    else:
+        # 每手一批，只含还没下完的盘
+        batches = []
+        for ply in range(max(len(record) for record in records)):
+            playing = [i for i in range(count) if ply < len(records[i])]
+            batches.append(((ctypes.c_void_p * len(playing))(*(games[i] for i in playing)),
+                            (ctypes.c_int * len(playing))(*(records[i][ply] for i in playing)),
+                            len(playing)))
+        ok = (ctypes.c_int8 * count)()
+        begin = time.perf_counter()
+        for playing, moves, size in batches:
+            lib.gocore_play_batch(playing, moves, size, ok)
+    elapsed = time.perf_counter() - begin
+    return elapsed, finish_games(lib, games)
+
+
+def default_library():
+    here = os.path.dirname(os.path.abspath(__file__))
+    if sys.platform == "win32":
+        name = "gocore.dll"
+    elif sys.platform == "darwin":
+        name = "libgocore.dylib"
+    else:
+        name = "libgocore.so"
+    for directory in [os.getcwd(), os.path.join(here, "..", "build"), here]:
+        path = os.path.join(directory, name)
+        if os.path.exists(path):
+            return path
+    return name
+
+
+def main():
+    parser = argparse.ArgumentParser(description="gocore FFI call overhead benchmark")
+    parser.add_argument("--lib", default=None, help="path to the gocore shared library")
+    parser.add_argument("--size", type=int, default=19)
+    parser.add_argument("--games", type=int, default=256)
+    parser.add_argument("--seed", type=int, default=1)
+    options = parser.parse_args()
+    if options.size < 5 or options.size > GOCORE_MAX_SIZE or options.games < 1:
+        print("invalid board size or game count", file=sys.stderr)
+        return 2
+
+    lib = load(options.lib or default_library())
+    if lib.gocore_api_version() != GOCORE_API_VERSION:
+        print("library version %d does not match script version %d" % (lib.gocore_api_version(), GOCORE_API_VERSION),
+              file=sys.stderr)
+        return 1
+
+    single_moves, single_seconds, single_hashes, records = run_games(lib, options, False)
+    batch_moves, batch_seconds, batch_hashes, _ = run_games(lib, options, True)
+    if single_moves != batch_moves or single_hashes != batch_hashes:
+        print("batched calls reached different positions than single calls", file=sys.stderr)
+        return 1
+    print("%d games on %dx%d, %d moves each way" % (options.games, options.size, options.size, single_moves))
+    print("random games  single calls: %.0f moves/s   batch calls: %.0f moves/s"
+          % (single_moves / single_seconds, batch_moves / batch_seconds))
+
+    # 重放只剩落子调用，差别就是每次跨语言调用的开销；下完的盘不再补虚着，终局只在三种重放之间比较
+    line = "replay       "
+    replay_hashes = None
+    for mode, label in [("single", "gocore_play"), ("many", "gocore_play_many"), ("batch", "gocore_play_batch")]:
+        seconds, hashes = replay(lib, options, records, mode)
+        replay_hashes = replay_hashes or hashes
+        if hashes != replay_hashes:
+            print("%s replay reached different positions" % label, file=sys.stderr)
+            return 1
+        line += "  %s: %.0f moves/s" % (label, single_moves / seconds)
+    print(line)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,189 @@
+// GoNetBench.cpp
+// 策略/价值网络推理吞吐量测试，并比较Int16与Float32两条路径的输出差异
+//
+// 用法: GoNetBench --weights FILE [--size N] [--batch B] [--evals N] [--precision auto|int16|float]
+//       GoNetBench --random FILE [--channels C] [--blocks B] [--hidden H] [--seed S]
+// --random 写出随机初始化的权重文件（只用于测试推理速度和正确性）
+
+#include "FastRng.h"
+#include "GoNetwork.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string weights;
+    std::string randomOutput;
+    int size = 19;
+    int batch = 8;
+    int evals = 64;
+    GoNetwork::Precision precision = GoNetwork::Precision::Auto;
+    int channels = 64;
+    int blocks = 6;
+    int hidden = 64;
+    uint64_t seed = 1;
+};
+
+void writeFloats(std::ofstream& file, FastRng& rng, size_t count, float range)
+{
+    std::vector<float> values(count);
+    for (auto& value : values) {
+        value = static_cast<float>((rng.uniform() * 2.0 - 1.0) * range);
+    }
+    file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(count * sizeof(float)));
+}
+
+bool writeRandomNetwork(const Options& options)
+{
+    std::ofstream file(options.randomOutput, std::ios::binary);
+    if (!file) return false;
+    const uint32_t header[7] = {1, GoNetwork::FEATURE_PLANES, static_cast<uint32_t>(options.channels),
+                                static_cast<uint32_t>(options.blocks), static_cast<uint32_t>(options.hidden), 0, 0};
+    file.write("GONN", 4);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    // 均匀分布的He初始化，残差块第二层缩小避免激活随层数爆炸
+    FastRng rng(options.seed);
+    const int C = options.channels;
+    writeFloats(file, rng, static_cast<size_t>(C) * 9 * GoNetwork::FEATURE_PLANES,
+                std::sqrt(6.0f / (9 * GoNetwork::FEATURE_PLANES)));
+    writeFloats(file, rng, C, 0.1f);
+    for (int b = 0; b < options.blocks; ++b) {
+        writeFloats(file, rng, static_cast<size_t>(C) * 9 * C, std::sqrt(6.0f / (9 * C)));
+        writeFloats(file, rng, C, 0.1f);
+        writeFloats(file, rng, static_cast<size_t>(C) * 9 * C, 0.5f * std::sqrt(6.0f / (9 * C)));
+        writeFloats(file, rng, C, 0.1f);
+    }
+    writeFloats(file, rng, C + 1, std::sqrt(6.0f / C));
+    writeFloats(file, rng, C + 1, std::sqrt(6.0f / C));
+    writeFloats(file, rng, static_cast<size_t>(options.hidden) * C + options.hidden, std::sqrt(6.0f / C));
+    writeFloats(file, rng, options.hidden + 1, std::sqrt(6.0f / options.hidden));
+    return static_cast<bool>(file);
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--weights") && i + 1 < argc) {
+            options.weights = argv[++i];
+        } else if (!std::strcmp(argv[i], "--random") && i + 1 < argc) {
+            options.randomOutput = argv[++i];
+        } else if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            options.size = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--batch") && i + 1 < argc) {
+            options.batch = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--evals") && i + 1 < argc) {
+            options.evals = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--precision") && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "int16") {
+                options.precision = GoNetwork::Precision::Int16;
+            } else if (name == "float") {
+                options.precision = GoNetwork::Precision::Float32;
+            } else if (name != "auto") {
+                return false;
+            }
+        } else if (!std::strcmp(argv[i], "--channels") && i + 1 < argc) {
+            options.channels = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--blocks") && i + 1 < argc) {
+            options.blocks = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--hidden") && i + 1 < argc) {
+            options.hidden = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    if (options.weights.empty() == options.randomOutput.empty()) return false;
+    return options.size >= 2 && options.size <= GoBoard::MAX_SIZE && options.batch >= 1 && options.evals >= 1;
+}
+
+// 随机下若干手得到中盘局面
+GoBoard randomPosition(int size, FastRng& rng)
+{
+    GoBoard board(size);
+    board.setRecording(false);
+    int moves = static_cast<int>(rng.below(static_cast<uint32_t>(size * size / 2)));
+    for (int m = 0; m < moves && board.emptyCount() > 0; ++m) {
+        int p = board.emptyPoint(static_cast<int>(rng.below(static_cast<uint32_t>(board.emptyCount()))));
+        if (!board.isSimpleEye(p, board.toPlay()) && board.isLegal(p, board.toPlay())) board.play(p, board.toPlay());
+    }
+    return board;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s --weights FILE [--size N] [--batch B] [--evals N] [--precision auto|int16|float]\n"
+                     "       %s --random FILE [--channels C] [--blocks B] [--hidden H] [--seed S]\n", argv[0], argv[0]);
+        return 2;
+    }
+    if (!options.randomOutput.empty()) {
+        if (!writeRandomNetwork(options)) {
+            std::fprintf(stderr, "cannot write %s\n", options.randomOutput.c_str());
+            return 1;
+        }
+        return 0;
+    }
+
+    GoNetwork network;
+    std::string error;
+    if (!network.load(options.weights, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    FastRng rng(options.seed);
+    std::vector<GoBoard> boards;
+    for (int i = 0; i < options.batch; ++i) {
+        boards.push_back(randomPosition(options.size, rng));
+    }
+    std::vector<GoNetwork::Input> inputs;
+    for (const auto& board : boards) {
+        inputs.push_back(GoNetwork::inputFromBoard(board));
+    }
+    std::vector<GoNetwork::Output> outputs(options.batch), reference(options.batch);
+
+    // 两条路径的最大差异
+    network.setPrecision(GoNetwork::Precision::Float32);
+    network.evaluate(inputs.data(), reference.data(), options.batch);
+    network.setPrecision(GoNetwork::Precision::Int16);
+    network.evaluate(inputs.data(), outputs.data(), options.batch);
+    double valueDiff = 0.0, policyDiff = 0.0;
+    for (int i = 0; i < options.batch; ++i) {
+        valueDiff = std::max(valueDiff, static_cast<double>(std::fabs(outputs[i].value - reference[i].value)));
+        policyDiff = std::max(policyDiff, static_cast<double>(std::fabs(outputs[i].pass - reference[i].pass)));
+        for (int p = 0; p < GoBoard::MAX_POINTS; ++p) {
+            policyDiff = std::max(policyDiff, static_cast<double>(std::fabs(outputs[i].policy[p] - reference[i].policy[p])));
+        }
+    }
+
+    network.setPrecision(options.precision);
+    const char* path = network.precision() == GoNetwork::Precision::Int16
+                       ? (GoNetwork::hasAvx2() ? "int16 avx2" : "int16 scalar") : "float32";
+    auto start = std::chrono::steady_clock::now();
+    int rounds = (options.evals + options.batch - 1) / options.batch;
+    for (int r = 0; r < rounds; ++r) {
+        network.evaluate(inputs.data(), outputs.data(), options.batch);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("network %dx%d blocks, %s path, %dx%d board, batch %d\n", network.channels(), network.blocks(), path,
+                options.size, options.size, options.batch);
+    std::printf("evals/s: %.1f   ms/eval: %.3f\n", rounds * options.batch / seconds,
+                1000.0 * seconds / (rounds * options.batch));
+    std::printf("int16 vs float32 max diff: value %.4f  policy %.5f\n", valueDiff, policyDiff);
+    return 0;
+}
@@ -0,0 +1,441 @@
+// GoPerft.cpp
+// 随机对局一致性与吞吐量测试（围棋版perft）
+// 用固定种子生成随机合法对局，分别在ChessLogic和GoBoard上重放，
+// 每一步比较棋盘、提子数、劫和终局数子，并报告各实现的每秒着数。
+// 每局终局再用摆子接口把终局局面一次摆到新棋盘上，与下出来的局面比较；开始前先检查2到9子的让子摆法。
+//
+// 用法: GoPerft [--games N] [--seed S] [--max-moves M] [--check-legal] [--quiet]
+//              [--stats json|prometheus]
+// --stats 在结束时导出规则层统计（需以 CHESS_RULES_STATS 编译）
+
+#include "ChessLogic.h"
+#include "GoBoard.h"
+#include "RulesStats.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int BOARD_SIZE = 19;
+
+struct Options {
+    long long games = 1000;
+    uint64_t seed = 1;
+    int maxMoves = 3 * BOARD_SIZE * BOARD_SIZE;
+    bool checkLegal = false;
+    bool quiet = false;
+    std::string stats; // 空、"json"或"prometheus"
+};
+
+std::string moveToString(const GoBoard& board, int move)
+{
+    if (move == GoBoard::PASS_MOVE) return "pass";
+    std::string text(1, static_cast<char>('A' + board.colOf(move)));
+    return text + std::to_string(BOARD_SIZE - board.rowOf(move));
+}
+
+std::string gameToString(const GoBoard& board, const std::vector<int>& moves, size_t upTo)
+{
+    std::string text;
+    for (size_t i = 0; i < moves.size() && i <= upTo; ++i) {
+        if (i > 0) text += ' ';
+        text += moveToString(board, moves[i]);
+    }
+    return text;
+}
+
+// 生成一局随机对局：在合法且不填己方眼的点中均匀选点，无点可下则虚着
+std::vector<int> generateGame(std::mt19937_64& rng, int maxMoves)
+{
+    GoBoard board(BOARD_SIZE);
+    board.setRecording(false);
+
+    std::vector<int> moves;
+    BoardBitset candidates;
+    int passes = 0;
+    while (passes < 2 && static_cast<int>(moves.size()) < maxMoves) {
+        PieceColor color = board.toPlay();
+        board.legalMoves(color, candidates, true);
+
+        int move = GoBoard::PASS_MOVE;
+        int count = candidates.count();
+        if (count > 0) {
+            int index = candidates.nth(static_cast<int>(rng() % static_cast<uint64_t>(count)));
+            move = board.point(index / BOARD_SIZE, index % BOARD_SIZE);
+            passes = 0;
+        } else {
+            passes++;
+        }
+        board.play(move, color);
+        moves.push_back(move);
+    }
+    return moves;
+}
+
+// 终局连续两次虚着时ChessLogic会进入终局并标记死子，重放时不发送最后一次虚着
+bool isFinalPass(const std::vector<int>& moves, size_t i)
+{
+    return i + 1 == moves.size() && i > 0 &&
+           moves[i] == GoBoard::PASS_MOVE && moves[i - 1] == GoBoard::PASS_MOVE;
+}
+
+void replayChessLogic(ChessLogic& logic, const GoBoard& board, const std::vector<int>& moves)
+{
+    logic.setGameMode(GameMode::Go);
+    for (size_t i = 0; i < moves.size(); ++i) {
+        if (moves[i] == GoBoard::PASS_MOVE) {
+            if (!isFinalPass(moves, i)) logic.pass();
+        } else {
+            logic.handleClick(board.rowOf(moves[i]), board.colOf(moves[i]));
+        }
+    }
+}
+
+void replayGoBoard(GoBoard& board, const std::vector<int>& moves)
+{
+    board.reset();
+    for (int move : moves) {
+        board.play(move, board.toPlay());
+    }
+}
+
+// 逐步比较两个实现，返回空字符串表示一致
+// 整盘合法着点集合与逐点判断比较，包括去眼和全局同形两个选项
+std::string compareLegalSets(const ChessLogic& logic, const GoBoard& board)
+{
+    PieceColor color = board.toPlay();
+    BoardBitset plain, noEyes, superko;
+    board.legalMoves(color, plain);
+    board.legalMoves(color, noEyes, true);
+    board.legalMoves(color, superko, false, true);
+    if (logic.legalMoves() != plain) return "ChessLogic::legalMoves differs from GoBoard";
+
+    // 全局同形的对照：撤回整局收集历史局面，再逐点试下
+    GoBoard scratch = board;
+    std::vector<uint64_t> history(1, scratch.hash());
+    while (scratch.canUndo()) {
+        scratch.undo();
+        history.push_back(scratch.hash());
+    }
+    scratch = board;
+
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            int p = board.point(row, col);
+            int index = row * BOARD_SIZE + col;
+            bool legal = board.isLegal(p, color);
+            if (plain.test(index) != legal) return "legal set differs at " + moveToString(board, p);
+            if (noEyes.test(index) != (legal && !board.isSimpleEye(p, color))) {
+                return "eye-filtered legal set differs at " + moveToString(board, p);
+            }
+            bool repeats = false;
+            if (legal) {
+                scratch.play(p, color);
+                repeats = std::find(history.begin(), history.end(), scratch.hash()) != history.end();
+                scratch.undo();
+            }
+            if (superko.test(index) != (legal && !repeats)) {
+                return "superko legal set differs at " + moveToString(board, p);
+            }
+        }
+    }
+    return std::string();
+}
+
+std::string compareStep(ChessLogic& logic, const GoBoard& board, bool checkLegal)
+{
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            if (logic.getPieceAt(row, col) != board.at(row, col)) {
+                return "board differs at " + moveToString(board, board.point(row, col));
+            }
+        }
+    }
+
+    if (logic.getCapturedBlack() != board.capturedBlack() ||
+        logic.getCapturedWhite() != board.capturedWhite()) {
+        return "captures differ: ChessLogic " + std::to_string(logic.getCapturedBlack()) + "/" +
+               std::to_string(logic.getCapturedWhite()) + ", GoBoard " +
+               std::to_string(board.capturedBlack()) + "/" + std::to_string(board.capturedWhite());
+    }
+
+    if (logic.getCurrentPlayer() != board.toPlay()) {
+        return "side to move differs";
+    }
+
+    // ChessLogic的劫只对被提子一方生效
+    KoPoint ko = logic.getCurrentKo();
+    int logicKo = (ko.row >= 0 && ko.koColor == logic.getCurrentPlayer()) ?
+                  board.point(ko.row, ko.col) : GoBoard::NO_POINT;
+    if (logicKo != board.koPoint()) {
+        return "ko differs: ChessLogic " +
+               (logicKo == GoBoard::NO_POINT ? std::string("none") : moveToString(board, logicKo)) +
+               ", GoBoard " +
+               (board.koPoint() == GoBoard::NO_POINT ? std::string("none") : moveToString(board, board.koPoint()));
+    }
+
+    if (checkLegal) {
+        for (int row = 0; row < BOARD_SIZE; ++row) {
+            for (int col = 0; col < BOARD_SIZE; ++col) {
+                int p = board.point(row, col);
+                if (logic.isValidMove(row, col) != board.isLegal(p, board.toPlay())) {
+                    return "legality differs at " + moveToString(board, p);
+                }
+            }
+        }
+        return compareLegalSets(logic, board);
+    }
+    return std::string();
+}
+
+std::string compareScore(ChessLogic& logic, const GoBoard& board)
+{
+    logic.calculateScore();
+
+    int black = 0, white = 0;
+    board.areaScore(black, white);
+    double expectedBlack = black + board.capturedWhite();
+    double expectedWhite = white + board.capturedBlack() + logic.getGameSettings().komi;
+
+    if (logic.getBlackScore() != expectedBlack || logic.getWhiteScore() != expectedWhite) {
+        return "score differs: ChessLogic " + std::to_string(logic.getBlackScore()) + "/" +
+               std::to_string(logic.getWhiteScore()) + ", GoBoard " +
+               std::to_string(expectedBlack) + "/" + std::to_string(expectedWhite);
+    }
+    return std::string();
+}
+
+// 把played的棋子一次摆到新的GoBoard和ChessLogic上，棋块、气、图案码、哈希和合法着点应与下出来的一致
+std::string compareSetup(const GoBoard& played)
+{
+    std::vector<int> black, white;
+    std::vector<ChessPiece> stones;
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            PieceColor color = played.at(row, col);
+            if (color == PieceColor::Empty) continue;
+            (color == PieceColor::Black ? black : white).push_back(played.point(row, col));
+            stones.push_back(ChessPiece(row, col, color));
+        }
+    }
+
+    GoBoard board(BOARD_SIZE);
+    if (!board.setup(black, white, played.toPlay())) return "GoBoard::setup rejected the final position";
+    if (board.hash() != played.hash()) return "setup hash differs";
+    for (int row = 0; row < BOARD_SIZE; ++row) {
+        for (int col = 0; col < BOARD_SIZE; ++col) {
+            int p = board.point(row, col);
+            if (board.pattern3(p) != played.pattern3(p)) return "setup pattern differs at " + moveToString(board, p);
+            if (board.at(p) == PieceColor::Empty) continue;
+            if (board.groupSize(p) != played.groupSize(p) || board.isInAtari(p) != played.isInAtari(p) ||
+                board.libertyCount(p) != played.libertyCount(p)) {
+                return "setup group differs at " + moveToString(board, p);
+            }
+        }
+    }
+    // 摆出来的局面没有劫
+    if (played.koPoint() == GoBoard::NO_POINT) {
+        BoardBitset expected, actual;
+        played.legalMoves(played.toPlay(), expected);
+        board.legalMoves(board.toPlay(), actual);
+        if (expected != actual) return "setup legal set differs";
+    }
+
+    ChessLogic logic;
+    logic.setGameMode(GameMode::Go);
+    if (!logic.setupStones(stones, played.toPlay())) return "ChessLogic::setupStones rejected the final position";
+    return compareStep(logic, board, false);
+}
+
+// 让子：2到9子各摆一次，与按星位表摆出的GoBoard比较，白棋再下一手后再比一次；1子、10子和开局后的让子应被拒绝
+std::string checkHandicap()
+{
+    const int low = 3, mid = BOARD_SIZE / 2, high = BOARD_SIZE - 4;
+    const int stars[][2] = {{high, low}, {low, high}, {low, low}, {high, high}, {mid, low},
+                            {mid, high}, {high, mid}, {low, mid}, {mid, mid}};
+    // 每种子数用星位表里的哪几个点（下标）
+    const std::vector<std::vector<int>> layouts = {
+        {0, 1}, {0, 1, 2}, {0, 1, 2, 3}, {0, 1, 2, 3, 8}, {0, 1, 2, 3, 4, 5},
+        {0, 1, 2, 3, 4, 5, 8}, {0, 1, 2, 3, 4, 5, 6, 7}, {0, 1, 2, 3, 4, 5, 6, 7, 8}};
+    for (const std::vector<int>& layout : layouts) {
+        int stones = static_cast<int>(layout.size());
+        GoBoard board(BOARD_SIZE);
+        std::vector<int> black;
+        for (int i : layout) {
+            black.push_back(board.point(stars[i][0], stars[i][1]));
+        }
+        board.setup(black, {}, PieceColor::White);
+
+        ChessLogic logic;
+        logic.setGameMode(GameMode::Go);
+        if (!logic.placeHandicap(stones)) return "placeHandicap rejected " + std::to_string(stones) + " stones";
+        std::string error = compareStep(logic, board, true);
+        if (error.empty()) {
+            logic.handleClick(mid - 1, mid);
+            board.play(board.point(mid - 1, mid), PieceColor::White);
+            error = compareStep(logic, board, true);
+        }
+        if (!error.empty()) return "handicap " + std::to_string(stones) + ": " + error;
+        if (logic.placeHandicap(2)) return "placeHandicap accepted after a move";
+    }
+    for (int stones : {0, 1, 10}) {
+        ChessLogic logic;
+        logic.setGameMode(GameMode::Go);
+        if (logic.placeHandicap(stones)) return "placeHandicap accepted " + std::to_string(stones) + " stones";
+    }
+    return std::string();
+}
+
+// 两个实现同步重放并逐步比较，发现不一致时打印复现信息
+bool checkGame(long long gameIndex, const std::vector<int>& moves, bool checkLegal)
+{
+    ChessLogic logic;
+    logic.setGameMode(GameMode::Go);
+    GoBoard board(BOARD_SIZE);
+
+    for (size_t i = 0; i < moves.size(); ++i) {
+        int move = moves[i];
+        if (move == GoBoard::PASS_MOVE) {
+            if (!isFinalPass(moves, i)) logic.pass();
+        } else {
+            logic.handleClick(board.rowOf(move), board.colOf(move));
+        }
+        board.play(move, board.toPlay());
+
+        // 最后一次虚着没有发给ChessLogic，只比较数子
+        std::string error = isFinalPass(moves, i) ? std::string() : compareStep(logic, board, checkLegal);
+        if (error.empty() && i + 1 == moves.size()) {
+            error = compareScore(logic, board);
+            if (error.empty()) error = compareSetup(board);
+        }
+        if (!error.empty()) {
+            std::fprintf(stderr, "game %lld, move %zu (%s): %s\n", gameIndex, i + 1,
+                         moveToString(board, move).c_str(), error.c_str());
+            std::fprintf(stderr, "moves: %s\n", gameToString(board, moves, i).c_str());
+            std::fprintf(stderr, "%s", board.toString().c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--games") && i + 1 < argc) {
+            options.games = std::atoll(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--max-moves") && i + 1 < argc) {
+            options.maxMoves = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--check-legal")) {
+            options.checkLegal = true;
+        } else if (!std::strcmp(argv[i], "--quiet")) {
+            options.quiet = true;
+        } else if (!std::strcmp(argv[i], "--stats") && i + 1 < argc &&
+                   (!std::strcmp(argv[i + 1], "json") || !std::strcmp(argv[i + 1], "prometheus"))) {
+            options.stats = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--games N] [--seed S] [--max-moves M] [--check-legal] [--quiet]"
+                         " [--stats json|prometheus]\n", argv[0]);
+            return false;
+        }
+    }
+    if (!options.stats.empty() && !RulesStats::enabled()) {
+        std::fprintf(stderr, "warning: built without CHESS_RULES_STATS, statistics will be empty\n");
+    }
+    return true;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+
+    std::mt19937_64 rng(options.seed);
+    GoBoard timingBoard(BOARD_SIZE);
+    ChessLogic timingLogic;
+
+    long long totalMoves = 0;
+    double logicSeconds = 0.0;
+    double boardSeconds = 0.0;
+    double setSeconds = 0.0;
+    double loopSeconds = 0.0;
+    long long legalChecksum = 0;
+
+    std::string handicapError = checkHandicap();
+    if (!handicapError.empty()) {
+        std::fprintf(stderr, "%s\nFAILED\n", handicapError.c_str());
+        return 1;
+    }
+
+    for (long long game = 0; game < options.games; ++game) {
+        std::vector<int> moves = generateGame(rng, options.maxMoves);
+        totalMoves += static_cast<long long>(moves.size());
+
+        // 吞吐量：各实现单独重放，不含比较开销
+        auto start = std::chrono::steady_clock::now();
+        replayChessLogic(timingLogic, timingBoard, moves);
+        logicSeconds += secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        replayGoBoard(timingBoard, moves);
+        boardSeconds += secondsSince(start);
+
+        // 整盘合法着点：一次求集合 vs 逐点调isLegal
+        timingBoard.reset();
+        BoardBitset legal;
+        for (int move : moves) {
+            PieceColor color = timingBoard.toPlay();
+            start = std::chrono::steady_clock::now();
+            timingBoard.legalMoves(color, legal);
+            setSeconds += secondsSince(start);
+            legalChecksum += legal.count();
+
+            start = std::chrono::steady_clock::now();
+            for (int row = 0; row < BOARD_SIZE; ++row) {
+                for (int col = 0; col < BOARD_SIZE; ++col) {
+                    legalChecksum -= timingBoard.isLegal(timingBoard.point(row, col), color);
+                }
+            }
+            loopSeconds += secondsSince(start);
+            timingBoard.play(move, color);
+        }
+
+        if (!checkGame(game, moves, options.checkLegal)) {
+            std::fprintf(stderr, "FAILED (seed %llu)\n", static_cast<unsigned long long>(options.seed));
+            return 1;
+        }
+
+        if (!options.quiet && (game + 1) % 1000 == 0) {
+            std::printf("%lld games checked\n", game + 1);
+        }
+    }
+
+    std::printf("%lld games, %lld moves, all consistent\n", options.games, totalMoves);
+    std::printf("ChessLogic: %.0f moves/s\n", logicSeconds > 0 ? totalMoves / logicSeconds : 0.0);
+    std::printf("GoBoard:    %.0f moves/s\n", boardSeconds > 0 ? totalMoves / boardSeconds : 0.0);
+    std::printf("legal-move sets/s: bitset %.0f, per-point loop %.0f (checksum %lld)\n",
+                setSeconds > 0 ? totalMoves / setSeconds : 0.0, loopSeconds > 0 ? totalMoves / loopSeconds : 0.0,
+                legalChecksum);
+
+    if (options.stats == "json") {
+        std::printf("%s\n", RulesStats::toJson().c_str());
+    } else if (options.stats == "prometheus") {
+        std::printf("%s", RulesStats::toPrometheus().c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+// GomokuBench.cpp
+// 五子棋增量评估测试：随机对局中逐手把增量维护的棋形与从头重算的结果比较，
+// 再比较"落子+评估+撤销"与每次从头重算的速度
+//
+// 用法: GomokuBench [--size N] [--games N] [--seed S]
+
+#include "FastRng.h"
+#include "GomokuEval.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int size = 15;
+    int games = 200;
+    uint64_t seed = 1;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            options.size = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--games") && i + 1 < argc) {
+            options.games = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr, "usage: %s [--size N] [--games N] [--seed S]\n", argv[0]);
+            return false;
+        }
+    }
+    if (options.size < 5 || options.size > GomokuBoard::MAX_SIZE || options.games < 1) {
+        std::fprintf(stderr, "invalid board size or game count\n");
+        return false;
+    }
+    return true;
+}
+
+const PieceColor COLORS[2] = {PieceColor::Black, PieceColor::White};
+const GomokuEval::Shape SHAPES[] = {
+    GomokuEval::OpenTwo, GomokuEval::Three, GomokuEval::OpenThree,
+    GomokuEval::Four, GomokuEval::OpenFour, GomokuEval::Five
+};
+
+bool sameState(const GomokuEval& a, const GomokuEval& b)
+{
+    const GomokuBoard& board = a.board();
+    for (PieceColor color : COLORS) {
+        for (GomokuEval::Shape shape : SHAPES) {
+            if (a.count(color, shape) != b.count(color, shape)) return false;
+        }
+        for (int row = 0; row < board.size(); ++row) {
+            for (int col = 0; col < board.size(); ++col) {
+                int p = board.point(row, col);
+                for (int d = 0; d < 4; ++d) {
+                    if (a.shape(p, d, color) != b.shape(p, d, color)) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<int> emptyPoints(const GomokuBoard& board)
+{
+    std::vector<int> points;
+    for (int row = 0; row < board.size(); ++row) {
+        for (int col = 0; col < board.size(); ++col) {
+            int p = board.point(row, col);
+            if (board.cell(p) == GomokuBoard::Empty) points.push_back(p);
+        }
+    }
+    return points;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+
+    FastRng rng(options.seed);
+    GomokuEval eval(options.size);
+    long long checks = 0;
+    long long incrementalNodes = 0;
+    long long rebuildNodes = 0;
+    double incrementalSeconds = 0.0;
+    double rebuildSeconds = 0.0;
+    long long checksum = 0;
+
+    for (int game = 0; game < options.games; ++game) {
+        eval.reset();
+        int moves = 0;
+        // 随机下到有人成五前一手或棋盘下满，中途按一半概率撤销一手以覆盖撤销路径
+        while (true) {
+            std::vector<int> points = emptyPoints(eval.board());
+            if (points.empty()) break;
+            PieceColor toPlay = COLORS[moves & 1];
+            if (eval.count(toPlay, GomokuEval::Five) > 0) break;
+
+            // 每个局面对所有空点做一次落子+评估+撤销
+            auto begin = std::chrono::steady_clock::now();
+            for (int p : points) {
+                eval.play(p, toPlay);
+                checksum += eval.evaluate(COLORS[(moves + 1) & 1]);
+                eval.undo();
+            }
+            incrementalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            incrementalNodes += static_cast<long long>(points.size());
+
+            // 对照：同样的局面每次落子后从头重算（只抽样少量点以控制耗时）
+            GomokuEval copy = eval;
+            begin = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < points.size(); i += 16) {
+                copy.play(points[i], toPlay);
+                copy.rebuild();
+                checksum -= copy.evaluate(COLORS[(moves + 1) & 1]);
+                copy.undo();
+            }
+            rebuildSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            rebuildNodes += static_cast<long long>((points.size() + 15) / 16);
+
+            eval.play(points[rng.below(static_cast<uint32_t>(points.size()))], toPlay);
+            moves++;
+            if (moves > 1 && rng.below(2) == 0) {
+                eval.undo();
+                moves--;
+            }
+
+            GomokuEval fresh = eval;
+            fresh.rebuild();
+            checks++;
+            if (!sameState(eval, fresh)) {
+                std::fprintf(stderr, "mismatch in game %d after %d moves\n", game, moves);
+                return 1;
+            }
+        }
+    }
+
+    std::printf("%d games on %dx%d, %lld positions checked against full rebuild\n",
+                options.games, options.size, options.size, checks);
+    std::printf("incremental play+eval+undo/s: %.0f\n", incrementalNodes / incrementalSeconds);
+    std::printf("rebuild     play+eval+undo/s: %.0f\n", rebuildNodes / rebuildSeconds);
+    std::printf("speedup: %.1fx   (checksum %lld)\n",
+                (incrementalNodes / incrementalSeconds) / (rebuildNodes / rebuildSeconds), checksum);
+    return 0;
+}
@@ -0,0 +1,133 @@
+// InfluenceBench.cpp
+// 形势估计测试：随机对局（均匀随机走子，含悔棋和试下）中逐手把增量更新的归属与整盘重算比较，
+// 报告每次更新的耗时、平均重算行数，以及终局时估计与数子结果的平均偏差
+//
+// 用法: InfluenceBench [--size N] [--games N] [--seed S] [--komi K]
+
+#include "FastRng.h"
+#include "InfluenceMap.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+struct Options {
+    int size = 19;
+    int games = 200;
+    uint64_t seed = 1;
+    double komi = 7.5;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            options.size = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--games") && i + 1 < argc) {
+            options.games = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--komi") && i + 1 < argc) {
+            options.komi = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--size N] [--games N] [--seed S] [--komi K]\n", argv[0]);
+            return false;
+        }
+    }
+    if (options.size < 2 || options.size > GoBoard::MAX_SIZE || options.games < 1) {
+        std::fprintf(stderr, "invalid board size or game count\n");
+        return false;
+    }
+    return true;
+}
+
+bool sameOwners(const InfluenceMap& a, const InfluenceMap& b)
+{
+    for (int row = 0; row < a.size(); ++row) {
+        for (int col = 0; col < a.size(); ++col) {
+            if (a.owner(row, col) != b.owner(row, col)) return false;
+        }
+    }
+    return a.blackArea() == b.blackArea() && a.whiteArea() == b.whiteArea();
+}
+
+// 在合法且不填己方眼的点中均匀随机选一手，没有时虚着
+int randomMove(const GoBoard& board, FastRng& rng)
+{
+    BoardBitset moves;
+    board.legalMoves(board.toPlay(), moves, true);
+    int count = moves.count();
+    if (count == 0) return GoBoard::PASS_MOVE;
+    int index = moves.nth(static_cast<int>(rng.below(static_cast<uint32_t>(count))));
+    return board.point(index / board.size(), index % board.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+
+    FastRng rng(options.seed);
+    long long updates = 0;
+    double updateSeconds = 0.0;
+    double rebuildSeconds = 0.0;
+    long long totalRows = 0;
+    double finalError = 0.0;
+
+    for (int game = 0; game < options.games; ++game) {
+        GoBoard board(options.size);
+        InfluenceMap incremental(options.size);
+        InfluenceMap fresh(options.size);
+        int passes = 0;
+        int moves = 0;
+        while (passes < 2 && moves < 3 * options.size * options.size) {
+            int move = randomMove(board, rng);
+            board.play(move, board.toPlay());
+            passes = move == GoBoard::PASS_MOVE ? passes + 1 : 0;
+            moves++;
+            // 偶尔悔一手，覆盖提子复原的路径
+            if (moves > 1 && rng.below(8) == 0) {
+                board.undo();
+                moves--;
+                passes = 0;
+            } else if (rng.below(8) == 0) {
+                // 偶尔试下一手再撤销：棋盘仍比上次同步多一手，但提子表可能是试下那一手的
+                board.play(randomMove(board, rng), board.toPlay());
+                board.undo();
+            }
+
+            long long rowsBefore = incremental.rowsComputed();
+            auto begin = std::chrono::steady_clock::now();
+            incremental.update(board);
+            updateSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            begin = std::chrono::steady_clock::now();
+            fresh.rebuild(board);
+            rebuildSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            updates++;
+            totalRows += incremental.rowsComputed() - rowsBefore;
+            if (!sameOwners(incremental, fresh)) {
+                std::fprintf(stderr, "mismatch in game %d after %d moves (%lld rows recomputed)\n%s",
+                             game, moves, incremental.rowsComputed() - rowsBefore, board.toString().c_str());
+                return 1;
+            }
+        }
+
+        // 随机对局下到底时死子基本都被提掉了，估计应当接近数子
+        int black = 0, white = 0;
+        board.areaScore(black, white);
+        finalError += std::fabs(incremental.estimate(options.komi) - (black - white - options.komi));
+    }
+
+    std::printf("%d games on %dx%d, %lld updates checked against full rebuild\n",
+                options.games, options.size, options.size, updates);
+    std::printf("incremental update: %.2f us   full rebuild: %.2f us   rows per update: %.1f\n",
+                1e6 * updateSeconds / updates, 1e6 * rebuildSeconds / updates,
+                static_cast<double>(totalRows) / updates);
+    std::printf("final estimate vs area score: mean abs error %.2f points\n", finalError / options.games);
+    return 0;
+}
@@ -0,0 +1,154 @@
+// LadderBench.cpp
+// 征子读秒测试：先检查一个标准征子和加了引征子后的结果，再在随机对局（均匀随机走子）的每个局面上
+// 对所有一口气、两口气的棋块读秒，与每次清空置换表的读秒结果对拍，并确认棋盘被原样复原
+// 报告每次查询的耗时和节点数
+//
+// 用法: LadderBench [--size N] [--games N] [--seed S]
+
+#include "FastRng.h"
+#include "LadderReader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int size = 19;
+    int games = 100;
+    uint64_t seed = 1;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            options.size = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--games") && i + 1 < argc) {
+            options.games = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr, "usage: %s [--size N] [--games N] [--seed S]\n", argv[0]);
+            return false;
+        }
+    }
+    if (options.size < 5 || options.size > GoBoard::MAX_SIZE || options.games < 1) {
+        std::fprintf(stderr, "invalid board size or game count\n");
+        return false;
+    }
+    return true;
+}
+
+// 天元附近一颗被叫吃的白子向左下方逃，breaker为白方的引征子（行号为负表示没有）
+bool checkLadder(int breakerRow, int breakerCol, bool expectCaptured)
+{
+    GoBoard board(19);
+    board.play(board.point(9, 9), PieceColor::White);
+    board.play(board.point(8, 9), PieceColor::Black);
+    board.play(board.point(9, 8), PieceColor::Black);
+    board.play(board.point(10, 10), PieceColor::Black);
+    board.play(board.point(9, 10), PieceColor::Black);
+    if (breakerRow >= 0) board.play(board.point(breakerRow, breakerCol), PieceColor::White);
+
+    LadderReader reader;
+    if (reader.isLadderCaptured(board, board.point(9, 9)) != expectCaptured) {
+        std::fprintf(stderr, "ladder with breaker at (%d, %d): expected %s\n%s", breakerRow, breakerCol,
+                     expectCaptured ? "captured" : "escape", board.toString().c_str());
+        return false;
+    }
+    return true;
+}
+
+int randomMove(const GoBoard& board, FastRng& rng)
+{
+    BoardBitset moves;
+    board.legalMoves(board.toPlay(), moves, true);
+    int count = moves.count();
+    if (count == 0) return GoBoard::PASS_MOVE;
+    int index = moves.nth(static_cast<int>(rng.below(static_cast<uint32_t>(count))));
+    return board.point(index / board.size(), index % board.size());
+}
+
+// 一口气的棋块问守方能否逃出，两口气的问攻方能否吃掉
+bool query(LadderReader& reader, GoBoard& board, int target, int libs)
+{
+    return libs == 1 ? !reader.defend(board, target) : reader.attack(board, target);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+
+    if (!checkLadder(-1, -1, true) || !checkLadder(13, 6, false) || !checkLadder(18, 1, true)) return 1;
+
+    FastRng rng(options.seed);
+    LadderReader reader;
+    LadderReader reference;
+    long long queries = 0;
+    long long captured = 0;
+    long long nodes = 0;
+    long long aborted = 0;
+    double seconds = 0.0;
+
+    for (int game = 0; game < options.games; ++game) {
+        GoBoard board(options.size);
+        int passes = 0;
+        int moves = 0;
+        while (passes < 2 && moves < 3 * options.size * options.size) {
+            int move = randomMove(board, rng);
+            board.play(move, board.toPlay());
+            passes = move == GoBoard::PASS_MOVE ? passes + 1 : 0;
+            moves++;
+
+            std::vector<int> targets;
+            std::vector<bool> seen(GoBoard::MAX_POINTS, false);
+            for (int row = 0; row < options.size; ++row) {
+                for (int col = 0; col < options.size; ++col) {
+                    int p = board.point(row, col);
+                    if (board.at(p) == PieceColor::Empty || seen[board.groupOf(p)]) continue;
+                    seen[board.groupOf(p)] = true;
+                    if (board.libertyCount(p, 3) <= 2) targets.push_back(p);
+                }
+            }
+
+            for (int target : targets) {
+                int libs = board.libertyCount(target, 3);
+                uint64_t key = board.positionKey();
+                int last = board.lastMove();
+                auto begin = std::chrono::steady_clock::now();
+                bool result = query(reader, board, target, libs);
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+                queries++;
+                captured += result;
+                nodes += reader.nodes();
+                aborted += reader.aborted();
+
+                if (board.positionKey() != key || board.lastMove() != last) {
+                    std::fprintf(stderr, "board not restored in game %d after %d moves\n", game, moves);
+                    return 1;
+                }
+                // 超限时结果取决于节点怎么数，两边不必一致
+                reference.clear();
+                bool expected = query(reference, board, target, libs);
+                if (!reader.aborted() && !reference.aborted() && expected != result) {
+                    std::fprintf(stderr, "table reuse changed the result in game %d after %d moves, target (%d, %d)\n%s",
+                                 game, moves, board.rowOf(target), board.colOf(target), board.toString().c_str());
+                    return 1;
+                }
+            }
+        }
+    }
+
+    std::printf("ladder checks passed; %d games on %dx%d, %lld queries checked against a cleared table\n",
+                options.games, options.size, options.size, queries);
+    std::printf("%.2f us per query   %.1f nodes per query   %.1f%% captured   %lld aborted   %lld table hits\n",
+                1e6 * seconds / queries, static_cast<double>(nodes) / queries,
+                100.0 * captured / queries, aborted, reader.tableHits());
+    return 0;
+}
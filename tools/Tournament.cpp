@@ -0,0 +1,781 @@
+// Tournament.cpp
+// 引擎对战：两个引擎配置在所有核上并行对弈（围棋或五子棋），每对棋局共用一个开局、交换先后手，
+// 每局结束后更新胜负、Elo估计和SPRT对数似然比，越过界限即提前停止
+// 双方各有一个钟：GameSettings的主时间和读秒乘以--tc-scale（默认30分钟 x 0.002 = 3.6秒，读秒60毫秒 x 3），
+// 每手由TimeManager分配时间，超时判负
+//
+// 用法: Tournament --game go|gomoku --engine1 SPEC --engine2 SPEC [--size N] [--games N] [--threads T]
+//                  [--seed S] [--book FILE] [--random-plies N] [--tc-scale X] [--patterns FILE]
+//                  [--elo0 E] [--elo1 E] [--alpha A] [--beta B] [--hash MB]
+// 引擎配置写成 名字:键=值,键=值
+//   围棋   mcts:policy=uniform|tactical|pattern,iters=N（每手迭代上限，0为只看时间）   random
+//   五子棋 ab:depth=N,width=N,hash=0|1（alpha-beta最大深度、每层候选数、是否用置换表）   random
+//   两种都可加tm=0：每手固定用TimeManager的目标时间，不提前停也不加时（用来对比用时策略）
+//   mcts可加reuse=0：每手重新搜索，不保留上一手搜索树里实际走到的子树
+// 开局库每行一个开局，着手用空格分隔，坐标同界面（列字母A起、行号从下往上），围棋可写pass，#开头为注释
+// 没有开局库时每对棋局先随机下--random-plies手
+// 五子棋每个引擎一张置换表，所有线程的棋局共用；大小取--hash，没给时取GameSettings::hashSizeMb，环境变量CHESS_HASH_MB优先
+
+#include "FastRng.h"
+#include "GoMcts.h"
+#include "GomokuEval.h"
+#include "GomokuRules.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class GameKind { Go, Gomoku };
+
+struct EngineSpec {
+    std::string text;
+    std::string name;
+    PlayoutPolicy policy = PlayoutPolicy::Tactical;
+    int iterations = 0;
+    int depth = 4;
+    int width = 10;
+    bool timeManagement = true;
+    bool reuse = true;
+    bool hash = true;
+};
+
+struct Options {
+    GameKind game = GameKind::Go;
+    int size = 0; // 0表示按棋种取默认（围棋9路、五子棋15路）
+    int games = 1000;
+    int threads = 0;
+    uint64_t seed = 1;
+    std::string book;
+    int randomPlies = 2;
+    double tcScale = 0.002;
+    std::string patterns;
+    EngineSpec engines[2];
+    double elo0 = 0.0;
+    double elo1 = 10.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+    int hashMb = 0; // 0表示用GameSettings里的大小
+};
+
+bool parseEngine(const std::string& text, GameKind game, EngineSpec& spec)
+{
+    spec = EngineSpec();
+    spec.text = text;
+    size_t colon = text.find(':');
+    spec.name = text.substr(0, colon);
+    if (game == GameKind::Go && spec.name != "mcts" && spec.name != "random") return false;
+    if (game == GameKind::Gomoku && spec.name != "ab" && spec.name != "random") return false;
+
+    std::stringstream params(colon == std::string::npos ? "" : text.substr(colon + 1));
+    std::string item;
+    while (std::getline(params, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) return false;
+        std::string key = item.substr(0, eq);
+        std::string value = item.substr(eq + 1);
+        if (key == "policy") {
+            if (value == "uniform") {
+                spec.policy = PlayoutPolicy::Uniform;
+            } else if (value == "tactical") {
+                spec.policy = PlayoutPolicy::Tactical;
+            } else if (value == "pattern") {
+                spec.policy = PlayoutPolicy::Pattern;
+            } else {
+                return false;
+            }
+        } else if (key == "iters") {
+            spec.iterations = std::atoi(value.c_str());
+        } else if (key == "depth") {
+            spec.depth = std::max(1, std::atoi(value.c_str()));
+        } else if (key == "width") {
+            spec.width = std::max(1, std::atoi(value.c_str()));
+        } else if (key == "tm") {
+            spec.timeManagement = std::atoi(value.c_str()) != 0;
+        } else if (key == "reuse") {
+            spec.reuse = std::atoi(value.c_str()) != 0;
+        } else if (key == "hash") {
+            spec.hash = std::atoi(value.c_str()) != 0;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    std::string engineText[2];
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--game") && i + 1 < argc) {
+            ++i;
+            if (!std::strcmp(argv[i], "go")) {
+                options.game = GameKind::Go;
+            } else if (!std::strcmp(argv[i], "gomoku")) {
+                options.game = GameKind::Gomoku;
+            } else {
+                std::fprintf(stderr, "unknown game: %s\n", argv[i]);
+                return false;
+            }
+        } else if (!std::strcmp(argv[i], "--engine1") && i + 1 < argc) {
+            engineText[0] = argv[++i];
+        } else if (!std::strcmp(argv[i], "--engine2") && i + 1 < argc) {
+            engineText[1] = argv[++i];
+        } else if (!std::strcmp(argv[i], "--size") && i + 1 < argc) {
+            options.size = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--games") && i + 1 < argc) {
+            options.games = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--book") && i + 1 < argc) {
+            options.book = argv[++i];
+        } else if (!std::strcmp(argv[i], "--random-plies") && i + 1 < argc) {
+            options.randomPlies = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--tc-scale") && i + 1 < argc) {
+            options.tcScale = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--patterns") && i + 1 < argc) {
+            options.patterns = argv[++i];
+        } else if (!std::strcmp(argv[i], "--elo0") && i + 1 < argc) {
+            options.elo0 = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--elo1") && i + 1 < argc) {
+            options.elo1 = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--alpha") && i + 1 < argc) {
+            options.alpha = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--beta") && i + 1 < argc) {
+            options.beta = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--hash") && i + 1 < argc) {
+            options.hashMb = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s --game go|gomoku --engine1 SPEC --engine2 SPEC [--size N] [--games N]"
+                         " [--threads T] [--seed S] [--book FILE] [--random-plies N] [--tc-scale X]"
+                         " [--patterns FILE] [--elo0 E] [--elo1 E] [--alpha A] [--beta B] [--hash MB]\n",
+                         argv[0]);
+            return false;
+        }
+    }
+
+    if (options.size == 0) options.size = options.game == GameKind::Go ? 9 : 15;
+    int maxSize = options.game == GameKind::Go ? GoBoard::MAX_SIZE : GomokuBoard::MAX_SIZE;
+    if (options.size < 5 || options.size > maxSize || options.games < 1 || options.tcScale <= 0.0) {
+        std::fprintf(stderr, "invalid board size, game count or time scale\n");
+        return false;
+    }
+    if (options.elo1 <= options.elo0 || options.alpha <= 0.0 || options.beta <= 0.0 ||
+        options.alpha + options.beta >= 1.0) {
+        std::fprintf(stderr, "invalid SPRT parameters\n");
+        return false;
+    }
+    for (int e = 0; e < 2; ++e) {
+        if (engineText[e].empty() || !parseEngine(engineText[e], options.game, options.engines[e])) {
+            std::fprintf(stderr, "missing or invalid --engine%d\n", e + 1);
+            return false;
+        }
+    }
+    if (options.threads <= 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+    return true;
+}
+
+// 开局库中的一手：row为-1表示虚着
+struct BookMove {
+    int row;
+    int col;
+};
+
+bool parseCoordinate(const std::string& token, int size, BookMove& move)
+{
+    if (token == "pass") {
+        move = {-1, -1};
+        return true;
+    }
+    if (token.size() < 2) return false;
+    int col = std::toupper(static_cast<unsigned char>(token[0])) - 'A';
+    int number = std::atoi(token.c_str() + 1);
+    if (col < 0 || col >= size || number < 1 || number > size) return false;
+    move = {size - number, col};
+    return true;
+}
+
+bool loadBook(const std::string& path, int size, std::vector<std::vector<BookMove>>& book)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "cannot open book %s\n", path.c_str());
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::stringstream tokens(line);
+        std::string token;
+        std::vector<BookMove> opening;
+        while (tokens >> token && token[0] != '#') {
+            BookMove move;
+            if (!parseCoordinate(token, size, move)) {
+                std::fprintf(stderr, "%s:%d: bad move '%s'\n", path.c_str(), lineNumber, token.c_str());
+                return false;
+            }
+            opening.push_back(move);
+        }
+        if (!opening.empty()) book.push_back(opening);
+    }
+    if (book.empty()) {
+        std::fprintf(stderr, "book %s has no openings\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// 分段搜索时每段之间才看表，按读秒时间留一点余量
+double moveOverhead(const GameSettings& settings, double timeScale)
+{
+    return 0.05 * settings.byoYomiTime * timeScale;
+}
+
+double secondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 围棋引擎：分段调用MCTS，每段后问TimeManager是否该停（另有可选的迭代上限）
+class GoPlayer {
+public:
+    GoPlayer(const EngineSpec& spec, const GoPatterns* patterns, const GameSettings& settings, int size,
+             double timeScale)
+        : m_spec(spec), m_mcts(spec.policy, patterns), m_time(settings, size, timeScale)
+    {
+        m_mcts.setKomi(settings.komi);
+        m_time.setMoveOverhead(moveOverhead(settings, timeScale));
+    }
+
+    TimeManager& clock() { return m_time; }
+
+    int choose(const GoBoard& board, int moveNumber, FastRng& rng)
+    {
+        if (m_spec.name == "random") return randomGoMove(board, rng);
+
+        Clock::time_point start = Clock::now();
+        m_time.startMove(moveNumber);
+        // 自己上一手和对方的应手都在棋盘的撤销记录里，沿着它们保留旧树
+        if (m_spec.reuse) {
+            m_mcts.reusePosition(board);
+        } else {
+            m_mcts.setPosition(board);
+        }
+        int reused = m_mcts.iterations();
+        for (;;) {
+            m_mcts.search(SEARCH_CHUNK, rng);
+            int iterations = m_mcts.iterations() - reused;
+            if (m_spec.iterations > 0 && iterations >= m_spec.iterations) break;
+            double elapsed = secondsSince(start);
+            if (!m_spec.timeManagement) {
+                if (m_time.reachedTarget(elapsed)) break;
+                continue;
+            }
+            m_mcts.candidates(m_top, 2);
+            if (m_top.empty()) break;
+            int second = m_top.size() > 1 ? m_top[1].visits : 0;
+            if (m_time.shouldStop(elapsed, m_top[0].move, m_top[0].visits, second, iterations)) break;
+        }
+        return m_mcts.bestMove();
+    }
+
+    static int randomGoMove(const GoBoard& board, FastRng& rng)
+    {
+        BoardBitset moves;
+        board.legalMoves(board.toPlay(), moves, true);
+        int count = moves.count();
+        if (count == 0) return GoBoard::PASS_MOVE;
+        int index = moves.nth(static_cast<int>(rng.below(static_cast<uint32_t>(count))));
+        return board.point(index / board.size(), index % board.size());
+    }
+
+private:
+    static const int SEARCH_CHUNK = 32; // 每搜这么多次看一下表
+
+    EngineSpec m_spec;
+    GoMcts m_mcts;
+    TimeManager m_time;
+    std::vector<GoMcts::Candidate> m_top;
+};
+
+// 五子棋引擎：迭代加深的alpha-beta，候选点为已有棋子两格以内的空点，按GomokuEval的走法分取前width个
+// 搜到最大时间强行中断；每层搜完问TimeManager是否还来得及搜下一层
+// 有置换表时内部节点先查表：深度够的结果直接截断，表里的最佳着排在最前
+class GomokuPlayer {
+public:
+    GomokuPlayer(const EngineSpec& spec, const GameSettings& settings, int size, double timeScale,
+                 TranspositionTable* table)
+        : m_spec(spec), m_rule(settings.gomokuRule), m_eval(size), m_board(size),
+          m_time(settings, size, timeScale), m_table(table), m_stop(false), m_nodes(0)
+    {
+        m_time.setMoveOverhead(moveOverhead(settings, timeScale));
+    }
+
+    TimeManager& clock() { return m_time; }
+
+    int choose(const std::vector<int>& moves, FastRng& rng)
+    {
+        Clock::time_point start = Clock::now();
+        m_time.startMove(static_cast<int>(moves.size()));
+        m_eval.reset();
+        m_board.reset();
+        for (size_t i = 0; i < moves.size(); ++i) {
+            PieceColor color = i % 2 == 0 ? PieceColor::Black : PieceColor::White;
+            m_eval.play(moves[i], color);
+            m_board.play(moves[i], color);
+        }
+        PieceColor toPlay = moves.size() % 2 == 0 ? PieceColor::Black : PieceColor::White;
+        if (moves.empty()) return m_board.point(m_board.size() / 2, m_board.size() / 2);
+
+        std::vector<int> candidates;
+        generate(toPlay, candidates);
+        if (candidates.empty()) return 0;
+        if (m_spec.name == "random") return candidates[rng.below(static_cast<uint32_t>(candidates.size()))];
+
+        if (m_table) m_table->newSearch();
+        double seconds = m_spec.timeManagement ? m_time.maximum() : m_time.target();
+        m_deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        m_stop = false;
+        int best = candidates[0];
+        for (int depth = 1; depth <= m_spec.depth; ++depth) {
+            // 上一轮的最佳着先搜
+            std::iter_swap(candidates.begin(), std::find(candidates.begin(), candidates.end(), best));
+            int alpha = -INF;
+            int iterationBest = best;
+            for (int p : candidates) {
+                int score = searchMove(p, toPlay, depth, alpha, INF, 0);
+                if (m_stop) break;
+                if (score > alpha) {
+                    alpha = score;
+                    iterationBest = p;
+                }
+            }
+            if (m_stop) break;
+            best = iterationBest;
+            if (alpha >= GomokuEval::WIN_SCORE - 100) break; // 已经找到必胜
+            if (m_spec.timeManagement && !m_time.startNextDepth(secondsSince(start), best)) break;
+        }
+        return best;
+    }
+
+private:
+    static const int INF = 2 * GomokuEval::WIN_SCORE;
+    // 表里的分值只有16位：胜负分按离本节点的步数存在TABLE_WIN附近，其余分值截断到MAX_TABLE_VALUE以内
+    static const int TABLE_WIN = 32000;
+    static const int MAX_WIN_DISTANCE = 500;
+    static const int MAX_TABLE_VALUE = TABLE_WIN - MAX_WIN_DISTANCE - 1;
+    static const uint64_t WHITE_KEY = 0xD1B54A32D192ED03ULL;
+
+    EngineSpec m_spec;
+    GomokuRule m_rule;
+    GomokuEval m_eval;
+    GomokuBoard m_board; // 禁手判断要改动棋盘，和评估里的棋盘分开
+    TimeManager m_time;
+    TranspositionTable* m_table; // 可为空，不归本对象所有
+    Clock::time_point m_deadline;
+    bool m_stop;
+    long long m_nodes;
+
+    static PieceColor opponentOf(PieceColor color)
+    {
+        return color == PieceColor::Black ? PieceColor::White : PieceColor::Black;
+    }
+
+    void generate(PieceColor toPlay, std::vector<int>& out)
+    {
+        out.clear();
+        int size = m_board.size();
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                int p = m_board.point(row, col);
+                if (m_board.cell(p) != GomokuBoard::Empty || !nearStones(row, col)) continue;
+                if (!GomokuRules::isLegal(m_board, p, toPlay, m_rule)) continue;
+                out.push_back(p);
+            }
+        }
+        std::sort(out.begin(), out.end(), [&](int a, int b) {
+            return m_eval.moveScore(a, toPlay) > m_eval.moveScore(b, toPlay);
+        });
+        if (static_cast<int>(out.size()) > m_spec.width) out.resize(m_spec.width);
+    }
+
+    bool nearStones(int row, int col) const
+    {
+        int size = m_board.size();
+        for (int r = std::max(0, row - 2); r <= std::min(size - 1, row + 2); ++r) {
+            for (int c = std::max(0, col - 2); c <= std::min(size - 1, col + 2); ++c) {
+                if (m_board.cell(m_board.point(r, c)) != GomokuBoard::Empty) return true;
+            }
+        }
+        return false;
+    }
+
+    // 走p后的分数（以toPlay计）
+    int searchMove(int p, PieceColor toPlay, int depth, int alpha, int beta, int ply)
+    {
+        m_eval.play(p, toPlay);
+        m_board.play(p, toPlay);
+        int score = GomokuRules::isWin(m_board, p, m_rule) ? GomokuEval::WIN_SCORE - ply
+                                                            : -negamax(opponentOf(toPlay), depth - 1, -beta, -alpha, ply + 1);
+        m_board.undo();
+        m_eval.undo();
+        return score;
+    }
+
+    // 分数换成表里的值；截断过的精确值放宽成界，截断后仍然成立
+    static int toTable(int score, int ply, TranspositionTable::Bound& bound)
+    {
+        if (std::abs(score) >= GomokuEval::WIN_SCORE - MAX_WIN_DISTANCE) {
+            // 叶子上直接给出的WIN_SCORE没有减步数，按离本节点0步存
+            int distance = std::max(0, GomokuEval::WIN_SCORE - std::abs(score) - ply);
+            return score > 0 ? TABLE_WIN - distance : distance - TABLE_WIN;
+        }
+        if (score > MAX_TABLE_VALUE) {
+            if (bound == TranspositionTable::BoundUpper) bound = TranspositionTable::BoundNone;
+            if (bound == TranspositionTable::BoundExact) bound = TranspositionTable::BoundLower;
+            return MAX_TABLE_VALUE;
+        }
+        if (score < -MAX_TABLE_VALUE) {
+            if (bound == TranspositionTable::BoundLower) bound = TranspositionTable::BoundNone;
+            if (bound == TranspositionTable::BoundExact) bound = TranspositionTable::BoundUpper;
+            return -MAX_TABLE_VALUE;
+        }
+        return score;
+    }
+
+    static int fromTable(int value, int ply)
+    {
+        if (value > MAX_TABLE_VALUE) return GomokuEval::WIN_SCORE - (TABLE_WIN - value) - ply;
+        if (value < -MAX_TABLE_VALUE) return -GomokuEval::WIN_SCORE + (TABLE_WIN + value) + ply;
+        return value;
+    }
+
+    int negamax(PieceColor toPlay, int depth, int alpha, int beta, int ply)
+    {
+        if ((++m_nodes & 255) == 0 && Clock::now() >= m_deadline) m_stop = true;
+        if (m_stop) return 0;
+        if (depth == 0) return m_eval.evaluate(toPlay);
+
+        uint64_t key = m_board.hash() ^ (toPlay == PieceColor::White ? WHITE_KEY : 0);
+        int hashMove = 0;
+        TranspositionTable::Entry entry;
+        if (m_table && m_table->probe(key, entry)) {
+            hashMove = entry.move;
+            if (entry.depth >= depth) {
+                int value = fromTable(entry.value, ply);
+                if (entry.bound == TranspositionTable::BoundExact) return value;
+                if (entry.bound == TranspositionTable::BoundLower && value >= beta) return value;
+                if (entry.bound == TranspositionTable::BoundUpper && value <= alpha) return value;
+            }
+        }
+
+        std::vector<int> candidates;
+        generate(toPlay, candidates);
+        if (candidates.empty()) return 0; // 下满和棋
+        auto hashed = std::find(candidates.begin(), candidates.end(), hashMove);
+        if (hashed != candidates.end()) std::rotate(candidates.begin(), hashed, hashed + 1);
+
+        int originalAlpha = alpha;
+        int best = -INF;
+        int bestMove = candidates[0];
+        for (int p : candidates) {
+            int score = searchMove(p, toPlay, depth, alpha, beta, ply);
+            if (m_stop) return 0;
+            if (score > best) {
+                best = score;
+                bestMove = p;
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) break;
+        }
+
+        if (m_table) {
+            TranspositionTable::Entry result;
+            result.move = bestMove;
+            result.depth = depth;
+            result.bound = best >= beta ? TranspositionTable::BoundLower
+                           : best <= originalAlpha ? TranspositionTable::BoundUpper
+                                                   : TranspositionTable::BoundExact;
+            result.value = toTable(best, ply, result.bound);
+            if (result.bound != TranspositionTable::BoundNone) m_table->store(key, result);
+        }
+        return best;
+    }
+};
+
+// 以引擎1计：1胜、0.5和、0负；超时判负时timeLoss为true
+double playGoGame(const Options& options, const GameSettings& settings, const GoPatterns* patterns,
+                  const std::vector<BookMove>* opening, uint64_t openingSeed, bool engine1Black, FastRng& rng,
+                  bool& timeLoss)
+{
+    GoBoard board(options.size);
+    int plies = 0;
+    if (opening) {
+        for (const BookMove& move : *opening) {
+            int p = move.row < 0 ? GoBoard::PASS_MOVE : board.point(move.row, move.col);
+            if (!board.play(p, board.toPlay())) break;
+            plies++;
+        }
+    } else {
+        FastRng openingRng(openingSeed);
+        for (int i = 0; i < options.randomPlies; ++i) {
+            board.play(GoPlayer::randomGoMove(board, openingRng), board.toPlay());
+            plies++;
+        }
+    }
+
+    GoPlayer black(options.engines[engine1Black ? 0 : 1], patterns, settings, options.size, options.tcScale);
+    GoPlayer white(options.engines[engine1Black ? 1 : 0], patterns, settings, options.size, options.tcScale);
+    int passes = 0;
+    int moves = 0;
+    while (passes < 2 && moves < 3 * options.size * options.size) {
+        PieceColor color = board.toPlay();
+        bool engine1Moved = (color == PieceColor::Black) == engine1Black;
+        GoPlayer& player = color == PieceColor::Black ? black : white;
+        Clock::time_point start = Clock::now();
+        int move = player.choose(board, plies + moves, rng);
+        if (!player.clock().finishMove(secondsSince(start))) {
+            timeLoss = true;
+            return engine1Moved ? 0.0 : 1.0;
+        }
+        if (!board.play(move, color)) {
+            // 非法着判负
+            return engine1Moved ? 0.0 : 1.0;
+        }
+        passes = move == GoBoard::PASS_MOVE ? passes + 1 : 0;
+        moves++;
+    }
+
+    int blackArea = 0, whiteArea = 0;
+    board.areaScore(blackArea, whiteArea);
+    double score = blackArea - whiteArea - settings.komi;
+    if (score == 0.0) return 0.5;
+    return (score > 0) == engine1Black ? 1.0 : 0.0;
+}
+
+double playGomokuGame(const Options& options, const GameSettings& settings, TranspositionTable* const tables[2],
+                      const std::vector<BookMove>* opening, uint64_t openingSeed, bool engine1Black, FastRng& rng,
+                      bool& timeLoss)
+{
+    GomokuBoard board(options.size);
+    std::vector<int> moves;
+    auto toPlay = [&]() { return moves.size() % 2 == 0 ? PieceColor::Black : PieceColor::White; };
+
+    if (opening) {
+        for (const BookMove& move : *opening) {
+            if (move.row < 0) break;
+            int p = board.point(move.row, move.col);
+            if (!GomokuRules::isLegal(board, p, toPlay(), settings.gomokuRule)) break;
+            board.play(p, toPlay());
+            moves.push_back(p);
+        }
+    } else {
+        // 天元附近5x5内随机摆
+        FastRng openingRng(openingSeed);
+        int centre = options.size / 2;
+        for (int i = 0; i < options.randomPlies; ++i) {
+            int p = board.point(centre - 2 + static_cast<int>(openingRng.below(5)),
+                                centre - 2 + static_cast<int>(openingRng.below(5)));
+            if (board.cell(p) != GomokuBoard::Empty) continue;
+            board.play(p, toPlay());
+            moves.push_back(p);
+        }
+    }
+
+    GomokuPlayer black(options.engines[engine1Black ? 0 : 1], settings, options.size, options.tcScale,
+                       tables[engine1Black ? 0 : 1]);
+    GomokuPlayer white(options.engines[engine1Black ? 1 : 0], settings, options.size, options.tcScale,
+                       tables[engine1Black ? 1 : 0]);
+    while (static_cast<int>(moves.size()) < options.size * options.size) {
+        PieceColor color = toPlay();
+        bool engine1Moved = (color == PieceColor::Black) == engine1Black;
+        GomokuPlayer& player = color == PieceColor::Black ? black : white;
+        Clock::time_point start = Clock::now();
+        int p = player.choose(moves, rng);
+        if (!player.clock().finishMove(secondsSince(start))) {
+            timeLoss = true;
+            return engine1Moved ? 0.0 : 1.0;
+        }
+        if (p == 0 || !board.isOnBoard(p) || !GomokuRules::isLegal(board, p, color, settings.gomokuRule)) {
+            // 无处可下（只剩禁手点）或非法着判负
+            return engine1Moved ? 0.0 : 1.0;
+        }
+        board.play(p, color);
+        moves.push_back(p);
+        if (GomokuRules::isWin(board, p, settings.gomokuRule)) return engine1Moved ? 1.0 : 0.0;
+    }
+    return 0.5;
+}
+
+struct Tally {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    int timeLosses = 0; // 其中超时判负的局数（双方合计）
+
+    int games() const { return wins + draws + losses; }
+};
+
+// 胜、和、负的频率，各加半局胜负作先验：全胜或全负时方差不为0，SPRT也能停下来
+void frequencies(const Tally& tally, double& w, double& d, double& n)
+{
+    n = tally.games() + 1.0;
+    w = (tally.wins + 0.5) / n;
+    d = tally.draws / n;
+}
+
+// 正态近似的三项式SPRT：以每局得分的样本均值和方差计算H1（elo1）对H0（elo0）的对数似然比
+double sprtLlr(const Tally& tally, double elo0, double elo1)
+{
+    double w, d, n;
+    frequencies(tally, w, d, n);
+    double score = w + d / 2;
+    double variance = w + d / 4 - score * score;
+    if (variance <= 0.0) return 0.0;
+    double s0 = 1.0 / (1.0 + std::pow(10.0, -elo0 / 400.0));
+    double s1 = 1.0 / (1.0 + std::pow(10.0, -elo1 / 400.0));
+    return n * (s1 - s0) * (2 * score - s0 - s1) / (2 * variance);
+}
+
+// 引擎1相对引擎2的Elo差和95%误差范围
+void eloEstimate(const Tally& tally, double& elo, double& margin)
+{
+    double w, d, n;
+    frequencies(tally, w, d, n);
+    double score = w + d / 2;
+    double deviation = std::sqrt(std::max(0.0, w + d / 4 - score * score) / n);
+    elo = -400.0 * std::log10(1.0 / score - 1.0);
+    margin = 1.96 * deviation * 400.0 / (std::log(10.0) * score * (1.0 - score));
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+
+    std::vector<std::vector<BookMove>> book;
+    if (!options.book.empty() && !loadBook(options.book, options.size, book)) return 2;
+
+    GoPatterns patterns;
+    if (!options.patterns.empty()) {
+        std::string error;
+        if (!patterns.loadFile(options.patterns, &error)) {
+            std::fprintf(stderr, "cannot load patterns: %s\n", error.c_str());
+            return 2;
+        }
+    }
+    const GoPatterns* patternTable = options.patterns.empty() ? nullptr : &patterns;
+
+    GameSettings settings;
+    if (options.hashMb > 0) settings.hashSizeMb = options.hashMb;
+    // 两个引擎各一张表，免得一方读到另一方的搜索结果
+    std::unique_ptr<TranspositionTable> tableStorage[2];
+    TranspositionTable* tables[2] = {nullptr, nullptr};
+    for (int e = 0; e < 2; ++e) {
+        if (options.game != GameKind::Gomoku || options.engines[e].name != "ab" || !options.engines[e].hash) continue;
+        size_t megabytes = TranspositionTable::sizeFromEnvironment(settings.hashSizeMb);
+        tableStorage[e].reset(new TranspositionTable(megabytes));
+        if (tableStorage[e]->sizeInBytes() == 0) {
+            std::fprintf(stderr, "cannot allocate a %zu MB hash table\n", megabytes);
+            return 2;
+        }
+        tables[e] = tableStorage[e].get();
+        std::printf("engine%d hash: %zu MB%s\n", e + 1, tables[e]->sizeInBytes() >> 20,
+                    tables[e]->usesHugePages() ? " on huge pages" : "");
+    }
+    double lower = std::log(options.beta / (1.0 - options.alpha));
+    double upper = std::log((1.0 - options.beta) / options.alpha);
+    std::printf("%s %dx%d: %s vs %s, %d threads, %.2f s + %d x %.0f ms byo-yomi, SPRT elo0=%.1f elo1=%.1f"
+                " bounds [%.2f, %.2f]\n",
+                options.game == GameKind::Go ? "go" : "gomoku", options.size, options.size,
+                options.engines[0].text.c_str(), options.engines[1].text.c_str(), options.threads,
+                settings.mainTime * options.tcScale, settings.byoYomiPeriods,
+                1000.0 * settings.byoYomiTime * options.tcScale, options.elo0, options.elo1, lower, upper);
+
+    std::atomic<int> nextGame{0};
+    std::atomic<bool> stop{false};
+    std::mutex mutex;
+    Tally tally;
+    double llr = 0.0;
+    auto begin = Clock::now();
+
+    auto worker = [&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            int game = nextGame.fetch_add(1);
+            if (game >= options.games) break;
+
+            // 一对棋局共用一个开局，偶数局引擎1执黑
+            int pair = game / 2;
+            bool engine1Black = game % 2 == 0;
+            FastRng pairRng(options.seed * 0x9E3779B97F4A7C15ULL + pair);
+            const std::vector<BookMove>* opening =
+                book.empty() ? nullptr : &book[pairRng.below(static_cast<uint32_t>(book.size()))];
+            uint64_t openingSeed = pairRng.next();
+            FastRng rng(options.seed ^ (0xD1B54A32D192ED03ULL * (game + 1)));
+
+            bool timeLoss = false;
+            double result = options.game == GameKind::Go
+                                ? playGoGame(options, settings, patternTable, opening, openingSeed, engine1Black, rng,
+                                             timeLoss)
+                                : playGomokuGame(options, settings, tables, opening, openingSeed, engine1Black, rng,
+                                                 timeLoss);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (timeLoss) tally.timeLosses++;
+            if (result == 1.0) {
+                tally.wins++;
+            } else if (result == 0.0) {
+                tally.losses++;
+            } else {
+                tally.draws++;
+            }
+            llr = sprtLlr(tally, options.elo0, options.elo1);
+            double elo = 0.0, margin = 0.0;
+            eloEstimate(tally, elo, margin);
+            std::printf("game %d: +%d =%d -%d  elo %+.1f +- %.1f  LLR %.2f\n", tally.games(), tally.wins,
+                        tally.draws, tally.losses, elo, margin, llr);
+            std::fflush(stdout);
+            if (llr <= lower || llr >= upper) stop.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; ++t) {
+        threads.emplace_back(worker);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    double elo = 0.0, margin = 0.0;
+    eloEstimate(tally, elo, margin);
+    const char* verdict = llr >= upper ? "H1 accepted (engine1 stronger)"
+                          : llr <= lower ? "H0 accepted (no gain)"
+                                         : "inconclusive";
+    std::printf("finished %d games in %.1f s: +%d =%d -%d (%d on time)  elo %+.1f +- %.1f  LLR %.2f  %s\n",
+                tally.games(), seconds, tally.wins, tally.draws, tally.losses, tally.timeLosses, elo, margin, llr,
+                verdict);
+    return 0;
+}
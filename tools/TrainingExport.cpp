@@ -0,0 +1,151 @@
+// TrainingExport.cpp
+// 训练数据导出：把SGF或二进制棋谱在所有核上重放，写成定长记录的分片文件（见TrainingExporter.h）
+// --pack时不导出样本，而是把输入的棋谱合并成一个二进制棋谱，以后每晚重导时省掉SGF解析
+//
+// 用法: TrainingExport [--output PREFIX] [--threads T] [--shard-records N] [--symmetry none|random|all]
+//                      [--seed S] [--queued-games N] [--queued-batches N] [--pack FILE] 输入文件...
+
+#include "GameArchive.h"
+#include "TrainingExporter.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    TrainingExporter::Options exporter;
+    std::string pack;
+    std::vector<std::string> inputs;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--output") && i + 1 < argc) {
+            options.exporter.outputPrefix = argv[++i];
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            options.exporter.threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--shard-records") && i + 1 < argc) {
+            options.exporter.recordsPerShard = std::atoll(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--symmetry") && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "none") {
+                options.exporter.symmetry = TrainingExporter::Symmetry::None;
+            } else if (mode == "random") {
+                options.exporter.symmetry = TrainingExporter::Symmetry::Random;
+            } else if (mode == "all") {
+                options.exporter.symmetry = TrainingExporter::Symmetry::All;
+            } else {
+                std::fprintf(stderr, "unknown symmetry mode: %s\n", mode.c_str());
+                return false;
+            }
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.exporter.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--queued-games") && i + 1 < argc) {
+            options.exporter.queuedGames = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--queued-batches") && i + 1 < argc) {
+            options.exporter.queuedBatches = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--pack") && i + 1 < argc) {
+            options.pack = argv[++i];
+        } else if (argv[i][0] == '-') {
+            std::fprintf(stderr,
+                         "usage: %s [--output PREFIX] [--threads T] [--shard-records N] [--symmetry none|random|all]\n"
+                         "          [--seed S] [--queued-games N] [--queued-batches N] [--pack FILE] inputs...\n",
+                         argv[0]);
+            return false;
+        } else {
+            options.inputs.push_back(argv[i]);
+        }
+    }
+    if (options.inputs.empty()) {
+        std::fprintf(stderr, "no input files\n");
+        return false;
+    }
+    if (options.exporter.recordsPerShard < 1) {
+        std::fprintf(stderr, "invalid shard size\n");
+        return false;
+    }
+    return true;
+}
+
+// 逐个读入输入文件，整盘写进一个二进制棋谱
+int pack(const Options& options)
+{
+    FILE* out = std::fopen(options.pack.c_str(), "wb");
+    if (!out || !GameArchive::writeHeader(out)) {
+        std::fprintf(stderr, "cannot write %s\n", options.pack.c_str());
+        if (out) std::fclose(out);
+        return 1;
+    }
+    long long games = 0;
+    long long badFiles = 0;
+    bool ok = true;
+    for (size_t i = 0; i < options.inputs.size() && ok; ++i) {
+        const std::string& path = options.inputs[i];
+        std::vector<GameRecord> records;
+        std::string error;
+        if (GameArchive::isBinary(path)) {
+            FILE* file = std::fopen(path.c_str(), "rb");
+            GameRecord record;
+            bool header = file && GameArchive::readHeader(file);
+            while (header && GameArchive::readGame(file, record, &error)) {
+                records.push_back(record);
+            }
+            if (!header) error = "bad archive header";
+            if (file) std::fclose(file);
+        } else {
+            std::ifstream file(path, std::ios::binary);
+            std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (!file.is_open()) {
+                error = "cannot open";
+            } else {
+                GameArchive::parseSgf(text, records, &error);
+            }
+        }
+        if (!error.empty()) {
+            std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+            badFiles++;
+        }
+        for (const GameRecord& record : records) {
+            if (!(ok = GameArchive::writeGame(out, record))) break;
+            games++;
+        }
+    }
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok) {
+        std::fprintf(stderr, "write failed: %s\n", options.pack.c_str());
+        return 1;
+    }
+    std::printf("packed %lld games from %zu files into %s (%lld files had errors)\n", games, options.inputs.size(),
+                options.pack.c_str(), badFiles);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+    if (!options.pack.empty()) return pack(options);
+
+    TrainingExporter exporter(options.exporter);
+    std::string error;
+    bool ok = exporter.run(options.inputs, &error);
+    const TrainingExporter::Stats& stats = exporter.stats();
+    std::printf("%lld files (%lld bad), %lld games (%lld skipped), %lld positions\n", stats.files, stats.badFiles,
+                stats.games, stats.skippedGames, stats.positions);
+    std::printf("%lld records of %zu bytes in %d shards, %.2f s, %.0f records/s\n", stats.records,
+                sizeof(TrainingRecord), stats.shards, stats.seconds,
+                stats.seconds > 0 ? stats.records / stats.seconds : 0.0);
+    if (!ok) {
+        std::fprintf(stderr, "export failed: %s\n", error.c_str());
+        return 1;
+    }
+    return 0;
+}
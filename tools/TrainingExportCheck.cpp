@@ -0,0 +1,417 @@
+// TrainingExportCheck.cpp
+// 训练数据导出的一致性检查：生成随机棋谱（9/13/19路，含让子、虚着、中盘胜和几盘非法棋谱），
+// 每个SGF文件两盘，另存一份二进制棋谱；用不同的线程数、队列长度和输入格式导出，检查：
+// 分片文件逐字节相同、不变换的样本按输入顺序与GoBoard重放对得上、八种对称与基准样本一致
+//
+// 用法: TrainingExportCheck [--games N] [--threads T] [--seed S] [--prefix P] [--keep]
+
+#include "FastRng.h"
+#include "GameArchive.h"
+#include "GoBoard.h"
+#include "TrainingExporter.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int games = 600;
+    int threads = 4;
+    uint64_t seed = 1;
+    std::string prefix = "export-check";
+    bool keep = false;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--games") && i + 1 < argc) {
+            options.games = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--prefix") && i + 1 < argc) {
+            options.prefix = argv[++i];
+        } else if (!std::strcmp(argv[i], "--keep")) {
+            options.keep = true;
+        } else {
+            std::fprintf(stderr, "usage: %s [--games N] [--threads T] [--seed S] [--prefix P] [--keep]\n", argv[0]);
+            return false;
+        }
+    }
+    if (options.games < 2 || options.threads < 1) {
+        std::fprintf(stderr, "need at least 2 games and 1 thread\n");
+        return false;
+    }
+    return true;
+}
+
+// 随机对局：每10盘有一盘让子（白先），每50盘有一盘在末尾补一手非法着法
+GameRecord randomGame(int index, FastRng& rng)
+{
+    static const int SIZES[] = {9, 13, 19};
+    GameRecord game;
+    game.size = SIZES[rng.below(3)];
+    game.komi = index % 10 == 0 ? 0.5 : 7.5;
+    GoBoard board(game.size);
+    if (index % 10 == 0) {
+        int low = game.size >= 13 ? 3 : 2;
+        int high = game.size - 1 - low;
+        std::vector<int> black = {board.point(low, low), board.point(high, high)};
+        game.setup.push_back(ChessPiece(low, low, PieceColor::Black));
+        game.setup.push_back(ChessPiece(high, high, PieceColor::Black));
+        board.setup(black, {}, PieceColor::White);
+        game.toPlay = PieceColor::White;
+    }
+
+    int length = static_cast<int>(rng.below(static_cast<uint32_t>(game.size * game.size)));
+    for (int ply = 0; ply < length; ++ply) {
+        PieceColor color = board.toPlay();
+        BoardBitset moves;
+        board.legalMoves(color, moves, true);
+        int count = moves.count();
+        int p = GoBoard::PASS_MOVE;
+        ChessPiece move(-1, -1, color);
+        if (count > 0 && rng.below(40) != 0) {
+            int n = moves.nth(static_cast<int>(rng.below(static_cast<uint32_t>(count))));
+            move.row = n / game.size;
+            move.col = n % game.size;
+            p = board.point(move.row, move.col);
+        }
+        board.play(p, color);
+        game.moves.push_back(move);
+    }
+    if (index % 50 == 7) {
+        // 末尾补一手下在已有子的点上：非法，整盘应被跳过
+        for (const ChessPiece& move : game.moves) {
+            if (move.row >= 0 && board.at(move.row, move.col) != PieceColor::Empty) {
+                game.moves.push_back(ChessPiece(move.row, move.col, board.toPlay()));
+                break;
+            }
+        }
+    }
+
+    if (rng.below(4) == 0) {
+        game.winner = rng.below(2) ? PieceColor::Black : PieceColor::White; // 中盘胜，目数不明
+    } else {
+        int black = 0, white = 0;
+        board.areaScore(black, white);
+        game.score = black - white - game.komi;
+        game.winner = game.score > 0 ? PieceColor::Black : PieceColor::White;
+    }
+    return game;
+}
+
+std::string sgfPoint(const ChessPiece& stone)
+{
+    if (stone.row < 0) return "";
+    return std::string(1, static_cast<char>('a' + stone.col)) + static_cast<char>('a' + stone.row);
+}
+
+std::string toSgf(const GameRecord& game)
+{
+    char head[96];
+    std::snprintf(head, sizeof(head), "(;GM[1]FF[4]SZ[%d]KM[%g]", game.size, game.komi);
+    std::string text = head;
+    if (game.score != 0.0) {
+        char result[32];
+        std::snprintf(result, sizeof(result), "RE[%c+%g]", game.score > 0 ? 'B' : 'W', std::abs(game.score));
+        text += result;
+    } else {
+        text += game.winner == PieceColor::Black ? "RE[B+R]" : "RE[W+R]";
+    }
+    if (!game.setup.empty()) {
+        text += "AB";
+        for (const ChessPiece& stone : game.setup) {
+            text += "[" + sgfPoint(stone) + "]";
+        }
+        text += "PL[W]";
+    }
+    for (const ChessPiece& move : game.moves) {
+        text += move.color == PieceColor::Black ? ";B[" : ";W[";
+        text += sgfPoint(move) + "]";
+    }
+    return text + ")\n";
+}
+
+bool writeText(const std::string& path, const std::string& text)
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool readFile(const std::string& path, std::string& data)
+{
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    data.clear();
+    char buffer[1 << 16];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, n);
+    }
+    std::fclose(file);
+    return true;
+}
+
+std::string shardPath(const std::string& prefix, int shard)
+{
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "-%05d.gotd", shard);
+    return prefix + suffix;
+}
+
+void removeShards(const std::string& prefix, int shards)
+{
+    for (int i = 0; i < shards; ++i) {
+        std::remove(shardPath(prefix, i).c_str());
+    }
+}
+
+// 导出一次，返回分片数，失败时返回-1
+int exportGames(const std::vector<std::string>& inputs, const std::string& prefix, int threads, int queuedGames,
+                int queuedBatches, TrainingExporter::Symmetry symmetry, long long recordsPerShard)
+{
+    TrainingExporter::Options options;
+    options.outputPrefix = prefix;
+    options.threads = threads;
+    options.queuedGames = queuedGames;
+    options.queuedBatches = queuedBatches;
+    options.symmetry = symmetry;
+    options.recordsPerShard = recordsPerShard;
+    TrainingExporter exporter(options);
+    std::string error;
+    if (!exporter.run(inputs, &error)) {
+        std::printf("%s: export failed: %s\n", prefix.c_str(), error.c_str());
+        return -1;
+    }
+    return exporter.stats().shards;
+}
+
+bool sameShards(const std::string& a, const std::string& b, int shards)
+{
+    std::string x, y;
+    for (int i = 0; i < shards; ++i) {
+        if (!readFile(shardPath(a, i), x) || !readFile(shardPath(b, i), y) || x != y) {
+            std::printf("%s and %s differ in shard %d\n", a.c_str(), b.c_str(), i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool loadRecords(const std::string& prefix, int shards, std::vector<TrainingRecord>& records)
+{
+    records.clear();
+    std::string data;
+    for (int i = 0; i < shards; ++i) {
+        if (!readFile(shardPath(prefix, i), data) || data.size() < sizeof(TrainingShardHeader)) return false;
+        TrainingShardHeader header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, "GOTD", 4) || header.recordSize != sizeof(TrainingRecord)
+            || data.size() != sizeof(header) + header.count * sizeof(TrainingRecord)) {
+            return false;
+        }
+        size_t start = records.size();
+        records.resize(start + header.count);
+        std::memcpy(records.data() + start, data.data() + sizeof(header), header.count * sizeof(TrainingRecord));
+    }
+    return true;
+}
+
+bool bit(const TrainingRecord& record, int plane, int index)
+{
+    return (record.planes[plane][index >> 6] >> (index & 63)) & 1;
+}
+
+// 不变换的样本按输入顺序逐手与GoBoard重放比对：己方、对方棋子平面，着法和胜负
+bool checkReplay(const std::vector<GameRecord>& games, const std::vector<TrainingRecord>& records, int& skipped)
+{
+    size_t k = 0;
+    skipped = 0;
+    for (uint32_t g = 0; g < games.size(); ++g) {
+        const GameRecord& game = games[g];
+        std::vector<TrainingRecord> expected;
+        if (!TrainingExporter::replay(game, g, TrainingExporter::Symmetry::None, 0, expected)) {
+            skipped++;
+            continue;
+        }
+        GoBoard board(game.size);
+        if (!game.setup.empty()) {
+            std::vector<int> black;
+            for (const ChessPiece& stone : game.setup) {
+                black.push_back(board.point(stone.row, stone.col));
+            }
+            board.setup(black, {}, game.toPlay);
+        }
+        int size = game.size;
+        for (size_t ply = 0; ply < game.moves.size(); ++ply, ++k) {
+            const ChessPiece& move = game.moves[ply];
+            if (k >= records.size() || records[k].game != g || records[k].ply != ply) {
+                std::printf("replay: record %zu is not game %u ply %zu\n", k, g, ply);
+                return false;
+            }
+            const TrainingRecord& record = records[k];
+            for (int index = 0; index < size * size; ++index) {
+                PieceColor c = board.at(index / size, index % size);
+                bool own = c == board.toPlay();
+                bool opponent = c != PieceColor::Empty && !own;
+                if (bit(record, 0, index) != own || bit(record, 1, index) != opponent) {
+                    std::printf("replay: stones differ in game %u ply %zu\n", g, ply);
+                    return false;
+                }
+            }
+            int target = move.row < 0 ? size * size : move.row * size + move.col;
+            int value = game.winner == PieceColor::Empty ? 0 : (game.winner == move.color ? 1 : -1);
+            if (record.move != target || record.value != value || record.size != size) {
+                std::printf("replay: targets differ in game %u ply %zu\n", g, ply);
+                return false;
+            }
+            board.play(move.row < 0 ? GoBoard::PASS_MOVE : board.point(move.row, move.col), move.color);
+        }
+    }
+    if (k != records.size()) {
+        std::printf("replay: %zu extra records\n", records.size() - k);
+        return false;
+    }
+    return true;
+}
+
+// 八种对称连续出现，都由第0种按transform变换而来
+bool checkSymmetry(const std::vector<TrainingRecord>& records)
+{
+    if (records.size() % 8 != 0) return false;
+    for (size_t i = 0; i < records.size(); i += 8) {
+        const TrainingRecord& base = records[i];
+        int size = base.size;
+        for (int s = 0; s < 8; ++s) {
+            const TrainingRecord& record = records[i + s];
+            bool ok = record.symmetry == s && record.game == base.game && record.ply == base.ply
+                      && record.value == base.value && record.score == base.score;
+            for (int plane = 0; ok && plane < GoNetwork::FEATURE_PLANES; ++plane) {
+                for (int index = 0; ok && index < size * size; ++index) {
+                    int row = index / size;
+                    int col = index % size;
+                    TrainingExporter::transform(s, size, row, col);
+                    ok = bit(base, plane, index) == bit(record, plane, row * size + col);
+                }
+            }
+            int move = base.move;
+            if (ok && move < size * size) {
+                int row = move / size;
+                int col = move % size;
+                TrainingExporter::transform(s, size, row, col);
+                move = row * size + col;
+            }
+            if (!ok || record.move != move) {
+                std::printf("symmetry %d differs in game %u ply %u\n", s, base.game, base.ply);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 2;
+
+    // 输入：每个SGF文件两盘，另打包成一个二进制棋谱
+    FastRng rng(options.seed);
+    std::vector<GameRecord> games;
+    std::vector<std::string> sgfFiles;
+    std::string packPath = options.prefix + "-games.goga";
+    FILE* pack = std::fopen(packPath.c_str(), "wb");
+    bool ok = pack && GameArchive::writeHeader(pack);
+    for (int i = 0; ok && i < options.games; i += 2) {
+        std::string text;
+        for (int j = i; j < i + 2 && j < options.games; ++j) {
+            games.push_back(randomGame(j, rng));
+            text += toSgf(games.back());
+            ok = GameArchive::writeGame(pack, games.back());
+        }
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "-%04d.sgf", i / 2);
+        sgfFiles.push_back(options.prefix + suffix);
+        ok = ok && writeText(sgfFiles.back(), text);
+    }
+    if (pack) ok = std::fclose(pack) == 0 && ok;
+    if (!ok) {
+        std::printf("cannot write input files with prefix %s\n", options.prefix.c_str());
+        return 1;
+    }
+    // SGF读回来应与生成的一致，之后都拿它当准
+    std::vector<GameRecord> parsed;
+    std::string text;
+    for (const std::string& path : sgfFiles) {
+        ok = ok && readFile(path, text) && GameArchive::parseSgf(text, parsed);
+    }
+    if (!ok || parsed.size() != games.size()) {
+        std::printf("sgf: generated games do not parse back\n");
+        return 1;
+    }
+
+    using Symmetry = TrainingExporter::Symmetry;
+    const long long SHARD = 7777; // 不整除每盘记录数，检查跨分片的批
+    std::string reference = options.prefix + "-ref";
+    std::string threaded = options.prefix + "-mt";
+    std::string packed = options.prefix + "-pack";
+    std::string plain = options.prefix + "-none";
+    std::string random1 = options.prefix + "-r1";
+    std::string randomN = options.prefix + "-rn";
+
+    // 单线程、窗口为1是基准；多线程配小队列和大队列各一次，再从二进制棋谱读一次
+    int shards = exportGames(sgfFiles, reference, 1, 1, 1, Symmetry::All, SHARD);
+    int threadedShards = exportGames(sgfFiles, threaded, options.threads, 2, 1, Symmetry::All, SHARD);
+    ok = shards > 0 && threadedShards == shards && sameShards(reference, threaded, shards);
+    threadedShards = exportGames(sgfFiles, threaded, options.threads, 256, 64, Symmetry::All, SHARD);
+    ok = ok && threadedShards == shards && sameShards(reference, threaded, shards);
+    int packedShards = exportGames({packPath}, packed, options.threads, 16, 8, Symmetry::All, SHARD);
+    ok = ok && packedShards == shards && sameShards(reference, packed, shards);
+    std::printf("all symmetries: %d shards, 1 thread vs %d threads vs binary input: %s\n", shards, options.threads,
+                ok ? "identical" : "DIFFERENT");
+
+    std::vector<TrainingRecord> records;
+    bool symmetryOk = ok && loadRecords(reference, shards, records) && checkSymmetry(records);
+    std::printf("symmetry: %zu records in %zu groups: %s\n", records.size(), records.size() / 8,
+                symmetryOk ? "ok" : "FAILED");
+
+    int random1Shards = exportGames(sgfFiles, random1, 1, 4, 1, Symmetry::Random, SHARD);
+    int randomNShards = exportGames({packPath}, randomN, options.threads, 4, 3, Symmetry::Random, SHARD);
+    bool randomOk = random1Shards > 0 && randomNShards == random1Shards
+                    && sameShards(random1, randomN, random1Shards);
+    std::printf("random symmetry: 1 thread vs %d threads: %s\n", options.threads, randomOk ? "identical" : "DIFFERENT");
+
+    int plainShards = exportGames(sgfFiles, plain, options.threads, 8, 4, Symmetry::None, 1LL << 30);
+    int skipped = 0;
+    bool replayOk = plainShards == 1 && loadRecords(plain, plainShards, records)
+                    && checkReplay(parsed, records, skipped);
+    std::printf("replay: %zu games (%d skipped), %zu positions in input order: %s\n", parsed.size(), skipped,
+                records.size(), replayOk ? "ok" : "FAILED");
+
+    ok = ok && symmetryOk && randomOk && replayOk && skipped > 0;
+    if (!options.keep) {
+        removeShards(reference, shards);
+        removeShards(threaded, shards);
+        removeShards(packed, shards);
+        removeShards(random1, random1Shards);
+        removeShards(randomN, randomNShards);
+        removeShards(plain, plainShards);
+        for (const std::string& path : sgfFiles) {
+            std::remove(path.c_str());
+        }
+        std::remove(packPath.c_str());
+    }
+    std::printf("%s\n", ok ? "all consistent" : "FAILED");
+    return ok ? 0 : 1;
+}